@@ -7,6 +7,8 @@
  */
 
 #include "Matrix2d.hpp"
+#include "../common/Stats.hpp"
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -15,8 +17,12 @@ using namespace std;
  * @default constructor
  */
 Matrix2d::Matrix2d() {
-    vector<float> initialValues = {0,0,0,0,0,0,0,0,0};
-    initializeValues(initialValues);
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            this->matrix[row][col] = 0.0f;
+        }
+    }
+    this->classify();
 }
 
 /**
@@ -36,10 +42,25 @@ Matrix2d::Matrix2d( vector<float> initialValues) {
     initializeValues(initialValues);
 }
 
+/**
+ * Constructor of an affine matrix, whose last row is always 0 0 1
+ * @param a {float}, b {float}, c {float} - the first row
+ * @param d {float}, e {float}, f {float} - the second row
+ */
+Matrix2d::Matrix2d(float a, float b, float c, float d, float e, float f) {
+    this->matrix[0][0] = a;
+    this->matrix[0][1] = b;
+    this->matrix[0][2] = c;
+    this->matrix[1][0] = d;
+    this->matrix[1][1] = e;
+    this->matrix[1][2] = f;
+    this->matrix[2][0] = 0.0f;
+    this->matrix[2][1] = 0.0f;
+    this->matrix[2][2] = 1.0f;
+    this->classify();
+}
+
 void Matrix2d::initializeValues( vector<float> initialValues){
-    vector<vector<float>> v(3, vector<float>(3));
-    
-    this->matrix = v;
     int initialValuesIndex = 0;
     
     for (int row = 0; row < 3; row++) {
@@ -47,10 +68,17 @@ void Matrix2d::initializeValues( vector<float> initialValues){
             this->matrix[row][col] = initialValues[initialValuesIndex];
         }
     }
+    this->classify();
 }
 
 vector< vector<float> > Matrix2d::getMatrix2d() const {
-    return this->matrix;
+    vector< vector<float> > values(3, vector<float>(3));
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            values[row][col] = this->matrix[row][col];
+        }
+    }
+    return values;
 }
 
 /**
@@ -65,13 +93,27 @@ float Matrix2d::getElement(int row, int col) const {
  */
 void Matrix2d::setElement(int row, int col, float newValue) {
     this->matrix[row][col] = newValue;
+    this->classify();
+}
+
+/**
+ * Getter for the kind of the matrix
+ * @return {MatrixKind}
+ */
+MatrixKind Matrix2d::getKind() const {
+    return this->kind;
 }
 
 /**
  * Setter for the entire Matrix2d
  */
 void Matrix2d::setMatrix2d( vector< vector<float> > newValues ) {
-    this->matrix = newValues;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            this->matrix[row][col] = newValues[row][col];
+        }
+    }
+    this->classify();
 }
 
 /**
@@ -98,6 +140,7 @@ Matrix2d Matrix2d::operator+(const Matrix2d& secondMatrix) {
             outputMatrix.matrix[i][j] = this->matrix[i][j] + secondMatrix.matrix[i][j];
         }
     }
+    outputMatrix.classify();
     return outputMatrix;
 }
 
@@ -113,44 +156,42 @@ Matrix2d Matrix2d::operator-(const Matrix2d& secondMatrix) {
             outputMatrix.matrix[i][j] = this->matrix[i][j] - secondMatrix.matrix[i][j];
         }
     }
+    outputMatrix.classify();
     return outputMatrix;
 }
 
 /**
- * Overload handler for the times operator
+ * Overload handler for the times operator. The product is computed by the
+ * kernel of the most general kind of the two matrices, which is also the
+ * kind of the result.
  * @param other {Matrix2d&}
  * @return {Matrix2d}
  */
 Matrix2d Matrix2d::operator*(const Matrix2d& other) {
-    // TODO: get these values instead of putting them hardcoded
-    int lhsOperandRows = (int) other.getMatrix2d().size() - 1;
-    int lhsOperandColumns = (int) other.getMatrix2d()[0].size() - 1;
-    int outoutRowsCounter = lhsOperandRows;
-    
-    int rhsOperandColumns = 2;
-    int rhsOperandRows = 2;
-    int outputColumnsCounter = rhsOperandColumns;
-    
-    if (rhsOperandRows != lhsOperandColumns) {
-        throw invalid_argument("The number of columns must match the number of rows of the left hand operator");
-    }
-    
+    CG_STATS_ADD(MATRIX_MULTIPLIES, 1);
     Matrix2d outputMatrix;
-    float sum = 0.0f;
+    MatrixKind kind = max(this->kind, other.kind);
     
-    for (int k = outoutRowsCounter; k>=0; k--) {
-        for (int i = lhsOperandRows; i >= 0; i--) {
-            for (int j = rhsOperandColumns; j >= 0; j--) {
-                sum += this->getMatrix2d()[outoutRowsCounter][j] * other.getMatrix2d()[j][i];
-            }
-            outputMatrix.matrix[outoutRowsCounter][outputColumnsCounter] = sum;
-            sum = 0.0f;
-            outputColumnsCounter--;
-            if (outputColumnsCounter < 0 ) {
-                outputColumnsCounter = rhsOperandColumns;
-                outoutRowsCounter--;
-            }
-        }
+    switch (kind) {
+        case MATRIX_IDENTITY:
+            this->multiply<MATRIX_IDENTITY>(other, outputMatrix);
+            break;
+        case MATRIX_TRANSLATION:
+            this->multiply<MATRIX_TRANSLATION>(other, outputMatrix);
+            break;
+        case MATRIX_AXIS_SCALE:
+            this->multiply<MATRIX_AXIS_SCALE>(other, outputMatrix);
+            break;
+        case MATRIX_AFFINE:
+            this->multiply<MATRIX_AFFINE>(other, outputMatrix);
+            break;
+        case MATRIX_PROJECTIVE:
+            this->multiply<MATRIX_PROJECTIVE>(other, outputMatrix);
+            break;
+    }
+    outputMatrix.kind = kind;
+    if (kind == MATRIX_PROJECTIVE) {
+        outputMatrix.classify();
     }
     
     return outputMatrix;
@@ -159,49 +200,186 @@ Matrix2d Matrix2d::operator*(const Matrix2d& other) {
 GeometricFigure Matrix2d::operator*(const GeometricFigure& figure) {
     GeometricFigure newFigure;
     
-    for (Vertex2d point : figure.getPoints()) {
+    for (const Vertex2d& point : figure.getPoints()) {
         Vertex2d newPoint = (*this) * point;
         newFigure.addPoint(newPoint);
     }
+    newFigure.setBoundingBox(BoundingBox::ofPoints(newFigure.getPoints()));
     
     return newFigure;
 }
 
 Vertex2d Matrix2d::operator*(const Vertex2d& point) {
-    Vertex2d newPoint;
-    float newValue;
+    CG_STATS_ADD(MATRIX_MULTIPLIES, 1);
+    Vertex2d newPoint(point.getX(), point.getY(), point.getZ());
     
-    for (int row = 0; row < 3; row++) {
-        newValue = 0;
-        
-        for (int col = 0; col < 3; col++) {
-            switch(col) {
-                case 0:
-                    newValue += point.getX() * this->getMatrix2d()[row][col];
-                    break;
-                case 1:
-                    newValue += point.getY() * this->getMatrix2d()[row][col];
-                    break;
-                case 2:
-                    newValue += point.getZ() * this->getMatrix2d()[row][col];
-                    break;
-            }
-        }
-        
-        switch (row) {
-            case 0:
-                newPoint.setX(newValue);
-                break;
-            case 1:
-                newPoint.setY(newValue);
-                break;
-            case 2:
-                newPoint.setZ(newValue);
-                break;
-        }
+    switch (this->kind) {
+        case MATRIX_IDENTITY:
+            break;
+        case MATRIX_TRANSLATION:
+            this->transformVertex<MATRIX_TRANSLATION>(newPoint);
+            break;
+        case MATRIX_AXIS_SCALE:
+            this->transformVertex<MATRIX_AXIS_SCALE>(newPoint);
+            break;
+        case MATRIX_AFFINE:
+            this->transformVertex<MATRIX_AFFINE>(newPoint);
+            break;
+        case MATRIX_PROJECTIVE:
+            this->transformVertex<MATRIX_PROJECTIVE>(newPoint);
+            break;
     }
     
     return newPoint;
 }
 
+/**
+ * Transform many vertices in place, keeping their colors. The kernel is
+ * chosen once for all of them.
+ * @param vertices {Vertex2d*}
+ * @param count {size_t}
+ */
+void Matrix2d::transformVertices(Vertex2d *vertices, size_t count) const {
+    CG_STATS_ADD(MATRIX_MULTIPLIES, count);
+    switch (this->kind) {
+        case MATRIX_IDENTITY:
+            break;
+        case MATRIX_TRANSLATION:
+            this->transformVertices<MATRIX_TRANSLATION>(vertices, count);
+            break;
+        case MATRIX_AXIS_SCALE:
+            this->transformVertices<MATRIX_AXIS_SCALE>(vertices, count);
+            break;
+        case MATRIX_AFFINE:
+            this->transformVertices<MATRIX_AFFINE>(vertices, count);
+            break;
+        case MATRIX_PROJECTIVE:
+            this->transformVertices<MATRIX_PROJECTIVE>(vertices, count);
+            break;
+    }
+}
+
+/**
+ * Find the most specific kind of the matrix from its values
+ */
+void Matrix2d::classify() {
+    const float (&m)[3][3] = this->matrix;
+    if (m[2][0] != 0.0f || m[2][1] != 0.0f || m[2][2] != 1.0f) {
+        this->kind = MATRIX_PROJECTIVE;
+    } else if (m[0][1] != 0.0f || m[1][0] != 0.0f) {
+        this->kind = MATRIX_AFFINE;
+    } else if (m[0][0] != 1.0f || m[1][1] != 1.0f) {
+        this->kind = MATRIX_AXIS_SCALE;
+    } else if (m[0][2] != 0.0f || m[1][2] != 0.0f) {
+        this->kind = MATRIX_TRANSLATION;
+    } else {
+        this->kind = MATRIX_IDENTITY;
+    }
+}
+
+/**
+ * Product kernel for matrices of a given kind, or of a more specific one.
+ * The terms are summed in the same order as the general product, from the
+ * last column, so every kernel gives the same values it would. Kind is a
+ * template argument, so the switch is resolved when the kernel is compiled.
+ * @param other {Matrix2d&}
+ * @param output {Matrix2d&} - its kind is set by the caller
+ */
+template <MatrixKind Kind>
+void Matrix2d::multiply(const Matrix2d& other, Matrix2d& output) const {
+    const float (&a)[3][3] = this->matrix;
+    const float (&b)[3][3] = other.matrix;
+    float (&c)[3][3] = output.matrix;
+    
+    switch (Kind) {
+        case MATRIX_IDENTITY:
+            output = *this;
+            return;
+        case MATRIX_TRANSLATION:
+            c[0][0] = 1.0f;
+            c[0][1] = 0.0f;
+            c[0][2] = a[0][2] + b[0][2];
+            c[1][0] = 0.0f;
+            c[1][1] = 1.0f;
+            c[1][2] = a[1][2] + b[1][2];
+            break;
+        case MATRIX_AXIS_SCALE:
+            c[0][0] = a[0][0] * b[0][0];
+            c[0][1] = 0.0f;
+            c[0][2] = a[0][2] + a[0][0] * b[0][2];
+            c[1][0] = 0.0f;
+            c[1][1] = a[1][1] * b[1][1];
+            c[1][2] = a[1][2] + a[1][1] * b[1][2];
+            break;
+        case MATRIX_AFFINE:
+            for (int row = 0; row < 2; row++) {
+                c[row][0] = a[row][1] * b[1][0] + a[row][0] * b[0][0];
+                c[row][1] = a[row][1] * b[1][1] + a[row][0] * b[0][1];
+                c[row][2] = a[row][2] + a[row][1] * b[1][2] + a[row][0] * b[0][2];
+            }
+            break;
+        case MATRIX_PROJECTIVE:
+            for (int row = 0; row < 3; row++) {
+                for (int col = 0; col < 3; col++) {
+                    float sum = 0.0f;
+                    for (int k = 2; k >= 0; k--) {
+                        sum += a[row][k] * b[k][col];
+                    }
+                    c[row][col] = sum;
+                }
+            }
+            return;
+    }
+    c[2][0] = 0.0f;
+    c[2][1] = 0.0f;
+    c[2][2] = 1.0f;
+}
+
+/**
+ * Vertex kernel for a matrix of a given kind. Only the projective kernel
+ * reads the z of the vertex: the others take it as 1, as in every vertex the
+ * figures create, and leave it as it is. A translation costs two additions.
+ * @param point {Vertex2d&} - transformed in place
+ */
+template <MatrixKind Kind>
+void Matrix2d::transformVertex(Vertex2d& point) const {
+    const float (&m)[3][3] = this->matrix;
+    float x = point.getX();
+    float y = point.getY();
+    
+    switch (Kind) {
+        case MATRIX_IDENTITY:
+            break;
+        case MATRIX_TRANSLATION:
+            point.setX(x + m[0][2]);
+            point.setY(y + m[1][2]);
+            break;
+        case MATRIX_AXIS_SCALE:
+            point.setX(x * m[0][0] + m[0][2]);
+            point.setY(y * m[1][1] + m[1][2]);
+            break;
+        case MATRIX_AFFINE:
+            point.setX(x * m[0][0] + y * m[0][1] + m[0][2]);
+            point.setY(x * m[1][0] + y * m[1][1] + m[1][2]);
+            break;
+        case MATRIX_PROJECTIVE: {
+            float z = point.getZ();
+            point.setX(x * m[0][0] + y * m[0][1] + z * m[0][2]);
+            point.setY(x * m[1][0] + y * m[1][1] + z * m[1][2]);
+            point.setZ(x * m[2][0] + y * m[2][1] + z * m[2][2]);
+            break;
+        }
+    }
+}
 
+/**
+ * Loop of a vertex kernel over many vertices
+ * @param vertices {Vertex2d*}
+ * @param count {size_t}
+ */
+template <MatrixKind Kind>
+void Matrix2d::transformVertices(Vertex2d *vertices, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        this->transformVertex<Kind>(vertices[i]);
+    }
+}
@@ -8,14 +8,30 @@
 #ifndef Matrix2d_hpp
 #define Matrix2d_hpp
 
+#include <cstddef>
 #include <vector>
 #include "../common/GeometricFigure.hpp"
 
+// The shape of a matrix, from the most specific to the most general. Each
+// kind is also a special case of the ones after it, so the kind of a product
+// is the most general of the kinds of its factors.
+enum MatrixKind {
+    MATRIX_IDENTITY,
+    // Only the last column differs from the identity
+    MATRIX_TRANSLATION,
+    // A scale along the axes, followed by a translation
+    MATRIX_AXIS_SCALE,
+    // Any matrix whose last row is 0 0 1 (rotations, shears, mirrors)
+    MATRIX_AFFINE,
+    MATRIX_PROJECTIVE
+};
+
 class Matrix2d {
 public:
     
     Matrix2d();
     Matrix2d( std::vector<float> );
+    Matrix2d(float, float, float, float, float, float);
     void initializeValues( std::vector<float> );
     Matrix2d identity();
     
@@ -23,6 +39,7 @@ public:
     std::vector< std::vector<float> > getMatrix2d() const;
     float getElement(int, int) const;
     void setElement(int, int, float);
+    MatrixKind getKind() const;
     
     void setMatrix2d( std::vector< std::vector<float> > );
     void printMatrix2d();  // Debug Purpose
@@ -33,10 +50,18 @@ public:
     Matrix2d operator*(const Matrix2d& other);
     GeometricFigure operator*(const GeometricFigure& figure);
     Vertex2d operator*(const Vertex2d& point);
+    void transformVertices(Vertex2d *vertices, std::size_t count) const;
     
 private:
-    // the matrix itself, always 3x3
-    std::vector< std::vector<float > > matrix;
+    void classify();
+    template <MatrixKind Kind> void multiply(const Matrix2d& other, Matrix2d& output) const;
+    template <MatrixKind Kind> void transformVertex(Vertex2d& point) const;
+    template <MatrixKind Kind> void transformVertices(Vertex2d *vertices, std::size_t count) const;
+    
+    // the matrix itself, always 3x3; kept inline, so building one never allocates
+    float matrix[3][3];
+    // Kept up to date by every constructor and setter, see classify()
+    MatrixKind kind;
 };
 
 #endif /* Matrix2d_hpp */
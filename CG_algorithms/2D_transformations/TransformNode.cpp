@@ -0,0 +1,178 @@
+/**
+ * TransformNode.cpp
+ * Node of a hierarchy of transformations, with cached world matrices.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "TransformNode.hpp"
+#include "TransformationMatrix.hpp"
+#include "../common/Trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Constructor of the class. The node starts with the identity as its local matrix.
+ * @param parent {TransformNode*} - NULL for a root
+ */
+TransformNode::TransformNode(TransformNode *parent):parent(NULL), dirty(true) {
+    this->resetLocalMatrix();
+    this->setParent(parent);
+}
+
+/**
+ * Destructor. The node leaves its parent, and its children become roots.
+ */
+TransformNode::~TransformNode() {
+    this->setParent(NULL);
+    for (TransformNode *child : this->children) {
+        child->parent = NULL;
+        child->markDirty();
+    }
+}
+
+/**
+ * Move the node, and the subtree below it, under another parent
+ * @param newParent {TransformNode*} - NULL to make the node a root
+ */
+void TransformNode::setParent(TransformNode *newParent) {
+    if (newParent == this->parent) {
+        return;
+    }
+    for (TransformNode *ancestor = newParent; ancestor; ancestor = ancestor->parent) {
+        if (ancestor == this) {
+            throw invalid_argument("A node can not be moved under its own subtree");
+        }
+    }
+    
+    if (this->parent) {
+        vector<TransformNode*>& siblings = this->parent->children;
+        siblings.erase(find(siblings.begin(), siblings.end(), this));
+    }
+    this->parent = newParent;
+    if (newParent) {
+        newParent->children.push_back(this);
+    }
+    this->markDirty();
+}
+
+/**
+ * Getter for the parent
+ * @return {TransformNode*} - NULL for a root
+ */
+TransformNode* TransformNode::getParent() const {
+    return this->parent;
+}
+
+/**
+ * Getter for the children
+ * @return {const vector<TransformNode*>&}
+ */
+const vector<TransformNode*>& TransformNode::getChildren() const {
+    return this->children;
+}
+
+/**
+ * Setter for the local matrix, relative to the parent
+ * @param matrix {Matrix2d}
+ */
+void TransformNode::setLocalMatrix(const Matrix2d& matrix) {
+    this->localMatrix = matrix;
+    this->markDirty();
+}
+
+/**
+ * Getter for the local matrix
+ * @return {const Matrix2d&}
+ */
+const Matrix2d& TransformNode::getLocalMatrix() const {
+    return this->localMatrix;
+}
+
+/**
+ * Set the local matrix back to the identity, usually to build it again for a new frame
+ */
+void TransformNode::resetLocalMatrix() {
+    this->setLocalMatrix(Matrix2d(1, 0, 0,
+                                  0, 1, 0));
+}
+
+/**
+ * Apply a translation after the local matrix
+ * @param dx {float}, dy {float}
+ */
+void TransformNode::translate(float dx, float dy) {
+    this->setLocalMatrix(TransformationMatrix::getInstance()->getTranslationMatrix(dx, dy) * this->localMatrix);
+}
+
+/**
+ * Apply a rotation after the local matrix
+ * @param angle {float} - in degrees (CounterClockWise)
+ * @param xPivot {float}, yPivot {float}
+ */
+void TransformNode::rotate(float angle, float xPivot, float yPivot) {
+    this->setLocalMatrix(TransformationMatrix::getInstance()->getRotationMatrix(angle, xPivot, yPivot) * this->localMatrix);
+}
+
+/**
+ * Apply a scale after the local matrix
+ * @param xFactor {float}, yFactor {float}
+ * @param xPivot {float}, yPivot {float}
+ */
+void TransformNode::scale(float xFactor, float yFactor, float xPivot, float yPivot) {
+    this->setLocalMatrix(TransformationMatrix::getInstance()->getScaleMatrix(xFactor, yFactor, xPivot, yPivot) * this->localMatrix);
+}
+
+/**
+ * Getter for the world matrix, composed again only when the node is dirty.
+ * The ancestors that are dirty are composed on the way.
+ * @return {const Matrix2d&}
+ */
+const Matrix2d& TransformNode::getWorldMatrix() {
+    if (this->dirty) {
+        if (this->parent) {
+            Matrix2d parentMatrix = this->parent->getWorldMatrix();
+            this->worldMatrix = parentMatrix * this->localMatrix;
+        } else {
+            this->worldMatrix = this->localMatrix;
+        }
+        this->dirty = false;
+    }
+    return this->worldMatrix;
+}
+
+/**
+ * Whether the world matrix must be composed again
+ * @return {bool}
+ */
+bool TransformNode::isDirty() const {
+    return this->dirty;
+}
+
+/**
+ * Transform vertices by the world matrix, keeping their colors. The given
+ * vertices are not changed.
+ * @param vertices {VertexSpan}
+ * @param output {VertexBuffer&} - replaced by the transformed vertices
+ */
+void TransformNode::transform(VertexSpan vertices, VertexBuffer& output) {
+    CG_TRACE_SPAN("transform", NO_FIGURE, vertices.size());
+    output.assign(vertices.begin(), vertices.end());
+    this->getWorldMatrix().transformVertices(output.data(), output.size());
+}
+
+/**
+ * Mark the node and its subtree as dirty. A subtree that is already dirty is
+ * not walked again.
+ */
+void TransformNode::markDirty() {
+    if (this->dirty) {
+        return;
+    }
+    this->dirty = true;
+    for (TransformNode *child : this->children) {
+        child->markDirty();
+    }
+}
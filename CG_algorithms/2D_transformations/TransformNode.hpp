@@ -0,0 +1,52 @@
+/**
+ * TransformNode.hpp
+ * Node of a hierarchy of transformations. Each node holds a local matrix,
+ * relative to its parent, and caches its world matrix: the product of the
+ * local matrices from the root down to it. Changing a local matrix only
+ * marks the subtree below it as dirty, and a world matrix is composed again
+ * the next time it is asked for. The vertices of the figures are never
+ * changed: they are transformed by the world matrix of their node when they
+ * are drawn, so a whole group moves with a single matrix update and the
+ * geometry does not drift after many steps.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef TransformNode_hpp
+#define TransformNode_hpp
+
+#include <vector>
+#include "Matrix2d.hpp"
+#include "../common/VertexSpan.hpp"
+
+class TransformNode {
+public:
+    TransformNode(TransformNode *parent = NULL);
+    ~TransformNode();
+    void setParent(TransformNode *parent);
+    TransformNode* getParent() const;
+    const std::vector<TransformNode*>& getChildren() const;
+    void setLocalMatrix(const Matrix2d& matrix);
+    const Matrix2d& getLocalMatrix() const;
+    void resetLocalMatrix();
+    void translate(float dx, float dy);
+    void rotate(float angle, float xPivot, float yPivot);
+    void scale(float xFactor, float yFactor, float xPivot, float yPivot);
+    const Matrix2d& getWorldMatrix();
+    bool isDirty() const;
+    void transform(VertexSpan vertices, VertexBuffer& output);
+private:
+    TransformNode(const TransformNode&);
+    TransformNode& operator=(const TransformNode&);
+    void markDirty();
+    
+    TransformNode *parent;
+    // Not owned, a node only knows them to tell them when it changes
+    std::vector<TransformNode*> children;
+    Matrix2d localMatrix;
+    Matrix2d worldMatrix;
+    // When a node is dirty, so is every node below it
+    bool dirty;
+};
+
+#endif /* TransformNode_hpp */
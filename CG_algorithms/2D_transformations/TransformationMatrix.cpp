@@ -22,39 +22,58 @@ TransformationMatrix* TransformationMatrix::getInstance() {
     return instance;
 }
 
+/**
+ * Constructor of the class. Fills the table of cosines and sines, since the
+ * figures are mostly rotated by whole angles.
+ */
+TransformationMatrix::TransformationMatrix() {
+    for (int angle = 0; angle < 360; angle++) {
+        this->cosines[angle] = cos(angle*PI/180);
+        this->sines[angle] = sin(angle*PI/180);
+    }
+}
+
+/**
+ * Cosine and sine of an angle, from the table when it is a whole angle
+ * @param angle {float} - in degrees
+ * @param cosine {float&}, sine {float&} - where the results go
+ */
+void TransformationMatrix::getCosineAndSine(float angle, float& cosine, float& sine) const {
+    if (angle == floorf(angle) && fabsf(angle) < 1e6f) {
+        int index = (int) angle % 360;
+        if (index < 0) {
+            index += 360;
+        }
+        cosine = this->cosines[index];
+        sine = this->sines[index];
+        return;
+    }
+    cosine = cos(angle*PI/180);
+    sine = sin(angle*PI/180);
+}
+
 /**
  * Translate using dx, dy
  * @param dx {float}, dy {float}
  * @return {Matrix2d}
  */
 Matrix2d TransformationMatrix::getTranslationMatrix(float dx, float dy) {
-    vector<float> translateVector = {1,  0,  dx,
-                                     0,  1,  dy,
-                                     0,  0,  1};
-    Matrix2d outputMatrix( translateVector );
-    return outputMatrix;
+    return Matrix2d(1, 0, dx,
+                    0, 1, dy);
 }
 
 /**
- * Rotatation Matrix2d using a CounterClockWise angle around a pivot coordinate
+ * Rotatation Matrix2d using a CounterClockWise angle around a pivot coordinate.
+ * Built directly as translate(pivot) * rotate * translate(-pivot), without the products.
  * @param rotationAngle {float} - in degrees (CounterClockWise), xPivot {float}, yPivot {float}
  * @return {Matrix2d}
  */
 Matrix2d TransformationMatrix::getRotationMatrix(float rotationAngle, float xPivot, float yPivot) {
+    float cosine, sine;
+    this->getCosineAndSine(rotationAngle, cosine, sine);
     
-    float cosine = cos(rotationAngle*PI/180);
-    float sine = sin(rotationAngle*PI/180);
-    
-    vector<float> rotateVector = {cosine, -sine ,  0,
-                                  sine,    cosine, 0,
-                                  0,       0,      1};
-    
-    Matrix2d translateToOriginMatrix = getTranslationMatrix(-xPivot, -yPivot);
-    Matrix2d rotateMatrix(rotateVector);
-    Matrix2d translateFromOriginMatrix = getTranslationMatrix(xPivot, yPivot);
-    Matrix2d outputMatrix = translateFromOriginMatrix * rotateMatrix * translateToOriginMatrix;
-    
-    return outputMatrix;
+    return Matrix2d(cosine, -sine,   xPivot - cosine * xPivot + sine * yPivot,
+                    sine,    cosine, yPivot - sine * xPivot - cosine * yPivot);
 }
 
 /**
@@ -63,16 +82,8 @@ Matrix2d TransformationMatrix::getRotationMatrix(float rotationAngle, float xPiv
  * @return {Matrix2d}
  */
 Matrix2d TransformationMatrix::getScaleMatrix(float xScaleFactor, float yScaleFactor, float x, float y) {
-    vector<float> scaleVector = {xScaleFactor, 0,            0,
-                                 0,            yScaleFactor, 0,
-                                 0,            0,            1};
-    
-    Matrix2d translateToOriginMatrix = getTranslationMatrix(-x, -y);
-    Matrix2d rotateMatrix(scaleVector);
-    Matrix2d translateFromOriginMatrix = getTranslationMatrix(x, y);
-    Matrix2d outputMatrix = translateFromOriginMatrix * scaleVector * translateToOriginMatrix;
-    
-    return outputMatrix;
+    return Matrix2d(xScaleFactor, 0,            x - xScaleFactor * x,
+                    0,            yScaleFactor, y - yScaleFactor * y);
 }
 
 /**
@@ -81,15 +92,6 @@ Matrix2d TransformationMatrix::getScaleMatrix(float xScaleFactor, float yScaleFa
  * @return {Matrix2d}
  */
 Matrix2d TransformationMatrix::getShearMatrix(float xShearFactor, float yShearFactor, float x, float y) {
-    
-    vector<float> shearVector = {1,            xShearFactor, 0,
-                                 yShearFactor, 1,            0,
-                                 0,            0,            1};
-    
-    Matrix2d translateToOriginMatrix = getTranslationMatrix(-x, -y);
-    Matrix2d rotateMatrix(shearVector);
-    Matrix2d translateFromOriginMatrix = getTranslationMatrix(x, y);
-    Matrix2d outputMatrix = translateFromOriginMatrix * shearVector * translateToOriginMatrix;
-    
-    return outputMatrix;
-}
\ No newline at end of file
+    return Matrix2d(1,            xShearFactor, -xShearFactor * y,
+                    yShearFactor, 1,            -yShearFactor * x);
+}
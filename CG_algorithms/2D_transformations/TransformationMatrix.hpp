@@ -31,7 +31,12 @@ public:
     
 private:
     static TransformationMatrix* instance;
-    TransformationMatrix() {};
+    TransformationMatrix();
+    void getCosineAndSine(float angle, float& cosine, float& sine) const;
+    
+    // Cosine and sine of every whole angle from 0 to 359 degrees
+    float cosines[360];
+    float sines[360];
 };
 
 #endif /* TransformationMatrix_hpp */
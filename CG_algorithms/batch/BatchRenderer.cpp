@@ -0,0 +1,468 @@
+/**
+ * BatchRenderer.cpp
+ * Headless renderer of scene files, on every core.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "BatchRenderer.hpp"
+#include "../common/Pipeline.hpp"
+#include "../common/Framebuffer.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/FrameArena.hpp"
+#include "../common/Trace.hpp"
+#include "../2D_transformations/TransformationMatrix.hpp"
+#include "../lines/Line.hpp"
+#include "../lines/Circumference.hpp"
+#include "../polygons/Polygon.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <cstdlib>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/**
+ * Whether a path is a directory
+ * @param path {string}
+ * @return {bool}
+ */
+static bool isDirectory(const string& path) {
+    struct stat status;
+    return stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+/**
+ * Whether a path ends with an extension
+ * @param path {string}
+ * @param extension {string}
+ * @return {bool}
+ */
+static bool hasExtension(const string& path, const string& extension) {
+    return path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+ * Whether a scene file is in the binary format (see common/BinaryScene.hpp)
+ * @param path {string}
+ * @return {bool}
+ */
+static bool isBinaryScene(const string& path) {
+    return hasExtension(path, ".cgscene");
+}
+
+/**
+ * Constructor of the class
+ * @param outputDirectory {string} - where the images go, created if needed
+ * @param format {string} - "ppm" or "png"
+ * @param threads {int} - number of workers, 0 for one per core
+ */
+BatchRenderer::BatchRenderer(const string& outputDirectory, const string& format, int threads):
+    outputDirectory(outputDirectory), format(format), threads(threads),
+    nextScene(0), pixels(0), failures(0), report(NULL) {
+    if (format != "ppm" && format != "png") {
+        throw invalid_argument("The image format must be ppm or png, not " + format);
+    }
+    if (threads < 0) {
+        throw invalid_argument("The number of threads can not be negative");
+    }
+    if (this->threads == 0) {
+        this->threads = max(1, (int) thread::hardware_concurrency());
+    }
+}
+
+/**
+ * Add a scene file to render
+ * @param path {string}
+ */
+void BatchRenderer::addScene(const string& path) {
+    this->scenePaths.push_back(path);
+}
+
+/**
+ * Add every scene file of a directory, text (.scene) or binary (.cgscene),
+ * in the order of their names
+ * @param path {string}
+ */
+void BatchRenderer::addDirectory(const string& path) {
+    DIR *directory = opendir(path.c_str());
+    if (!directory) {
+        throw invalid_argument("Could not read the directory " + path);
+    }
+    
+    vector<string> names;
+    while (dirent *entry = readdir(directory)) {
+        string name = entry->d_name;
+        if (hasExtension(name, ".scene") || isBinaryScene(name)) {
+            names.push_back(name);
+        }
+    }
+    closedir(directory);
+    
+    sort(names.begin(), names.end());
+    for (const string& name : names) {
+        this->addScene(path + "/" + name);
+    }
+}
+
+/**
+ * Number of scenes added
+ * @return {size_t}
+ */
+size_t BatchRenderer::getSceneCount() const {
+    return this->scenePaths.size();
+}
+
+/**
+ * The image of a scene: its name without the directory and the .scene
+ * extension, in the output directory
+ * @param scenePath {string}
+ * @return {string}
+ */
+string BatchRenderer::getImagePath(const string& scenePath) const {
+    size_t slash = scenePath.find_last_of('/');
+    string name = slash == string::npos ? scenePath : scenePath.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != string::npos && dot > 0) {
+        name = name.substr(0, dot);
+    }
+    return this->outputDirectory + "/" + name + "." + this->format;
+}
+
+/**
+ * Sink that draws into a framebuffer and counts the pixels
+ */
+class CountingFramebufferSink {
+public:
+    CountingFramebufferSink(Framebuffer& framebuffer):sink(framebuffer), count(0) {}
+    
+    void plot(int x, int y, const Vertex2d& color) {
+        this->sink.plot(x, y, color);
+        this->count++;
+    }
+    
+    void span(int xStart, int xEnd, int y, const Vertex2d& color) {
+        this->sink.span(xStart, xEnd, y, color);
+        this->count += xEnd - xStart + 1;
+    }
+    
+    unsigned long getCount() const {
+        return this->count;
+    }
+private:
+    FramebufferPixelSink sink;
+    unsigned long count;
+};
+
+/**
+ * What a worker needs to draw the figures of a scene
+ */
+struct SceneCanvas {
+    SceneCanvas(int width, int height, const Vertex2d& background, const Vertex2d& windowBottomLeft, const Vertex2d& windowTopRight):
+        pipeline(windowBottomLeft, windowTopRight), framebuffer(width, height), sink(framebuffer),
+        windowBottomLeft(windowBottomLeft), windowTopRight(windowTopRight) {
+        this->framebuffer.clear(background.getRed(), background.getGreen(), background.getBlue());
+    }
+    
+    Pipeline pipeline;
+    Framebuffer framebuffer;
+    CountingFramebufferSink sink;
+    Vertex2d windowBottomLeft;
+    Vertex2d windowTopRight;
+    FrameArena arena;
+    // Reused from figure to figure, so its points keep their memory
+    PipelineFigure figure;
+};
+
+/**
+ * Draw a figure of a scene, over the ones before. A figure that is not
+ * transformed and is entirely inside the window is rasterized straight from
+ * its vertices, wherever they are (e.g. a mapped file); the others go through
+ * transform, clip and raster (Pipeline::process).
+ * @param canvas {SceneCanvas&}
+ * @param type {GeometricFigureType}
+ * @param vertices {VertexSpan}
+ * @param radius {int} - of a circumference
+ * @param filled {bool} - for polygons
+ * @param transformation {const Matrix2d*} - NULL when the figure is not transformed
+ */
+static void drawSceneFigure(SceneCanvas& canvas, GeometricFigureType type, VertexSpan vertices,
+                            int radius, bool filled, const Matrix2d *transformation) {
+    FrameArena::Scope figureScope(canvas.arena);
+    
+    if (!transformation) {
+        bool inside = true;
+        for (const Vertex2d& vertice : vertices) {
+            inside = inside && vertice.getX() - radius >= canvas.windowBottomLeft.getX() &&
+                               vertice.getY() - radius >= canvas.windowBottomLeft.getY() &&
+                               vertice.getX() + radius <= canvas.windowTopRight.getX() &&
+                               vertice.getY() + radius <= canvas.windowTopRight.getY();
+        }
+    
+        if (inside) {
+            CG_TRACE_SPAN("raster", type, (unsigned int) vertices.size());
+            switch (type) {
+                case LINE:
+                    Line::rasterizeLineBresenham(vertices[0], vertices[1], canvas.sink);
+                    break;
+                case POLYGON:
+                    if (filled) {
+                        Polygon::rasterizeFilledPolygon(vertices, canvas.sink);
+                    } else {
+                        Polygon::rasterizeNotFilledPolygon(vertices, canvas.sink);
+                    }
+                    break;
+                case CIRCUMFERENCE:
+                    Circumference::rasterizeCircumferenceBresenham(vertices[0], radius, canvas.sink);
+                    break;
+            }
+            return;
+        }
+    }
+    
+    PipelineFigure& figure = canvas.figure;
+    figure.type = type;
+    figure.vertices.assign(vertices.begin(), vertices.end());
+    figure.radius = radius;
+    figure.filled = filled;
+    figure.hasTransformation = transformation != NULL;
+    if (transformation) {
+        figure.transformation = *transformation;
+    }
+    canvas.pipeline.process(&figure);
+    
+    for (const Vertex2d& point : figure.points) {
+        canvas.sink.plot((int) point.getX(), (int) point.getY(), point);
+    }
+}
+
+/**
+ * Write the framebuffer of a scene as an image
+ * @param canvas {SceneCanvas&}
+ * @param writer {ImageWriter&}
+ */
+static void writeSceneImage(const SceneCanvas& canvas, ImageWriter& writer) {
+    const Framebuffer& framebuffer = canvas.framebuffer;
+    
+    // The image starts with its top row, the last one of the framebuffer
+    writer.begin(framebuffer.getWidth(), framebuffer.getHeight());
+    for (int row = framebuffer.getHeight() - 1; row >= 0; row--) {
+        writer.writeRow(framebuffer.getPixels() + 3 * (size_t) row * framebuffer.getWidth());
+    }
+    writer.finish();
+}
+
+/**
+ * Render a scene read from a text file
+ * @param scene {Scene}
+ * @param writer {ImageWriter&} - the file the image goes to
+ * @return {unsigned long} - the number of pixels rasterized
+ */
+unsigned long BatchRenderer::renderScene(const Scene& scene, ImageWriter& writer) {
+    CG_TRACE_SPAN("scene", NO_FIGURE, (unsigned int) scene.figures.size());
+    SceneCanvas canvas(scene.width, scene.height, scene.background, scene.windowBottomLeft, scene.windowTopRight);
+    
+    for (const PipelineFigure& figure : scene.figures) {
+        drawSceneFigure(canvas, figure.type, figure.vertices, figure.radius, figure.filled,
+                        figure.hasTransformation ? &figure.transformation : NULL);
+    }
+    
+    writeSceneImage(canvas, writer);
+    return canvas.sink.getCount();
+}
+
+/**
+ * Render a binary scene, reading its vertices from the mapped file
+ * @param scene {MappedScene}
+ * @param writer {ImageWriter&} - the file the image goes to
+ * @return {unsigned long} - the number of pixels rasterized
+ */
+unsigned long BatchRenderer::renderScene(const MappedScene& scene, ImageWriter& writer) {
+    CG_TRACE_SPAN("scene", NO_FIGURE, (unsigned int) scene.getFigureCount());
+    SceneCanvas canvas(scene.getWidth(), scene.getHeight(), scene.getBackground(),
+                       scene.getWindowBottomLeft(), scene.getWindowTopRight());
+    
+    for (size_t i = 0; i < scene.getFigureCount(); i++) {
+        const BinarySceneFigure& figure = scene.getFigure(i);
+        VertexSpan vertices = scene.getVertices(i);
+        bool filled = (figure.flags & BINARY_SCENE_FILLED) != 0;
+    
+        if (figure.flags & BINARY_SCENE_TRANSFORMED) {
+            Matrix2d transformation = scene.getTransformation(i);
+            drawSceneFigure(canvas, (GeometricFigureType) figure.type, vertices, figure.radius, filled, &transformation);
+        } else {
+            drawSceneFigure(canvas, (GeometricFigureType) figure.type, vertices, figure.radius, filled, NULL);
+        }
+    }
+    
+    writeSceneImage(canvas, writer);
+    return canvas.sink.getCount();
+}
+
+/**
+ * Body of each worker: take the next scene until there are none left
+ */
+void BatchRenderer::runWorker() {
+    for (;;) {
+        size_t index = this->nextScene.fetch_add(1);
+        if (index >= this->scenePaths.size()) {
+            return;
+        }
+    
+        const string& scenePath = this->scenePaths[index];
+        string imagePath = this->getImagePath(scenePath);
+        try {
+            ofstream file(imagePath.c_str(), ios::binary);
+            if (!file) {
+                throw invalid_argument("Could not write the image " + imagePath);
+            }
+            unique_ptr<ImageWriter> writer(createImageWriter(imagePath, file));
+            if (isBinaryScene(scenePath)) {
+                MappedScene scene(scenePath);
+                this->pixels += BatchRenderer::renderScene(scene, *writer);
+            } else {
+                Scene scene = SceneFile::read(scenePath);
+                this->pixels += BatchRenderer::renderScene(scene, *writer);
+            }
+        } catch (const exception& error) {
+            this->failures++;
+            lock_guard<mutex> lock(this->reportMutex);
+            *this->report << error.what() << endl;
+        }
+    }
+}
+
+/**
+ * Render every scene added, on the worker threads
+ * @param report {ostream&} - where the failures and the throughput are written
+ * @return {int} - the number of scenes that failed
+ */
+int BatchRenderer::run(ostream& report) {
+    if (!isDirectory(this->outputDirectory) && mkdir(this->outputDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw invalid_argument("Could not create the directory " + this->outputDirectory);
+    }
+    
+    // The singleton is created here, before the workers could race to create it
+    TransformationMatrix::getInstance();
+    this->report = &report;
+    this->nextScene.store(0);
+    this->pixels.store(0);
+    this->failures.store(0);
+    int workers = min(this->threads, max(1, (int) this->scenePaths.size()));
+    
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workerThreads;
+    for (int i = 0; i < workers; i++) {
+        workerThreads.push_back(thread(&BatchRenderer::runWorker, this));
+    }
+    for (thread& worker : workerThreads) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    size_t rendered = this->scenePaths.size() - this->failures.load();
+    report << fixed << setprecision(3) << "Rendered " << rendered << " of " << this->scenePaths.size()
+           << " scene(s) on " << workers << " thread(s) in " << seconds << " s: "
+           << setprecision(1) << rendered / seconds << " scenes/s, "
+           << this->pixels.load() / seconds / 1e6 << " Mpixels/s" << endl;
+    return this->failures.load();
+}
+
+/**
+ * Entry point of --render:
+ *
+ *   CG_algorithms --render <scene file or directory> [--output <directory>]
+ *                 [--format ppm|png] [--threads <count>]
+ *
+ * @param argc {int}
+ * @param argv {char**}
+ * @return {int} - 0 when every scene was rendered, 1 when some failed, 2 on bad options
+ */
+int runBatchRender(int argc, char **argv) {
+    vector<string> inputs;
+    string outputDirectory = ".", format = "ppm";
+    int threads = 0;
+    
+    try {
+        for (int i = 1; i < argc; i++) {
+            string option = argv[i];
+            if (i + 1 >= argc) {
+                throw invalid_argument("Missing value for " + option);
+            }
+    
+            string value = argv[++i];
+            if (option == "--render") {
+                inputs.push_back(value);
+            } else if (option == "--output") {
+                outputDirectory = value;
+            } else if (option == "--format") {
+                format = value;
+            } else if (option == "--threads") {
+                threads = atoi(value.c_str());
+            } else {
+                throw invalid_argument("Unknown option " + option);
+            }
+        }
+    
+        BatchRenderer renderer(outputDirectory, format, threads);
+        for (const string& input : inputs) {
+            if (isDirectory(input)) {
+                renderer.addDirectory(input);
+            } else {
+                renderer.addScene(input);
+            }
+        }
+        if (renderer.getSceneCount() == 0) {
+            throw invalid_argument("No scene to render");
+        }
+    
+        return renderer.run(cout) > 0 ? 1 : 0;
+    } catch (const invalid_argument& error) {
+        cerr << error.what() << endl;
+        return 2;
+    }
+}
+
+/**
+ * Entry point of --convert-scene, which writes a text scene in the binary
+ * format and tells how long each one takes to load:
+ *
+ *   CG_algorithms --convert-scene <text scene> <binary scene>
+ *
+ * @param argc {int}
+ * @param argv {char**}
+ * @return {int} - 0 when the scene was converted, 2 otherwise
+ */
+int runSceneConverter(int argc, char **argv) {
+    if (argc != 4) {
+        cerr << "Usage: --convert-scene <text scene> <binary scene>" << endl;
+        return 2;
+    }
+    
+    try {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        Scene scene = SceneFile::read(argv[2]);
+        double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        BinarySceneFile::write(scene, argv[3]);
+    
+        start = chrono::steady_clock::now();
+        MappedScene mapped(argv[3]);
+        double mapSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+        cout << fixed << setprecision(3) << "Converted " << mapped.getFigureCount() << " figure(s): "
+             << "the text scene loads in " << parseSeconds * 1e3 << " ms, "
+             << "the binary one in " << mapSeconds * 1e3 << " ms" << endl;
+    } catch (const invalid_argument& error) {
+        cerr << error.what() << endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * BatchRenderer.hpp
+ * Headless renderer of scene files, text (see common/SceneFile.hpp) or binary
+ * (see common/BinaryScene.hpp). Every figure goes through the transform, clip
+ * and raster code of the Pipeline, unless it needs neither transform nor clip,
+ * and every scene is saved as a PPM or PNG image named after it. The scenes are shared by
+ * worker threads, one scene at a time each, and the run is reported in
+ * scenes/s and pixels/s.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef BatchRenderer_hpp
+#define BatchRenderer_hpp
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../common/SceneFile.hpp"
+#include "../common/BinaryScene.hpp"
+#include "../common/ImageWriter.hpp"
+
+class BatchRenderer {
+public:
+    BatchRenderer(const std::string& outputDirectory, const std::string& format, int threads);
+    void addScene(const std::string& path);
+    void addDirectory(const std::string& path);
+    std::size_t getSceneCount() const;
+    int run(std::ostream& report);
+    static unsigned long renderScene(const Scene& scene, ImageWriter& writer);
+    static unsigned long renderScene(const MappedScene& scene, ImageWriter& writer);
+private:
+    BatchRenderer(const BatchRenderer&);
+    BatchRenderer& operator=(const BatchRenderer&);
+    void runWorker();
+    std::string getImagePath(const std::string& scenePath) const;
+    
+    std::string outputDirectory;
+    std::string format;
+    int threads;
+    std::vector<std::string> scenePaths;
+    // Shared by the workers while they run
+    std::atomic<std::size_t> nextScene;
+    std::atomic<unsigned long> pixels;
+    std::atomic<int> failures;
+    std::mutex reportMutex;
+    std::ostream *report;
+};
+
+int runBatchRender(int argc, char **argv);
+int runSceneConverter(int argc, char **argv);
+
+#endif /* BatchRenderer_hpp */
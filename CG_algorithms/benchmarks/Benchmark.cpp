@@ -0,0 +1,343 @@
+/**
+ * Benchmark.cpp
+ * Headless benchmark runner, with a JSON baseline to catch regressions.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Benchmark.hpp"
+#include "BenchmarkScenes.hpp"
+#include "../common/AllocationCounter.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+// Number of timed samples of each benchmark; the fastest one is reported
+#define SAMPLES 5
+
+// Keeps the compiler from throwing away the work of the benchmarks
+static volatile unsigned long pixelsSink = 0;
+
+static double nowInSeconds() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Constructor of the class
+ * @param name {string} - shown in the report and used as key in the baseline
+ * @param operation {function<unsigned long()>} - returns the pixels produced
+ */
+Benchmark::Benchmark(const string& name, const function<unsigned long()>& operation):name(name), operation(operation) {}
+
+/**
+ * Getter for the name
+ * @return {const string&}
+ */
+const string& Benchmark::getName() const {
+    return this->name;
+}
+
+/**
+ * Time the operation. The number of iterations is grown until a sample takes
+ * at least minSeconds / SAMPLES; then the fastest of SAMPLES samples is kept.
+ * @param minSeconds {double}
+ * @return {BenchmarkResult}
+ */
+BenchmarkResult Benchmark::run(double minSeconds) const {
+    double sampleSeconds = minSeconds / SAMPLES;
+    unsigned long iterations = 1;
+    unsigned long pixels = 0;
+    
+    // Warm up and calibrate
+    while (true) {
+        double start = nowInSeconds();
+        for (unsigned long i = 0; i < iterations; i++) {
+            pixels = this->operation();
+        }
+        double elapsed = nowInSeconds() - start;
+        if (elapsed >= sampleSeconds || iterations >= (1ul << 30)) {
+            break;
+        }
+        iterations *= elapsed > 0 ? min(10.0, max(2.0, 1.5 * sampleSeconds / elapsed)) : 10;
+    }
+    
+    double bestSeconds = 0;
+    unsigned long allocations = 0;
+    for (int sample = 0; sample < SAMPLES; sample++) {
+        unsigned long allocationsBefore = AllocationCounter::getAllocations();
+        double start = nowInSeconds();
+        for (unsigned long i = 0; i < iterations; i++) {
+            pixelsSink += this->operation();
+        }
+        double elapsed = nowInSeconds() - start;
+        allocations = AllocationCounter::getAllocations() - allocationsBefore;
+        if (sample == 0 || elapsed < bestSeconds) {
+            bestSeconds = elapsed;
+        }
+    }
+    
+    BenchmarkResult result;
+    result.name = this->name;
+    result.nsPerOp = bestSeconds * 1e9 / iterations;
+    result.pixelsPerSecond = bestSeconds > 0 ? pixels * iterations / bestSeconds : 0;
+    result.allocationsPerOp = AllocationCounter::isEnabled() ? double(allocations) / iterations : -1;
+    return result;
+}
+
+/**
+ * Constructor of the class
+ */
+BenchmarkSuite::BenchmarkSuite():minSeconds(0.5) {}
+
+/**
+ * Add a benchmark to the suite
+ * @param name {string}
+ * @param operation {function<unsigned long()>} - returns the pixels produced
+ */
+void BenchmarkSuite::add(const string& name, const function<unsigned long()>& operation) {
+    this->benchmarks.push_back(Benchmark(name, operation));
+}
+
+/**
+ * Only run the benchmarks whose name contains the filter
+ * @param filter {string}
+ */
+void BenchmarkSuite::setFilter(const string& filter) {
+    this->filter = filter;
+}
+
+/**
+ * Setter for the time spent on each benchmark
+ * @param minSeconds {double}
+ */
+void BenchmarkSuite::setMinSeconds(double minSeconds) {
+    if (minSeconds <= 0) {
+        throw invalid_argument("The time of a benchmark must be positive");
+    }
+    this->minSeconds = minSeconds;
+}
+
+/**
+ * Run the benchmarks, printing a line for each one
+ * @param out {ostream&}
+ * @return {const vector<BenchmarkResult>&}
+ */
+const vector<BenchmarkResult>& BenchmarkSuite::runAll(ostream& out) {
+    this->results.clear();
+    out << left << setw(44) << "benchmark" << right << setw(14) << "ns/op"
+        << setw(16) << "Mpixels/s" << setw(12) << "allocs/op" << endl;
+    
+    for (auto it = this->benchmarks.begin(); it != this->benchmarks.end(); it++) {
+        if (it->getName().find(this->filter) == string::npos) {
+            continue;
+        }
+        
+        BenchmarkResult result = it->run(this->minSeconds);
+        this->results.push_back(result);
+        
+        out << left << setw(44) << result.name << right << fixed << setprecision(1) << setw(14) << result.nsPerOp << setw(16);
+        if (result.pixelsPerSecond > 0) {
+            out << result.pixelsPerSecond / 1e6;
+        } else {
+            out << "-";
+        }
+        out << setw(12);
+        if (result.allocationsPerOp < 0) {
+            out << "n/a";
+        } else {
+            out << result.allocationsPerOp;
+        }
+        out << endl;
+    }
+    return this->results;
+}
+
+/**
+ * Getter for the results of the last run
+ * @return {const vector<BenchmarkResult>&}
+ */
+const vector<BenchmarkResult>& BenchmarkSuite::getResults() const {
+    return this->results;
+}
+
+/**
+ * Write the results of the last run as a JSON baseline
+ * @param path {string}
+ */
+void BenchmarkSuite::writeBaseline(const string& path) const {
+    ofstream file(path.c_str());
+    if (!file) {
+        throw invalid_argument("Could not write the baseline file " + path);
+    }
+    
+    file << "{\n  \"benchmarks\": [\n" << setprecision(10);
+    for (size_t i = 0; i < this->results.size(); i++) {
+        const BenchmarkResult& result = this->results[i];
+        file << "    {\"name\": \"" << result.name << "\", \"nsPerOp\": " << result.nsPerOp
+             << ", \"pixelsPerSecond\": " << result.pixelsPerSecond
+             << ", \"allocationsPerOp\": " << result.allocationsPerOp << "}"
+             << (i + 1 < this->results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+/**
+ * Read the number that follows a key in a JSON object
+ * @param object {string}
+ * @param key {string}
+ * @return {double}
+ */
+static double readNumber(const string& object, const string& key) {
+    size_t position = object.find("\"" + key + "\"");
+    if (position == string::npos) {
+        throw invalid_argument("Missing " + key + " in the baseline");
+    }
+    position = object.find(':', position);
+    return strtod(object.c_str() + position + 1, NULL);
+}
+
+/**
+ * Read a baseline written by writeBaseline. It only understands that format,
+ * one benchmark object per line.
+ * @param path {string}
+ * @return {vector<BenchmarkResult>}
+ */
+vector<BenchmarkResult> BenchmarkSuite::readBaseline(const string& path) {
+    ifstream file(path.c_str());
+    if (!file) {
+        throw invalid_argument("Could not read the baseline file " + path);
+    }
+    
+    vector<BenchmarkResult> baseline;
+    string line;
+    while (getline(file, line)) {
+        size_t nameStart = line.find("\"name\": \"");
+        if (nameStart == string::npos) {
+            continue;
+        }
+        nameStart += strlen("\"name\": \"");
+        
+        BenchmarkResult result;
+        result.name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+        result.nsPerOp = readNumber(line, "nsPerOp");
+        result.pixelsPerSecond = readNumber(line, "pixelsPerSecond");
+        result.allocationsPerOp = readNumber(line, "allocationsPerOp");
+        baseline.push_back(result);
+    }
+    return baseline;
+}
+
+/**
+ * Compare the last run with a baseline. A benchmark regresses when it is
+ * slower than the baseline by more than the threshold, or when it allocates
+ * more (only if both runs counted allocations).
+ * @param baseline {vector<BenchmarkResult>}
+ * @param threshold {double} - allowed slowdown, 0.1 is 10%
+ * @param out {ostream&}
+ * @return {int} - number of regressions
+ */
+int BenchmarkSuite::compareWithBaseline(const vector<BenchmarkResult>& baseline, double threshold, ostream& out) const {
+    int regressions = 0;
+    
+    for (auto it = this->results.begin(); it != this->results.end(); it++) {
+        auto old = find_if(baseline.begin(), baseline.end(), [it](const BenchmarkResult& result) {
+            return result.name == it->name;
+        });
+        if (old == baseline.end()) {
+            out << "new: " << it->name << endl;
+            continue;
+        }
+        
+        double change = it->nsPerOp / old->nsPerOp - 1;
+        bool slower = change > threshold;
+        bool allocatesMore = it->allocationsPerOp >= 0 && old->allocationsPerOp >= 0 &&
+                             it->allocationsPerOp > old->allocationsPerOp + 0.5;
+        
+        if (slower || allocatesMore) {
+            regressions++;
+            out << "REGRESSION: " << it->name << fixed << setprecision(1)
+                << " " << old->nsPerOp << " -> " << it->nsPerOp << " ns/op (" << showpos << change * 100 << noshowpos << "%)";
+            if (allocatesMore) {
+                out << ", " << old->allocationsPerOp << " -> " << it->allocationsPerOp << " allocs/op";
+            }
+            out << endl;
+        }
+    }
+    return regressions;
+}
+
+/**
+ * Entry point of the benchmarks (main.cpp --bench). Options:
+ *   --filter <text>          only run the benchmarks whose name contains the text
+ *   --min-time <seconds>     time spent on each benchmark (default 0.5)
+ *   --write-baseline <path>  save the results as a JSON baseline
+ *   --baseline <path>        compare the results with a JSON baseline
+ *   --threshold <fraction>   allowed slowdown against the baseline (default 0.1)
+ * @param argc {int}
+ * @param argv {char**}
+ * @return {int} - the exit code, 1 when a benchmark regressed
+ */
+int runBenchmarks(int argc, char **argv) {
+    BenchmarkSuite suite;
+    string baselinePath, newBaselinePath;
+    double threshold = 0.1;
+    
+    try {
+        for (int i = 1; i < argc; i++) {
+            string option = argv[i];
+            if (option == "--bench") {
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw invalid_argument("Missing value for " + option);
+            }
+            
+            string value = argv[++i];
+            if (option == "--filter") {
+                suite.setFilter(value);
+            } else if (option == "--min-time") {
+                suite.setMinSeconds(atof(value.c_str()));
+            } else if (option == "--write-baseline") {
+                newBaselinePath = value;
+            } else if (option == "--baseline") {
+                baselinePath = value;
+            } else if (option == "--threshold") {
+                threshold = atof(value.c_str());
+            } else {
+                throw invalid_argument("Unknown option " + option);
+            }
+        }
+        
+        // Read the baseline before running, so a bad path fails early
+        vector<BenchmarkResult> baseline;
+        if (!baselinePath.empty()) {
+            baseline = BenchmarkSuite::readBaseline(baselinePath);
+        }
+        
+        registerBenchmarkScenes(suite);
+        suite.runAll(cout);
+        
+        if (!newBaselinePath.empty()) {
+            suite.writeBaseline(newBaselinePath);
+        }
+        
+        if (!baselinePath.empty()) {
+            int regressions = suite.compareWithBaseline(baseline, threshold, cout);
+            cout << regressions << " regression(s) against " << baselinePath << endl;
+            return regressions > 0 ? 1 : 0;
+        }
+    } catch (const invalid_argument& error) {
+        cerr << error.what() << endl;
+        return 2;
+    }
+    
+    return 0;
+}
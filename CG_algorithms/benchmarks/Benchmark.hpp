@@ -0,0 +1,57 @@
+/**
+ * Benchmark.hpp
+ * Headless benchmark runner. Each benchmark is an operation that returns how
+ * many pixels it produced; the suite times it, counts its allocations (when
+ * built with CG_COUNT_ALLOCATIONS), writes the results as a JSON baseline
+ * and compares a run against a previous baseline.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+
+struct BenchmarkResult {
+    std::string name;
+    double nsPerOp;
+    double pixelsPerSecond;
+    // Negative when allocations are not being counted
+    double allocationsPerOp;
+};
+
+class Benchmark {
+public:
+    Benchmark(const std::string& name, const std::function<unsigned long()>& operation);
+    const std::string& getName() const;
+    BenchmarkResult run(double minSeconds) const;
+private:
+    std::string name;
+    std::function<unsigned long()> operation;
+};
+
+class BenchmarkSuite {
+public:
+    BenchmarkSuite();
+    void add(const std::string& name, const std::function<unsigned long()>& operation);
+    void setFilter(const std::string& filter);
+    void setMinSeconds(double minSeconds);
+    const std::vector<BenchmarkResult>& runAll(std::ostream& out);
+    const std::vector<BenchmarkResult>& getResults() const;
+    void writeBaseline(const std::string& path) const;
+    static std::vector<BenchmarkResult> readBaseline(const std::string& path);
+    int compareWithBaseline(const std::vector<BenchmarkResult>& baseline, double threshold, std::ostream& out) const;
+private:
+    std::vector<Benchmark> benchmarks;
+    std::vector<BenchmarkResult> results;
+    std::string filter;
+    double minSeconds;
+};
+
+int runBenchmarks(int argc, char **argv);
+
+#endif /* Benchmark_hpp */
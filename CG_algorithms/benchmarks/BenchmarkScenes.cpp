@@ -0,0 +1,718 @@
+/**
+ * BenchmarkScenes.cpp
+ * The scenes measured by the benchmark suite. Every operation goes through
+ * the public generate and clip methods, so the allocations of the figures
+ * are part of the measure.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "BenchmarkScenes.hpp"
+#include "../lines/Line.hpp"
+#include "../lines/Circumference.hpp"
+#include "../polygons/Polygon.hpp"
+#include "../polygons/HitTester.hpp"
+#include "../common/ViewportWindow.hpp"
+#include "../common/RetainedRenderer.hpp"
+#include "../common/Pipeline.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/Framebuffer.hpp"
+#include "../common/StreamingRenderer.hpp"
+#include "../common/ImageWriter.hpp"
+#include "../common/SpatialGrid.hpp"
+#include "../2D_transformations/Matrix2d.hpp"
+#include "../2D_transformations/TransformationMatrix.hpp"
+#include "../2D_transformations/TransformNode.hpp"
+#include <cmath>
+#include <sstream>
+#include <memory>
+#include <streambuf>
+
+using namespace std;
+
+// Results of the operations that do not produce pixels go here, so that
+// the compiler can not throw their work away
+static volatile float resultSink = 0;
+
+/**
+ * Build a polygon from a list of coordinates
+ * @param coordinates {float[][2]}
+ * @param count {size_t}
+ * @param dx {float}, dy {float} - translation applied to every coordinate
+ * @return {VertexBuffer}
+ */
+static VertexBuffer makeVertices(const float coordinates[][2], size_t count, float dx, float dy) {
+    VertexBuffer vertices;
+    for (size_t i = 0; i < count; i++) {
+        vertices.push_back(Vertex2d(coordinates[i][0] + dx, coordinates[i][1] + dy));
+    }
+    return vertices;
+}
+
+/**
+ * Build a star shaped polygon around a center, alternating two radii.
+ * The coordinates are rounded, as the Scan Line algorithm expects integer vertices.
+ * @param center {Vertex2d}
+ * @param count {int} - number of vertices
+ * @param outerRadius {float}, innerRadius {float}
+ * @return {VertexBuffer}
+ */
+static VertexBuffer makeStarVertices(const Vertex2d& center, int count, float outerRadius, float innerRadius) {
+    VertexBuffer vertices;
+    vertices.reserve(count);
+    for (int i = 0; i < count; i++) {
+        float angle = 2 * M_PI * i / count;
+        float radius = (i % 2 == 0) ? outerRadius : innerRadius;
+        vertices.push_back(Vertex2d(roundf(center.getX() + radius * cosf(angle)), roundf(center.getY() + radius * sinf(angle))));
+    }
+    return vertices;
+}
+
+static string makeName(const string& prefix, int value) {
+    ostringstream name;
+    name << prefix << value;
+    return name.str();
+}
+
+static void registerLineScenes(BenchmarkSuite& suite) {
+    // Slopes given by the end point of a line of length 1, from horizontal to vertical
+    const float directions[][2] = {{1, 0}, {1, 0.5f}, {0.7071f, 0.7071f}, {0.5f, 1}, {0, 1}};
+    const char *slopeNames[] = {"0", "0.5", "1", "2", "inf"};
+    const int lengths[] = {16, 256, 2048};
+    
+    for (int d = 0; d < 5; d++) {
+        for (int l = 0; l < 3; l++) {
+            Vertex2d start(10, 10);
+            Vertex2d end(10 + directions[d][0] * lengths[l], 10 + directions[d][1] * lengths[l]);
+            string suffix = string("/slope=") + slopeNames[d] + makeName("/length=", lengths[l]);
+            
+            suite.add("line/dda" + suffix, [start, end]() {
+                return (unsigned long) Line::generateLineDDA(start, end).getPoints().size();
+            });
+            suite.add("line/bresenham" + suffix, [start, end]() {
+                return (unsigned long) Line::generateLineBresenham(start, end).getPoints().size();
+            });
+        }
+    }
+}
+
+static void registerCircumferenceScenes(BenchmarkSuite& suite) {
+    const int radii[] = {8, 64, 512};
+    for (int r = 0; r < 3; r++) {
+        int radius = radii[r];
+        suite.add(makeName("circumference/bresenham/radius=", radius), [radius]() {
+            return (unsigned long) Circumference::generateCircumferenceBresenham(Vertex2d(600, 600), radius).getPoints().size();
+        });
+    }
+}
+
+static void registerPolygonScenes(BenchmarkSuite& suite) {
+    const float square[][2] = {{0, 0}, {0, 200}, {200, 200}, {200, 0}};
+    const float star[][2] = {{40, -40}, {23, 3}, {50, 20}, {15, 20}, {0, 50}, {-15, 20}, {-50, 20}, {-23, 3},
+                             {-40, -40}, {0, -10}};
+    const float heart[][2] = {{0, 0}, {10, 0}, {10, 10}, {20, 10}, {20, 20}, {30, 20}, {30, 30}, {40, 30},
+                              {40, 40}, {50, 40}, {50, 50}, {60, 50}, {60, 60}, {70, 60}, {70, 80}, {60, 80},
+                              {60, 90}, {50, 90}, {50, 100}, {30, 100}, {30, 90}, {20, 90}, {20, 80}, {10, 80},
+                              {10, 70}, {0, 70}, {0, 80}, {-10, 80}, {-10, 90}, {-20, 90}, {-20, 100}, {-40, 100},
+                              {-40, 90}, {-50, 90}, {-50, 80}, {-60, 80}, {-60, 60}, {-50, 60}, {-50, 50}, {-40, 50},
+                              {-40, 40}, {-30, 40}, {-30, 30}, {-20, 30}, {-20, 20}, {-10, 20}, {-10, 10}, {0, 10}};
+    
+    VertexBuffer convexVertices = makeVertices(square, 4, 100, 100);
+    VertexBuffer starVertices = makeVertices(star, 10, 100, 100);
+    VertexBuffer heartVertices = makeVertices(heart, 48, 100, 100);
+    VertexBuffer bigVertices = makeStarVertices(Vertex2d(400, 400), 10000, 300, 270);
+    
+    suite.add("polygon/filled/convex", [convexVertices]() {
+        return (unsigned long) Polygon::generateFilledPolygon(convexVertices).getPoints().size();
+    });
+    suite.add("polygon/filled/star", [starVertices]() {
+        return (unsigned long) Polygon::generateFilledPolygon(starVertices).getPoints().size();
+    });
+    suite.add("polygon/filled/heart", [heartVertices]() {
+        return (unsigned long) Polygon::generateFilledPolygon(heartVertices).getPoints().size();
+    });
+    suite.add("polygon/filled/10k-vertices", [bigVertices]() {
+        return (unsigned long) Polygon::generateFilledPolygon(bigVertices).getPoints().size();
+    });
+    
+    // The same polygons with the triangle fill engine, triangulated on every
+    // call, and then only rasterized from a triangulation done once
+    const char *names[] = {"convex", "star", "heart", "10k-vertices"};
+    VertexBuffer shapes[] = {convexVertices, starVertices, heartVertices, bigVertices};
+    for (int i = 0; i < 4; i++) {
+        VertexBuffer vertices = shapes[i];
+        suite.add(string("polygon/filled/") + names[i] + "/triangles", [vertices]() {
+            return (unsigned long) Polygon::generateFilledPolygon(vertices, TRIANGLE_FILL).getPoints().size();
+        });
+        
+        shared_ptr<VertexBuffer> scanLineVertices = make_shared<VertexBuffer>(vertices);
+        suite.add(string("polygon/raster/") + names[i] + "/scan-line", [scanLineVertices]() {
+            CountingPixelSink counter;
+            Polygon::rasterizeFilledPolygon(*scanLineVertices, counter);
+            return (unsigned long) counter.getCount();
+        });
+        shared_ptr<Polygon> triangulated = make_shared<Polygon>(vertices, true);
+        triangulated->setFillEngine(TRIANGLE_FILL);
+        suite.add(string("polygon/raster/") + names[i] + "/cached-triangles", [triangulated]() {
+            CountingPixelSink counter;
+            triangulated->rasterize(counter);
+            return (unsigned long) counter.getCount();
+        });
+    }
+    
+    // Convex polygons, filled by the general Scan Line algorithm and by
+    // walking the two chains of edges of the polygon
+    const char *convexNames[] = {"convex", "64-gon"};
+    VertexBuffer convexShapes[] = {convexVertices, makeStarVertices(Vertex2d(400, 400), 64, 300, 300)};
+    for (int i = 0; i < 2; i++) {
+        shared_ptr<VertexBuffer> vertices = make_shared<VertexBuffer>(convexShapes[i]);
+        suite.add(string("polygon/convex/") + convexNames[i] + "/general", [vertices]() {
+            CountingPixelSink counter;
+            Polygon::rasterizeFilledPolygon(*vertices, counter);
+            return (unsigned long) counter.getCount();
+        });
+        suite.add(string("polygon/convex/") + convexNames[i] + "/two-chains", [vertices]() {
+            CountingPixelSink counter;
+            Polygon::rasterizeConvexPolygon(*vertices, counter);
+            return (unsigned long) counter.getCount();
+        });
+    }
+}
+
+/**
+ * Add the scenes of a star of 10k vertices, filled and outlined, with the
+ * coordinates of a given type
+ * @param suite {BenchmarkSuite&}
+ * @param name {const char*} - the name of the coordinate type
+ */
+template <typename T>
+static void registerCoordinateScenes(BenchmarkSuite& suite, const char *name) {
+    shared_ptr<vector<BasicVertex2d<T>>> vertices = make_shared<vector<BasicVertex2d<T>>>();
+    for (const Vertex2d& vertex : makeStarVertices(Vertex2d(400, 400), 10000, 300, 270)) {
+        vertices->push_back(BasicVertex2d<T>(vertex));
+    }
+    
+    suite.add(string("coordinates/filled/") + name, [vertices]() {
+        CountingPixelSink counter;
+        Polygon::rasterizeFilledPolygon(BasicVertexSpan<T>(*vertices), counter);
+        return (unsigned long) counter.getCount();
+    });
+    suite.add(string("coordinates/outline/") + name, [vertices]() {
+        CountingPixelSink counter;
+        Polygon::rasterizeNotFilledPolygon(BasicVertexSpan<T>(*vertices), counter);
+        return (unsigned long) counter.getCount();
+    });
+}
+
+static void registerClippingScenes(BenchmarkSuite& suite) {
+    Vertex2d bottomLeftCorner(100, 100);
+    Vertex2d topRightCorner(500, 400);
+    
+    // Lines and squares inside, outside and crossing the window
+    const float lines[][4] = {{150, 150, 450, 350}, {10, 10, 80, 600}, {50, 50, 550, 450}};
+    const float squares[][2] = {{200, 200}, {600, 600}, {400, 300}};
+    const char *placements[] = {"inside", "outside", "crossing"};
+    
+    for (int i = 0; i < 3; i++) {
+        Line line(lines[i][0], lines[i][1], lines[i][2], lines[i][3]);
+        suite.add(string("clip/line/") + placements[i], [line, bottomLeftCorner, topRightCorner]() {
+            ViewportWindow window(bottomLeftCorner, topRightCorner);
+            window.clipLine(line);
+            resultSink = window.getVisibleObjects().size();
+            return 0ul;
+        });
+        
+        float x = squares[i][0], y = squares[i][1];
+        const float square[][2] = {{x, y}, {x, y + 150}, {x + 150, y + 150}, {x + 150, y}};
+        Polygon polygon(makeVertices(square, 4, 0, 0), true);
+        suite.add(string("clip/polygon/") + placements[i], [polygon, bottomLeftCorner, topRightCorner]() {
+            ViewportWindow window(bottomLeftCorner, topRightCorner);
+            window.clipPolygon(polygon);
+            resultSink = window.getVisibleObjects().size();
+            return 0ul;
+        });
+    }
+    
+    // A mix of all the placements, as in a scene
+    suite.add("clip/mixed", [bottomLeftCorner, topRightCorner]() {
+        ViewportWindow window(bottomLeftCorner, topRightCorner);
+        for (int i = 0; i < 3; i++) {
+            const float square[][2] = {{20.0f + 200 * i, 20.0f + 150 * i}, {20.0f + 200 * i, 170.0f + 150 * i},
+                                       {170.0f + 200 * i, 170.0f + 150 * i}, {170.0f + 200 * i, 20.0f + 150 * i}};
+            window.clipLine(Line(50.0f * i, 40.0f, 300.0f + 120 * i, 450.0f));
+            window.clipPolygon(Polygon(makeVertices(square, 4, 0, 0), true));
+        }
+        resultSink = window.getVisibleObjects().size();
+        return 0ul;
+    });
+}
+
+static void registerTransformationScenes(BenchmarkSuite& suite) {
+    TransformationMatrix *transformations = TransformationMatrix::getInstance();
+    Matrix2d rotation = transformations->getRotationMatrix(30, 50, 50);
+    Matrix2d scale = transformations->getScaleMatrix(1.5f, 0.5f, 10, 10);
+    Vertex2d vertex(123, 45);
+    
+    suite.add("matrix/product", [rotation, scale]() mutable {
+        Matrix2d product = rotation * scale;
+        resultSink = product.getElement(0, 0);
+        return 0ul;
+    });
+    suite.add("matrix/transform-vertex", [rotation, vertex]() mutable {
+        Vertex2d transformed = rotation * vertex;
+        resultSink = transformed.getX();
+        return 0ul;
+    });
+    int angle = 0;
+    suite.add("matrix/rotation-about-pivot", [transformations, angle]() mutable {
+        // Multiples of 10 degrees, like the animation of main.cpp
+        angle = (angle + 10) % 360;
+        Matrix2d rotation = transformations->getRotationMatrix(angle, 50, 150);
+        resultSink = rotation.getElement(0, 2);
+        return 0ul;
+    });
+    suite.add("matrix/scale-about-pivot", [transformations]() {
+        Matrix2d scale = transformations->getScaleMatrix(0.75f, 0.75f, 50, 150);
+        resultSink = scale.getElement(0, 2);
+        return 0ul;
+    });
+    Matrix2d translation = transformations->getTranslationMatrix(3, -2);
+    suite.add("matrix/product/translation", [translation]() mutable {
+        Matrix2d product = translation * translation;
+        resultSink = product.getElement(0, 2);
+        return 0ul;
+    });
+    
+    // Panning 4096 vertices, and rotating them, in place
+    shared_ptr<VertexBuffer> vertices = make_shared<VertexBuffer>();
+    for (int i = 0; i < 4096; i++) {
+        vertices->push_back(Vertex2d(i % 640, i / 640));
+    }
+    suite.add("matrix/transform-4096-vertices/translation", [translation, vertices]() {
+        translation.transformVertices(vertices->data(), vertices->size());
+        return 0ul;
+    });
+    suite.add("matrix/transform-4096-vertices/rotation", [rotation, vertices]() {
+        rotation.transformVertices(vertices->data(), vertices->size());
+        return 0ul;
+    });
+}
+
+static void registerRetainedScenes(BenchmarkSuite& suite) {
+    // A static dashboard of 12x9 squares with one small square moving over it
+    shared_ptr<vector<Polygon>> dashboard = make_shared<vector<Polygon>>();
+    for (int row = 0; row < 9; row++) {
+        for (int column = 0; column < 12; column++) {
+            float x = 10 + 52 * column, y = 10 + 52 * row;
+            const float square[][2] = {{x, y}, {x, y + 40}, {x + 40, y + 40}, {x + 40, y}};
+            dashboard->push_back(Polygon::generateFilledPolygon(makeVertices(square, 4, 0, 0)));
+        }
+    }
+    
+    const float movingSquare[][2] = {{0, 0}, {0, 30}, {30, 30}, {30, 0}};
+    shared_ptr<Polygon> moving = make_shared<Polygon>(Polygon::generateFilledPolygon(makeVertices(movingSquare, 4, 0, 200)));
+    shared_ptr<RetainedRenderer> renderer = make_shared<RetainedRenderer>(640, 480);
+    for (size_t i = 0; i < dashboard->size(); i++) {
+        renderer->setFigure((int) i + 1, &(*dashboard)[i]);
+    }
+    renderer->setFigure(0, moving.get());
+    renderer->render();
+    
+    suite.add("retained/full-redraw", [dashboard, moving, renderer]() {
+        moving->translate(moving->getPoints()[0].getX() > 600 ? -600 : 5, 0);
+        renderer->setFigure(0, moving.get());
+        renderer->invalidateAll();
+        return (unsigned long) renderer->render();
+    });
+    suite.add("retained/dirty-redraw", [dashboard, moving, renderer]() {
+        moving->translate(moving->getPoints()[0].getX() > 600 ? -600 : 5, 0);
+        renderer->setFigure(0, moving.get());
+        return (unsigned long) renderer->render();
+    });
+}
+
+/**
+ * Aliased and anti-aliased figures drawn into a framebuffer. The coverage
+ * fill is compared to what it replaces: filling at 4x the resolution in each
+ * axis and averaging every 4x4 block back down.
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerAntialiasingScenes(BenchmarkSuite& suite) {
+    const float star[][2] = {{40, -40}, {23, 3}, {50, 20}, {15, 20}, {0, 50}, {-15, 20}, {-50, 20}, {-23, 3},
+                             {-40, -40}, {0, -10}};
+    VertexBuffer starVertices = makeVertices(star, 10, 100, 100);
+    VertexBuffer bigStarVertices;
+    for (const Vertex2d& vertice : starVertices) {
+        bigStarVertices.push_back(Vertex2d(vertice.getX() * 4, vertice.getY() * 4));
+    }
+    
+    shared_ptr<Framebuffer> framebuffer = make_shared<Framebuffer>(200, 200);
+    shared_ptr<Framebuffer> bigFramebuffer = make_shared<Framebuffer>(800, 800);
+    
+    CountingPixelSink counter;
+    Polygon::rasterizeFilledPolygon(starVertices, counter);
+    unsigned long starPixels = (unsigned long) counter.getCount();
+    
+    suite.add("antialiasing/polygon/scan-line", [starVertices, framebuffer, starPixels]() {
+        FramebufferPixelSink sink(*framebuffer);
+        Polygon::rasterizeFilledPolygon(starVertices, sink);
+        return starPixels;
+    });
+    suite.add("antialiasing/polygon/coverage", [starVertices, framebuffer]() {
+        FramebufferPixelSink sink(*framebuffer);
+        Polygon::rasterizeAntialiasedPolygon(starVertices, sink);
+        return 0ul;
+    });
+    suite.add("antialiasing/polygon/supersample-4x", [bigStarVertices, framebuffer, bigFramebuffer]() {
+        FramebufferPixelSink sink(*bigFramebuffer);
+        bigFramebuffer->clear(0.0f, 0.0f, 0.0f);
+        Polygon::rasterizeFilledPolygon(bigStarVertices, sink);
+        
+        const unsigned char *pixels = bigFramebuffer->getPixels();
+        Vertex2d color;
+        for (int y = 0; y < 200; y++) {
+            for (int x = 0; x < 200; x++) {
+                float red = 0, green = 0, blue = 0;
+                for (int dy = 0; dy < 4; dy++) {
+                    const unsigned char *pixel = pixels + 3 * ((4 * y + dy) * 800 + 4 * x);
+                    for (int dx = 0; dx < 4; dx++, pixel += 3) {
+                        red += pixel[0];
+                        green += pixel[1];
+                        blue += pixel[2];
+                    }
+                }
+                color.setRGBColors(red / (16 * 255.0f), green / (16 * 255.0f), blue / (16 * 255.0f));
+                framebuffer->setPixel(x, y, color);
+            }
+        }
+        return 0ul;
+    });
+    
+    Vertex2d start(10, 10);
+    Vertex2d end(190, 100);
+    suite.add("antialiasing/line/bresenham", [start, end, framebuffer]() {
+        FramebufferPixelSink sink(*framebuffer);
+        Line::rasterizeLineBresenham(start, end, sink);
+        return 181ul;
+    });
+    suite.add("antialiasing/line/wu", [start, end, framebuffer]() {
+        FramebufferPixelSink sink(*framebuffer);
+        Line::rasterizeLineWu(start, end, sink);
+        return 362ul;
+    });
+}
+
+/**
+ * Stream buffer that throws the bytes away, so the image scenes measure the
+ * rendering and not the disk
+ */
+class DiscardingBuffer : public streambuf {
+protected:
+    int overflow(int character) {
+        return character;
+    }
+    
+    streamsize xsputn(const char*, streamsize count) {
+        return count;
+    }
+};
+
+/**
+ * A 2048x2048 image of squares and lines saved as PPM: rendered whole into a
+ * framebuffer and then written, and streamed a band of 64 rows at a time
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerStreamingScenes(BenchmarkSuite& suite) {
+    const int size = 2048;
+    shared_ptr<vector<Polygon>> squares = make_shared<vector<Polygon>>();
+    shared_ptr<vector<Line>> lines = make_shared<vector<Line>>();
+    for (int row = 0; row < 32; row++) {
+        for (int column = 0; column < 32; column++) {
+            float x = 8 + 64 * column, y = 8 + 64 * row;
+            const float square[][2] = {{x, y}, {x, y + 40}, {x + 40, y + 48}, {x + 48, y}};
+            squares->push_back(Polygon::generateFilledPolygon(makeVertices(square, 4, 0, 0)));
+        }
+        lines->push_back(Line::generateLineBresenham(Vertex2d(0, 64 * row), Vertex2d(size - 1, size - 1 - 64 * row)));
+    }
+    
+    shared_ptr<StreamingRenderer> streaming = make_shared<StreamingRenderer>(size, size, 64);
+    for (const Polygon& square : *squares) {
+        streaming->addFigure(&square);
+    }
+    for (const Line& line : *lines) {
+        streaming->addFigure(&line);
+    }
+    
+    suite.add("streaming/framebuffer", [squares, lines, size]() {
+        DiscardingBuffer buffer;
+        ostream output(&buffer);
+        PpmImageWriter writer(output);
+        Framebuffer framebuffer(size, size);
+        FramebufferPixelSink sink(framebuffer);
+        for (const Polygon& square : *squares) {
+            square.rasterize(sink);
+        }
+        for (const Line& line : *lines) {
+            for (const Vertex2d& point : line.getPoints()) {
+                sink.plot((int) point.getX(), (int) point.getY(), point);
+            }
+        }
+        
+        writer.begin(size, size);
+        for (int row = size - 1; row >= 0; row--) {
+            writer.writeRow(framebuffer.getPixels() + 3 * (size_t) row * size);
+        }
+        writer.finish();
+        return (unsigned long) size * size;
+    });
+    suite.add("streaming/bands", [squares, lines, streaming, size]() {
+        DiscardingBuffer buffer;
+        ostream output(&buffer);
+        PpmImageWriter writer(output);
+        streaming->render(writer);
+        return (unsigned long) size * size;
+    });
+}
+
+/**
+ * A stream of figures going through transform, clip and raster, on the
+ * calling thread and then through the staged pipeline
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerPipelineScenes(BenchmarkSuite& suite) {
+    const int figureCount = 256;
+    shared_ptr<vector<PipelineFigure>> figures = make_shared<vector<PipelineFigure>>(figureCount);
+    shared_ptr<vector<PipelineFigure>> stream = make_shared<vector<PipelineFigure>>(figureCount);
+    
+    for (int i = 0; i < figureCount; i++) {
+        PipelineFigure& figure = (*figures)[i];
+        float x = (i * 37) % 600, y = (i * 53) % 440;
+        figure.hasTransformation = true;
+        figure.transformation = TransformationMatrix::getInstance()->getRotationMatrix(i % 360, x, y);
+        
+        if (i % 4 == 3) {
+            figure.type = LINE;
+            figure.vertices.push_back(Vertex2d(x, y));
+            figure.vertices.push_back(Vertex2d(x + 80, y + 30));
+        } else {
+            const float square[][2] = {{x, y}, {x, y + 60}, {x + 60, y + 60}, {x + 60, y}};
+            figure.type = POLYGON;
+            figure.filled = true;
+            figure.vertices = makeVertices(square, 4, 0, 0);
+        }
+    }
+    
+    shared_ptr<Pipeline> sequential = make_shared<Pipeline>(Vertex2d(0, 0), Vertex2d(640, 480));
+    suite.add("pipeline/sequential", [figures, stream, sequential]() {
+        unsigned long pixels = 0;
+        for (size_t i = 0; i < figures->size(); i++) {
+            PipelineFigure& figure = (*stream)[i];
+            figure.vertices = (*figures)[i].vertices;
+            figure.type = (*figures)[i].type;
+            figure.filled = (*figures)[i].filled;
+            figure.transformation = (*figures)[i].transformation;
+            figure.hasTransformation = true;
+            sequential->process(&figure);
+            pixels += figure.points.size();
+        }
+        return pixels;
+    });
+    
+    shared_ptr<Pipeline> staged = make_shared<Pipeline>(Vertex2d(0, 0), Vertex2d(640, 480), 2);
+    staged->start();
+    suite.add("pipeline/staged", [figures, stream, staged]() {
+        unsigned long pixels = 0;
+        size_t next = 0, done = 0;
+        PipelineFigure *figure;
+        
+        // Keep submitting while there is room, and take what comes out in between
+        while (done < figures->size()) {
+            if (next < figures->size()) {
+                PipelineFigure& nextFigure = (*stream)[next];
+                nextFigure.vertices = (*figures)[next].vertices;
+                nextFigure.type = (*figures)[next].type;
+                nextFigure.filled = (*figures)[next].filled;
+                nextFigure.transformation = (*figures)[next].transformation;
+                nextFigure.hasTransformation = true;
+                if (staged->trySubmit(&nextFigure)) {
+                    next++;
+                }
+            }
+            while (staged->tryReceive(figure)) {
+                pixels += figure->points.size();
+                done++;
+            }
+        }
+        return pixels;
+    });
+}
+
+/**
+ * The figures of the culling scenes, built by the first scene that runs so
+ * that the suite does not pay for them when they are filtered out
+ */
+struct CullingScene {
+    vector<BoundingBox> boxes;
+    SpatialGrid grid;
+    
+    void build() {
+        if (!this->boxes.empty()) {
+            return;
+        }
+        const int figureCount = 1000000;
+        this->boxes.reserve(figureCount);
+        unsigned int seed = 12345;
+        for (int i = 0; i < figureCount; i++) {
+            seed = seed * 1103515245 + 12345;
+            int x = (seed >> 8) % 64000;
+            seed = seed * 1103515245 + 12345;
+            int y = (seed >> 8) % 64000;
+            int size = 8 + (int) (seed % 56);
+            this->boxes.push_back(BoundingBox(x, y, x + size, y + size));
+            this->grid.update(i, this->boxes.back());
+        }
+    }
+};
+
+/**
+ * Finding the figures inside a 800x600 window among 1M figures spread over a
+ * 64000x64000 plane: testing every bounding box, and querying a SpatialGrid.
+ * Moving one figure shows what keeping the grid up to date costs.
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerCullingScenes(BenchmarkSuite& suite) {
+    shared_ptr<CullingScene> scene = make_shared<CullingScene>();
+    shared_ptr<ViewportWindow> window = make_shared<ViewportWindow>(Vertex2d(31600, 31700), Vertex2d(32400, 32300));
+    
+    suite.add("culling/linear", [scene, window]() {
+        scene->build();
+        BoundingBox region = window->getBoundingBox();
+        unsigned long found = 0;
+        for (const BoundingBox& box : scene->boxes) {
+            found += box.intersects(region);
+        }
+        resultSink = found;
+        return 0ul;
+    });
+    suite.add("culling/grid", [scene, window]() {
+        scene->build();
+        vector<int> figureIds;
+        window->cull(scene->grid, figureIds);
+        resultSink = figureIds.size();
+        return 0ul;
+    });
+    int moved = 0;
+    suite.add("culling/grid/update", [scene, moved]() mutable {
+        scene->build();
+        // Walks a figure across the cells, one pixel at a time
+        const BoundingBox& box = scene->boxes[0];
+        moved = (moved + 1) % 256;
+        scene->grid.update(0, BoundingBox(box.getXMin() + moved, box.getYMin(), box.getXMax() + moved, box.getYMax()));
+        return 0ul;
+    });
+}
+
+/**
+ * Finding the polygon under the cursor among 4096 filled stars: searching the
+ * rasterized points of every polygon from the top one down, and asking a
+ * HitTester, one point at a time and 1024 points at once
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerHitTestScenes(BenchmarkSuite& suite) {
+    shared_ptr<vector<Polygon>> polygons = make_shared<vector<Polygon>>();
+    shared_ptr<HitTester> tester = make_shared<HitTester>();
+    for (int i = 0; i < 4096; i++) {
+        Vertex2d center(20 + (i * 37) % 1960, 20 + (i * 53) % 1960);
+        polygons->push_back(Polygon::generateFilledPolygon(makeStarVertices(center, 10, 20, 8)));
+        tester->setPolygon(i, polygons->back());
+    }
+    
+    shared_ptr<VertexBuffer> cursors = make_shared<VertexBuffer>();
+    for (int i = 0; i < 1024; i++) {
+        cursors->push_back(Vertex2d((i * 97) % 2000, (i * 61) % 2000));
+    }
+    
+    suite.add("hittest/raster-search", [polygons, cursors]() {
+        const Vertex2d& cursor = cursors->front();
+        for (size_t i = polygons->size(); i-- > 0;) {
+            for (const Vertex2d& point : (*polygons)[i].getPoints()) {
+                if (point.getX() == cursor.getX() && point.getY() == cursor.getY()) {
+                    return (unsigned long) i;
+                }
+            }
+        }
+        return 0ul;
+    });
+    suite.add("hittest/hit-tester", [tester, cursors]() {
+        const Vertex2d& cursor = cursors->front();
+        return (unsigned long) (tester->hitTest((int) cursor.getX(), (int) cursor.getY()) + 1);
+    });
+    suite.add("hittest/hit-tester/batch-1024", [tester, cursors]() {
+        vector<int> figureIds;
+        tester->hitTest(*cursors, figureIds);
+        return (unsigned long) figureIds.size();
+    });
+}
+
+/**
+ * Moving a group of 256 stars one step: transforming the vertices of every
+ * star in place, and changing the matrix of the group in a hierarchy of
+ * TransformNodes, then asking for the world matrix of every star, or for its
+ * transformed vertices
+ * @param suite {BenchmarkSuite&}
+ */
+static void registerHierarchyScenes(BenchmarkSuite& suite) {
+    shared_ptr<vector<Polygon>> stars = make_shared<vector<Polygon>>();
+    shared_ptr<TransformNode> group = make_shared<TransformNode>();
+    shared_ptr<vector<TransformNode>> nodes = make_shared<vector<TransformNode>>(256);
+    for (int i = 0; i < 256; i++) {
+        Vertex2d center(20 + (i % 16) * 40, 20 + (i / 16) * 40);
+        stars->push_back(Polygon::generateNotFilledPolygon(makeStarVertices(center, 5, 15, 6)));
+        (*nodes)[i].setParent(group.get());
+    }
+    
+    suite.add("hierarchy/move-vertices", [stars]() {
+        for (Polygon& star : *stars) {
+            star.translate(1, 0);
+        }
+        return 0ul;
+    });
+    suite.add("hierarchy/move-group", [group, nodes]() {
+        group->translate(1, 0);
+        for (TransformNode& node : *nodes) {
+            resultSink = node.getWorldMatrix().getElement(0, 2);
+        }
+        return 0ul;
+    });
+    shared_ptr<VertexBuffer> transformed = make_shared<VertexBuffer>();
+    suite.add("hierarchy/move-group/transform", [stars, group, nodes, transformed]() {
+        group->translate(1, 0);
+        for (size_t i = 0; i < nodes->size(); i++) {
+            (*nodes)[i].transform((*stars)[i].getVertices(), *transformed);
+        }
+        return 0ul;
+    });
+}
+
+/**
+ * Add every scene to the suite
+ * @param suite {BenchmarkSuite&}
+ */
+void registerBenchmarkScenes(BenchmarkSuite& suite) {
+    registerLineScenes(suite);
+    registerCircumferenceScenes(suite);
+    registerPolygonScenes(suite);
+    registerCoordinateScenes<int16_t>(suite, "int16");
+    registerCoordinateScenes<int32_t>(suite, "int32");
+    registerCoordinateScenes<float>(suite, "float");
+    registerCoordinateScenes<double>(suite, "double");
+    registerClippingScenes(suite);
+    registerTransformationScenes(suite);
+    registerRetainedScenes(suite);
+    registerAntialiasingScenes(suite);
+    registerStreamingScenes(suite);
+    registerPipelineScenes(suite);
+    registerCullingScenes(suite);
+    registerHitTestScenes(suite);
+    registerHierarchyScenes(suite);
+}
@@ -0,0 +1,16 @@
+/**
+ * BenchmarkScenes.hpp
+ * The scenes measured by the benchmark suite: lines, circumferences,
+ * filled polygons, clipping and 2D transformations.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef BenchmarkScenes_hpp
+#define BenchmarkScenes_hpp
+
+#include "Benchmark.hpp"
+
+void registerBenchmarkScenes(BenchmarkSuite& suite);
+
+#endif /* BenchmarkScenes_hpp */
@@ -0,0 +1,70 @@
+/**
+ * AllocationCounter.cpp
+ * Counts the heap allocations made by the program. The counting only happens
+ * when the project is built with CG_COUNT_ALLOCATIONS defined, which replaces
+ * the global operator new; otherwise every getter returns 0.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "AllocationCounter.hpp"
+
+#ifdef CG_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long> allocations(0);
+static std::atomic<unsigned long> allocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+unsigned long AllocationCounter::getAllocations() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+unsigned long AllocationCounter::getAllocatedBytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+unsigned long AllocationCounter::getAllocations() {
+    return 0;
+}
+
+unsigned long AllocationCounter::getAllocatedBytes() {
+    return 0;
+}
+
+#endif
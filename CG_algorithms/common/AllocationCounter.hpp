@@ -0,0 +1,20 @@
+/**
+ * AllocationCounter.hpp
+ * Counts the heap allocations made by the program. The counting only happens
+ * when the project is built with CG_COUNT_ALLOCATIONS defined, which replaces
+ * the global operator new; otherwise every getter returns 0.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef AllocationCounter_hpp
+#define AllocationCounter_hpp
+
+class AllocationCounter {
+public:
+    static bool isEnabled();
+    static unsigned long getAllocations();
+    static unsigned long getAllocatedBytes();
+};
+
+#endif /* AllocationCounter_hpp */
@@ -0,0 +1,250 @@
+/**
+ * BinaryScene.cpp
+ * Binary version of the scene files, made to be mapped in memory.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "BinaryScene.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// The vertex array is the memory of the vertices, so they must stay plain floats
+static_assert(sizeof(Vertex2d) == 6 * sizeof(float), "Vertex2d must be six floats");
+static_assert(is_standard_layout<Vertex2d>::value, "Vertex2d must keep its fields in order");
+static_assert(is_trivially_copyable<Vertex2d>::value, "Vertex2d must be copied as bytes");
+
+static const char MAGIC[8] = {'C', 'G', 'S', 'C', 'E', 'N', 'E', '\0'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const size_t VERTEX_ALIGNMENT = 16;
+
+/**
+ * Write a scene in the binary format
+ * @param scene {Scene}
+ * @param path {string}
+ */
+void BinarySceneFile::write(const Scene& scene, const string& path) {
+    BinarySceneHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = BINARY_SCENE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.width = (uint32_t) scene.width;
+    header.height = (uint32_t) scene.height;
+    header.background[0] = scene.background.getRed();
+    header.background[1] = scene.background.getGreen();
+    header.background[2] = scene.background.getBlue();
+    header.window[0] = scene.windowBottomLeft.getX();
+    header.window[1] = scene.windowBottomLeft.getY();
+    header.window[2] = scene.windowTopRight.getX();
+    header.window[3] = scene.windowTopRight.getY();
+    header.figureCount = (uint32_t) scene.figures.size();
+    header.vertexSize = sizeof(Vertex2d);
+    header.figureTableOffset = sizeof(BinarySceneHeader);
+    
+    vector<BinarySceneFigure> figures(scene.figures.size());
+    uint64_t vertexCount = 0;
+    for (size_t i = 0; i < scene.figures.size(); i++) {
+        const PipelineFigure& sceneFigure = scene.figures[i];
+        BinarySceneFigure& figure = figures[i];
+        memset(&figure, 0, sizeof(figure));
+        figure.type = (uint32_t) sceneFigure.type;
+        figure.flags = (sceneFigure.filled ? BINARY_SCENE_FILLED : 0) |
+                       (sceneFigure.hasTransformation ? BINARY_SCENE_TRANSFORMED : 0);
+        figure.firstVertex = vertexCount;
+        figure.vertexCount = (uint32_t) sceneFigure.vertices.size();
+        figure.radius = sceneFigure.radius;
+        vertexCount += sceneFigure.vertices.size();
+    
+        // The color of a figure is the one of its first vertex, already in the vertex array
+        const Vertex2d& first = sceneFigure.vertices[0];
+        figure.bounds[0] = figure.bounds[2] = first.getX();
+        figure.bounds[1] = figure.bounds[3] = first.getY();
+        for (const Vertex2d& vertice : sceneFigure.vertices) {
+            figure.bounds[0] = min(figure.bounds[0], vertice.getX());
+            figure.bounds[1] = min(figure.bounds[1], vertice.getY());
+            figure.bounds[2] = max(figure.bounds[2], vertice.getX());
+            figure.bounds[3] = max(figure.bounds[3], vertice.getY());
+        }
+        // A circumference goes as far as its radius from the center
+        if (sceneFigure.type == CIRCUMFERENCE) {
+            figure.bounds[0] -= sceneFigure.radius;
+            figure.bounds[1] -= sceneFigure.radius;
+            figure.bounds[2] += sceneFigure.radius;
+            figure.bounds[3] += sceneFigure.radius;
+        }
+    
+        if (sceneFigure.hasTransformation) {
+            for (int row = 0; row < 3; row++) {
+                for (int column = 0; column < 3; column++) {
+                    figure.transformation[3 * row + column] = sceneFigure.transformation.getElement(row, column);
+                }
+            }
+        }
+    }
+    
+    uint64_t tableEnd = header.figureTableOffset + figures.size() * sizeof(BinarySceneFigure);
+    header.vertexArrayOffset = (tableEnd + VERTEX_ALIGNMENT - 1) / VERTEX_ALIGNMENT * VERTEX_ALIGNMENT;
+    header.vertexCount = vertexCount;
+    
+    ofstream file(path.c_str(), ios::binary);
+    if (!file) {
+        throw invalid_argument("Could not write the scene file " + path);
+    }
+    file.write((const char*) &header, sizeof(header));
+    file.write((const char*) figures.data(), figures.size() * sizeof(BinarySceneFigure));
+    vector<char> padding(header.vertexArrayOffset - tableEnd, 0);
+    file.write(padding.data(), padding.size());
+    for (const PipelineFigure& sceneFigure : scene.figures) {
+        file.write((const char*) sceneFigure.vertices.data(), sceneFigure.vertices.size() * sizeof(Vertex2d));
+    }
+    if (!file) {
+        throw invalid_argument("Could not write the scene file " + path);
+    }
+}
+
+/**
+ * Constructor of the class. Maps the file and checks its header and figure
+ * table; the vertices are only read when the figures are drawn.
+ * @param path {string}
+ */
+MappedScene::MappedScene(const string& path):path(path), mapping(NULL), size(0) {
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw invalid_argument("Could not read the scene file " + path);
+    }
+    
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t) sizeof(BinarySceneHeader)) {
+        close(descriptor);
+        throw invalid_argument(path + ": not a binary scene");
+    }
+    this->size = (size_t) status.st_size;
+    this->mapping = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping keeps the file, the descriptor is not needed anymore
+    close(descriptor);
+    if (this->mapping == MAP_FAILED) {
+        this->mapping = NULL;
+        throw invalid_argument("Could not map the scene file " + path);
+    }
+    
+    try {
+        const char *bytes = (const char*) this->mapping;
+        this->header = (const BinarySceneHeader*) bytes;
+        if (memcmp(this->header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw invalid_argument("not a binary scene");
+        }
+        if (this->header->byteOrder != BYTE_ORDER_MARK) {
+            throw invalid_argument("the scene was written with another byte order");
+        }
+        if (this->header->version != BINARY_SCENE_VERSION) {
+            throw invalid_argument("unknown version of the binary scene format");
+        }
+        if (this->header->vertexSize != sizeof(Vertex2d) || this->header->vertexArrayOffset % VERTEX_ALIGNMENT != 0) {
+            throw invalid_argument("the vertices do not have the layout of Vertex2d");
+        }
+        if (this->header->width == 0 || this->header->height == 0) {
+            throw invalid_argument("the image must have at least one pixel");
+        }
+    
+        uint64_t tableEnd = this->header->figureTableOffset + (uint64_t) this->header->figureCount * sizeof(BinarySceneFigure);
+        uint64_t vertexEnd = this->header->vertexArrayOffset + this->header->vertexCount * sizeof(Vertex2d);
+        if (this->header->figureTableOffset > this->size || this->header->vertexArrayOffset > this->size ||
+            this->header->figureTableOffset % alignof(BinarySceneFigure) != 0 || tableEnd > this->size ||
+            vertexEnd > this->size || this->header->vertexCount > this->size / sizeof(Vertex2d)) {
+            throw invalid_argument("the file is truncated");
+        }
+        this->figures = (const BinarySceneFigure*) (bytes + this->header->figureTableOffset);
+        this->vertices = (const Vertex2d*) (bytes + this->header->vertexArrayOffset);
+    
+        // Every figure must stay inside the vertex array and have enough vertices for its type
+        for (uint32_t i = 0; i < this->header->figureCount; i++) {
+            const BinarySceneFigure& figure = this->figures[i];
+            uint32_t minimumVertices = figure.type == POLYGON ? 3 : figure.type == LINE ? 2 : 1;
+            if (figure.type > CIRCUMFERENCE || figure.vertexCount < minimumVertices ||
+                figure.firstVertex > this->header->vertexCount ||
+                figure.vertexCount > this->header->vertexCount - figure.firstVertex) {
+                throw invalid_argument("the figure table is corrupted");
+            }
+        }
+    } catch (const invalid_argument& error) {
+        munmap(this->mapping, this->size);
+        throw invalid_argument(path + ": " + error.what());
+    }
+}
+
+MappedScene::~MappedScene() {
+    munmap(this->mapping, this->size);
+}
+
+/**
+ * Getters for the image size, its background and its clipping window
+ */
+int MappedScene::getWidth() const {
+    return (int) this->header->width;
+}
+
+int MappedScene::getHeight() const {
+    return (int) this->header->height;
+}
+
+Vertex2d MappedScene::getBackground() const {
+    Vertex2d background;
+    background.setRGBColors(this->header->background[0], this->header->background[1], this->header->background[2]);
+    return background;
+}
+
+Vertex2d MappedScene::getWindowBottomLeft() const {
+    return Vertex2d(this->header->window[0], this->header->window[1]);
+}
+
+Vertex2d MappedScene::getWindowTopRight() const {
+    return Vertex2d(this->header->window[2], this->header->window[3]);
+}
+
+/**
+ * Number of figures in the scene
+ * @return {size_t}
+ */
+size_t MappedScene::getFigureCount() const {
+    return this->header->figureCount;
+}
+
+/**
+ * A figure of the figure table
+ * @param index {size_t}
+ * @return {const BinarySceneFigure&}
+ */
+const BinarySceneFigure& MappedScene::getFigure(size_t index) const {
+    return this->figures[index];
+}
+
+/**
+ * The vertices of a figure, straight from the file
+ * @param index {size_t}
+ * @return {VertexSpan} - valid while the scene is mapped
+ */
+VertexSpan MappedScene::getVertices(size_t index) const {
+    const BinarySceneFigure& figure = this->figures[index];
+    return VertexSpan(this->vertices + figure.firstVertex, figure.vertexCount);
+}
+
+/**
+ * The transformation of a figure
+ * @param index {size_t}
+ * @return {Matrix2d}
+ */
+Matrix2d MappedScene::getTransformation(size_t index) const {
+    const float *values = this->figures[index].transformation;
+    return Matrix2d(vector<float>(values, values + 9));
+}
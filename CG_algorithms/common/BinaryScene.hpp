@@ -0,0 +1,94 @@
+/**
+ * BinaryScene.hpp
+ * Binary version of the scene files (see SceneFile.hpp), made to be mapped in
+ * memory and used as it is: loading a scene does not parse nor copy a single
+ * vertex, whatever its size. Every number is little endian:
+ *
+ *   BinarySceneHeader                   at offset 0
+ *   BinarySceneFigure[figureCount]      at figureTableOffset
+ *   Vertex2d[vertexCount]               at vertexArrayOffset, 16 bytes aligned
+ *
+ * Each figure is a range of the vertex array, which holds the vertices just
+ * like Vertex2d does in memory (x, y, z, red, green, blue), so MappedScene
+ * gives them to the rasterizers as a VertexSpan pointing into the file.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef BinaryScene_hpp
+#define BinaryScene_hpp
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include "Vertex2d.hpp"
+#include "VertexSpan.hpp"
+#include "SceneFile.hpp"
+#include "../2D_transformations/Matrix2d.hpp"
+
+#define BINARY_SCENE_VERSION 1
+
+// Flags of BinarySceneFigure
+#define BINARY_SCENE_FILLED 1
+#define BINARY_SCENE_TRANSFORMED 2
+
+struct BinarySceneHeader {
+    char magic[8];
+    uint32_t version;
+    // Written as 0x01020304, to refuse files of the other byte order
+    uint32_t byteOrder;
+    uint32_t width;
+    uint32_t height;
+    float background[3];
+    float window[4];
+    uint32_t figureCount;
+    uint32_t vertexSize;
+    uint32_t reserved;
+    uint64_t figureTableOffset;
+    uint64_t vertexArrayOffset;
+    uint64_t vertexCount;
+};
+
+struct BinarySceneFigure {
+    uint32_t type;
+    uint32_t flags;
+    uint64_t firstVertex;
+    uint32_t vertexCount;
+    int32_t radius;
+    // Of the vertices before the transformation: xMin, yMin, xMax, yMax
+    float bounds[4];
+    // Row by row, only meaningful with BINARY_SCENE_TRANSFORMED
+    float transformation[9];
+};
+
+class BinarySceneFile {
+public:
+    static void write(const Scene& scene, const std::string& path);
+};
+
+class MappedScene {
+public:
+    MappedScene(const std::string& path);
+    ~MappedScene();
+    int getWidth() const;
+    int getHeight() const;
+    Vertex2d getBackground() const;
+    Vertex2d getWindowBottomLeft() const;
+    Vertex2d getWindowTopRight() const;
+    std::size_t getFigureCount() const;
+    const BinarySceneFigure& getFigure(std::size_t index) const;
+    VertexSpan getVertices(std::size_t index) const;
+    Matrix2d getTransformation(std::size_t index) const;
+private:
+    MappedScene(const MappedScene&);
+    MappedScene& operator=(const MappedScene&);
+    
+    std::string path;
+    void *mapping;
+    std::size_t size;
+    const BinarySceneHeader *header;
+    const BinarySceneFigure *figures;
+    const Vertex2d *vertices;
+};
+
+#endif /* BinaryScene_hpp */
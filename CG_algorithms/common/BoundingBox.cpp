@@ -0,0 +1,42 @@
+/**
+ * BoundingBox.cpp
+ * Axis aligned rectangle of pixels, both corners included.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "BoundingBox.hpp"
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Smallest box holding all the points, rounded to pixels like the rasterizers do
+ * @param points {VertexSpan}
+ * @return {BoundingBox} - empty when there are no points
+ */
+BoundingBox BoundingBox::ofPoints(VertexSpan points) {
+    if (points.empty()) {
+        return BoundingBox();
+    }
+    
+    float xMin = points[0].getX(), xMax = xMin;
+    float yMin = points[0].getY(), yMax = yMin;
+    for (const Vertex2d& point : points) {
+        xMin = min(xMin, point.getX());
+        xMax = max(xMax, point.getX());
+        yMin = min(yMin, point.getY());
+        yMax = max(yMax, point.getY());
+    }
+    return BoundingBox::ofExtents(xMin, yMin, xMax, yMax);
+}
+
+/**
+ * Box of pixels holding a rectangle of the plane, rounded outwards
+ * @param xMin {float}, yMin {float} - the bottom left corner
+ * @param xMax {float}, yMax {float} - the top right corner
+ * @return {BoundingBox}
+ */
+BoundingBox BoundingBox::ofExtents(float xMin, float yMin, float xMax, float yMax) {
+    return BoundingBox((int) floorf(xMin), (int) floorf(yMin), (int) ceilf(xMax), (int) ceilf(yMax));
+}
@@ -0,0 +1,125 @@
+/**
+ * BoundingBox.hpp
+ * Axis aligned rectangle of pixels, both corners included. A box whose
+ * minimum is bigger than its maximum is empty.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef BoundingBox_hpp
+#define BoundingBox_hpp
+
+#include <vector>
+#include <algorithm>
+#include "Vertex2d.hpp"
+#include "VertexSpan.hpp"
+
+class BoundingBox {
+public:
+    BoundingBox();
+    BoundingBox(int xMin, int yMin, int xMax, int yMax);
+    static BoundingBox ofPoints(VertexSpan points);
+    static BoundingBox ofExtents(float xMin, float yMin, float xMax, float yMax);
+    int getXMin() const { return this->xMin; }
+    int getYMin() const { return this->yMin; }
+    int getXMax() const { return this->xMax; }
+    int getYMax() const { return this->yMax; }
+    bool isEmpty() const;
+    long getArea() const;
+    bool contains(int x, int y) const;
+    bool intersects(const BoundingBox& other) const;
+    BoundingBox unite(const BoundingBox& other) const;
+    BoundingBox intersect(const BoundingBox& other) const;
+    void expand(int x, int y);
+    bool operator==(const BoundingBox& other) const;
+    bool operator!=(const BoundingBox& other) const;
+private:
+    int xMin;
+    int yMin;
+    int xMax;
+    int yMax;
+};
+
+/**
+ * Constructor of an empty box
+ */
+inline BoundingBox::BoundingBox():xMin(0), yMin(0), xMax(-1), yMax(-1) {}
+
+/**
+ * Constructor of the class
+ * @param _xMin {int}, _yMin {int} - the bottom left corner
+ * @param _xMax {int}, _yMax {int} - the top right corner
+ */
+inline BoundingBox::BoundingBox(int _xMin, int _yMin, int _xMax, int _yMax):
+    xMin(_xMin), yMin(_yMin), xMax(_xMax), yMax(_yMax) {}
+
+inline bool BoundingBox::isEmpty() const {
+    return this->xMin > this->xMax || this->yMin > this->yMax;
+}
+
+/**
+ * Number of pixels in the box
+ * @return {long}
+ */
+inline long BoundingBox::getArea() const {
+    return this->isEmpty() ? 0 : long(this->xMax - this->xMin + 1) * (this->yMax - this->yMin + 1);
+}
+
+inline bool BoundingBox::contains(int x, int y) const {
+    return x >= this->xMin && x <= this->xMax && y >= this->yMin && y <= this->yMax;
+}
+
+inline bool BoundingBox::intersects(const BoundingBox& other) const {
+    return !this->isEmpty() && !other.isEmpty() &&
+           this->xMin <= other.xMax && other.xMin <= this->xMax &&
+           this->yMin <= other.yMax && other.yMin <= this->yMax;
+}
+
+/**
+ * Smallest box holding both boxes
+ * @param other {BoundingBox}
+ * @return {BoundingBox}
+ */
+inline BoundingBox BoundingBox::unite(const BoundingBox& other) const {
+    if (this->isEmpty()) return other;
+    if (other.isEmpty()) return *this;
+    return BoundingBox(std::min(this->xMin, other.xMin), std::min(this->yMin, other.yMin),
+                       std::max(this->xMax, other.xMax), std::max(this->yMax, other.yMax));
+}
+
+/**
+ * Pixels that belong to both boxes
+ * @param other {BoundingBox}
+ * @return {BoundingBox} - empty when they do not intersect
+ */
+inline BoundingBox BoundingBox::intersect(const BoundingBox& other) const {
+    if (!this->intersects(other)) return BoundingBox();
+    return BoundingBox(std::max(this->xMin, other.xMin), std::max(this->yMin, other.yMin),
+                       std::min(this->xMax, other.xMax), std::min(this->yMax, other.yMax));
+}
+
+/**
+ * Grow the box to hold a pixel
+ * @param x {int}, y {int}
+ */
+inline void BoundingBox::expand(int x, int y) {
+    if (this->isEmpty()) {
+        *this = BoundingBox(x, y, x, y);
+        return;
+    }
+    this->xMin = std::min(this->xMin, x);
+    this->yMin = std::min(this->yMin, y);
+    this->xMax = std::max(this->xMax, x);
+    this->yMax = std::max(this->yMax, y);
+}
+
+inline bool BoundingBox::operator==(const BoundingBox& other) const {
+    if (this->isEmpty() || other.isEmpty()) return this->isEmpty() == other.isEmpty();
+    return this->xMin == other.xMin && this->yMin == other.yMin && this->xMax == other.xMax && this->yMax == other.yMax;
+}
+
+inline bool BoundingBox::operator!=(const BoundingBox& other) const {
+    return !(*this == other);
+}
+
+#endif /* BoundingBox_hpp */
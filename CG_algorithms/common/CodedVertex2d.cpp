@@ -8,14 +8,11 @@
 
 #include "CodedVertex2d.hpp"
 
-using namespace std;
-
 /**
  * Constructor of the class
  */
 CodedVertex2d::CodedVertex2d():Vertex2d() {
-    vector<bool> regionCode = {false, false, false, false};
-    this->setRegionCode(regionCode);
+    this->setRegionCode(0);
 }
 
 /**
@@ -25,8 +22,7 @@ CodedVertex2d::CodedVertex2d():Vertex2d() {
  * @param {float z}
  */
 CodedVertex2d::CodedVertex2d(float x, float y, float z):Vertex2d(x, y, z) {
-    vector<bool> regionCode = {false, false, false, false};
-    this->setRegionCode(regionCode);
+    this->setRegionCode(0);
 }
 
 /**
@@ -35,33 +31,46 @@ CodedVertex2d::CodedVertex2d(float x, float y, float z):Vertex2d(x, y, z) {
  * @param {float y}
  */
 CodedVertex2d::CodedVertex2d(float x, float y):Vertex2d(x, y) {
-    vector<bool> regionCode = {false, false, false, false};
-    this->setRegionCode(regionCode);
+    this->setRegionCode(0);
 }
 
 /**
  * Setter for the RegionCode
- * @param _regionCode {vector<bool>}
+ * @param _regionCode {unsigned char} - a combination of RegionBit values
  */
-void CodedVertex2d::setRegionCode(vector<bool> _regionCode) {
+void CodedVertex2d::setRegionCode(unsigned char _regionCode) {
     this->regionCode = _regionCode;
 }
 
 /**
  * Get the RegionCode
- * @return {vector<bool>}
+ * @return {unsigned char} - a combination of RegionBit values
  */
-vector<bool> CodedVertex2d::getRegionCode() {
+unsigned char CodedVertex2d::getRegionCode() const {
     return this->regionCode;
 }
 
+/**
+ * Set or clear one bit of the regionCode
+ * @param regionCode {unsigned char&}
+ * @param bit {RegionBit}
+ * @param state {bool}
+ */
+static inline void setRegionBit(unsigned char& regionCode, CodedVertex2d::RegionBit bit, bool state) {
+    if (state) {
+        regionCode |= bit;
+    } else {
+        regionCode &= ~bit;
+    }
+}
+
 
 /**
  * Setter for the regionCode (top)
  * @param _state {bool}
  */
 void CodedVertex2d::setTopRegionCode(bool _state) {
-    this->regionCode[0] = _state;
+    setRegionBit(this->regionCode, TOP_REGION, _state);
 }
 
 /**
@@ -69,7 +78,7 @@ void CodedVertex2d::setTopRegionCode(bool _state) {
  * @param _state {bool}
  */
 void CodedVertex2d::setBottomRegionCode(bool _state) {
-    this->regionCode[1] = _state;
+    setRegionBit(this->regionCode, BOTTOM_REGION, _state);
 }
 
 /**
@@ -77,7 +86,7 @@ void CodedVertex2d::setBottomRegionCode(bool _state) {
  * @param _state {bool}
  */
 void CodedVertex2d::setRightRegionCode(bool _state) {
-    this->regionCode[2] = _state;
+    setRegionBit(this->regionCode, RIGHT_REGION, _state);
 }
 
 /**
@@ -85,39 +94,39 @@ void CodedVertex2d::setRightRegionCode(bool _state) {
  * @param _state {bool}
  */
 void CodedVertex2d::setLeftRegionCode(bool _state) {
-    this->regionCode[3] = _state;
+    setRegionBit(this->regionCode, LEFT_REGION, _state);
 }
 
 /**
  * Get the regionCode (top)
  * @return {bool}
  */
-bool CodedVertex2d::getTopRegionCode() {
-    return this->regionCode[0];
+bool CodedVertex2d::getTopRegionCode() const {
+    return (this->regionCode & TOP_REGION) != 0;
 }
 
 /**
  * Get the regionCode (bottom)
  * @return {bool}
  */
-bool CodedVertex2d::getBottomRegionCode() {
-    return this->regionCode[1];
+bool CodedVertex2d::getBottomRegionCode() const {
+    return (this->regionCode & BOTTOM_REGION) != 0;
 }
 
 /**
  * Get the regionCode (right)
  * @return {bool}
  */
-bool CodedVertex2d::getRightRegionCode() {
-    return this->regionCode[2];
+bool CodedVertex2d::getRightRegionCode() const {
+    return (this->regionCode & RIGHT_REGION) != 0;
 }
 
 /**
  * Get the regionCode (left)
  * @return {bool}
  */
-bool CodedVertex2d::getLeftRegionCode() {
-    return this->regionCode[3];
+bool CodedVertex2d::getLeftRegionCode() const {
+    return (this->regionCode & LEFT_REGION) != 0;
 }
 
 /**
@@ -125,6 +134,6 @@ bool CodedVertex2d::getLeftRegionCode() {
  * @param index {int}
  * @return {bool} the region code for the specified index 
  */
-bool CodedVertex2d::getRegionCodeByIndex(int index) {
-    return this->regionCode[index];
+bool CodedVertex2d::getRegionCodeByIndex(int index) const {
+    return (this->regionCode & (1 << index)) != 0;
 }
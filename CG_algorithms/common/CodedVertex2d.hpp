@@ -10,25 +10,31 @@
 #define CodedVertex2d_hpp
 
 #include "Vertex2d.hpp"
-#include <vector>
 
 class CodedVertex2d : public Vertex2d {
 private:
-    std::vector<bool> regionCode;
+    // One bit per region, see RegionBit
+    unsigned char regionCode;
 public:
+    enum RegionBit {
+        TOP_REGION = 1,
+        BOTTOM_REGION = 2,
+        RIGHT_REGION = 4,
+        LEFT_REGION = 8
+    };
     CodedVertex2d();
     CodedVertex2d(float x, float y, float z);
     CodedVertex2d(float x, float y);
-    void setRegionCode(std::vector<bool> _regionCode);
-    std::vector<bool> getRegionCode();
+    void setRegionCode(unsigned char _regionCode);
+    unsigned char getRegionCode() const;
     void setTopRegionCode(bool _state);
     void setBottomRegionCode(bool _state);
     void setRightRegionCode(bool _state);
     void setLeftRegionCode(bool _state);
-    bool getTopRegionCode();
-    bool getBottomRegionCode();
-    bool getRightRegionCode();
-    bool getLeftRegionCode();
-    bool getRegionCodeByIndex(int index);
+    bool getTopRegionCode() const;
+    bool getBottomRegionCode() const;
+    bool getRightRegionCode() const;
+    bool getLeftRegionCode() const;
+    bool getRegionCodeByIndex(int index) const;
 };
 #endif /* CodedVertex2d_hpp */
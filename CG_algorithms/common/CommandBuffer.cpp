@@ -0,0 +1,225 @@
+/**
+ * CommandBuffer.cpp
+ * Class that records the scene of a frame as a list of commands.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "CommandBuffer.hpp"
+#include "PixelSink.hpp"
+#include "Trace.hpp"
+#include "../2D_transformations/Matrix2d.hpp"
+#include "../2D_transformations/TransformationMatrix.hpp"
+#include "../lines/Line.hpp"
+#include "../lines/Circumference.hpp"
+#include "../polygons/Polygon.hpp"
+#include <stdexcept>
+
+using namespace std;
+
+CommandBuffer::CommandBuffer() {}
+
+/**
+ * Forget the recorded commands, keeping the memory for the next frame
+ */
+void CommandBuffer::clear() {
+    this->commands.clear();
+    this->vertices.clear();
+}
+
+bool CommandBuffer::isEmpty() const {
+    return this->commands.empty();
+}
+
+/**
+ * Getter for the recorded commands
+ * @return {const vector<RenderCommand>&}
+ */
+const vector<RenderCommand>& CommandBuffer::getCommands() const {
+    return this->commands;
+}
+
+/**
+ * Append a command without vertices and arguments
+ * @param type {RenderCommandType}
+ * @return {RenderCommand&} - the new command
+ */
+RenderCommand& CommandBuffer::addCommand(RenderCommandType type) {
+    RenderCommand command;
+    command.type = type;
+    command.firstVertex = (unsigned int) this->vertices.size();
+    command.vertexCount = 0;
+    command.arguments[0] = command.arguments[1] = command.arguments[2] = command.arguments[3] = 0.0f;
+    command.filled = false;
+    this->commands.push_back(command);
+    return this->commands.back();
+}
+
+/**
+ * Record the clear of the whole framebuffer
+ * @param red {float}, green {float}, blue {float}
+ */
+void CommandBuffer::recordClear(float red, float green, float blue) {
+    RenderCommand& command = this->addCommand(COMMAND_CLEAR);
+    command.arguments[0] = red;
+    command.arguments[1] = green;
+    command.arguments[2] = blue;
+}
+
+/**
+ * Record a translation. The transformations apply, in the order they were
+ * recorded, to the next figure only.
+ * @param dx {float}, dy {float}
+ */
+void CommandBuffer::recordTranslate(float dx, float dy) {
+    RenderCommand& command = this->addCommand(COMMAND_TRANSLATE);
+    command.arguments[0] = dx;
+    command.arguments[1] = dy;
+}
+
+/**
+ * Record a rotation of the next figure
+ * @param angle {float} - in degrees
+ * @param xPivot {float}, yPivot {float}
+ */
+void CommandBuffer::recordRotate(float angle, float xPivot, float yPivot) {
+    RenderCommand& command = this->addCommand(COMMAND_ROTATE);
+    command.arguments[0] = angle;
+    command.arguments[1] = xPivot;
+    command.arguments[2] = yPivot;
+}
+
+/**
+ * Record a scale of the next figure
+ * @param xFactor {float}, yFactor {float}
+ * @param xPivot {float}, yPivot {float}
+ */
+void CommandBuffer::recordScale(float xFactor, float yFactor, float xPivot, float yPivot) {
+    RenderCommand& command = this->addCommand(COMMAND_SCALE);
+    command.arguments[0] = xFactor;
+    command.arguments[1] = yFactor;
+    command.arguments[2] = xPivot;
+    command.arguments[3] = yPivot;
+}
+
+/**
+ * Record a line, drawn with Bresenham in the color of each end
+ * @param initialPoint {Vertex2d}
+ * @param finalPoint {Vertex2d}
+ */
+void CommandBuffer::recordLine(const Vertex2d& initialPoint, const Vertex2d& finalPoint) {
+    RenderCommand& command = this->addCommand(COMMAND_LINE);
+    command.vertexCount = 2;
+    this->vertices.push_back(initialPoint);
+    this->vertices.push_back(finalPoint);
+}
+
+/**
+ * Record a polygon. The vertices are copied into the buffer.
+ * @param vertices {VertexSpan}
+ * @param filled {bool}
+ */
+void CommandBuffer::recordPolygon(VertexSpan vertices, bool filled) {
+    if (vertices.size() < 3) {
+        throw invalid_argument("A polygon must have at least three vertices");
+    }
+    
+    RenderCommand& command = this->addCommand(COMMAND_POLYGON);
+    command.vertexCount = (unsigned int) vertices.size();
+    command.filled = filled;
+    this->vertices.insert(this->vertices.end(), vertices.begin(), vertices.end());
+}
+
+/**
+ * Record a circumference, drawn in the color of its center
+ * @param center {Vertex2d}
+ * @param radius {int}
+ */
+void CommandBuffer::recordCircumference(const Vertex2d& center, int radius) {
+    RenderCommand& command = this->addCommand(COMMAND_CIRCUMFERENCE);
+    command.vertexCount = 1;
+    command.arguments[0] = (float) radius;
+    this->vertices.push_back(center);
+}
+
+/**
+ * Copy the vertices of a command into the transformed buffer, applying
+ * the transformation commands between firstTransform and lastTransform
+ * @param firstTransform {size_t}, lastTransform {size_t} - command indexes, last one excluded
+ * @param firstVertex {size_t}, count {size_t} - range in the vertex pool
+ */
+void CommandBuffer::transformVertices(size_t firstTransform, size_t lastTransform, size_t firstVertex, size_t count) {
+    TransformationMatrix *transformations = TransformationMatrix::getInstance();
+    this->transformed.assign(this->vertices.begin() + firstVertex, this->vertices.begin() + firstVertex + count);
+    
+    for (size_t i = firstTransform; i < lastTransform; i++) {
+        const RenderCommand& command = this->commands[i];
+        Matrix2d matrix;
+    
+        switch (command.type) {
+            case COMMAND_TRANSLATE:
+                matrix = transformations->getTranslationMatrix(command.arguments[0], command.arguments[1]);
+                break;
+            case COMMAND_ROTATE:
+                matrix = transformations->getRotationMatrix(command.arguments[0], command.arguments[1], command.arguments[2]);
+                break;
+            case COMMAND_SCALE:
+                matrix = transformations->getScaleMatrix(command.arguments[0], command.arguments[1], command.arguments[2], command.arguments[3]);
+                break;
+            default:
+                continue;
+        }
+    
+        for (Vertex2d& vertice : this->transformed) {
+            Vertex2d newVertice = matrix * vertice;
+            newVertice.setRGBColors(vertice.getRed(), vertice.getGreen(), vertice.getBlue());
+            vertice = newVertice;
+        }
+    }
+}
+
+/**
+ * Rasterize the recorded commands into a framebuffer, in order
+ * @param framebuffer {Framebuffer&}
+ */
+void CommandBuffer::execute(Framebuffer& framebuffer) {
+    CG_TRACE_SPAN("execute", NO_FIGURE, (unsigned int) this->commands.size());
+    FramebufferPixelSink sink(framebuffer);
+    // The transformations waiting for the next figure
+    size_t firstTransform = 0;
+    
+    for (size_t i = 0; i < this->commands.size(); i++) {
+        const RenderCommand& command = this->commands[i];
+    
+        if (command.type == COMMAND_TRANSLATE || command.type == COMMAND_ROTATE || command.type == COMMAND_SCALE) {
+            continue;
+        }
+    
+        if (command.type == COMMAND_CLEAR) {
+            framebuffer.clear(command.arguments[0], command.arguments[1], command.arguments[2]);
+            firstTransform = i + 1;
+            continue;
+        }
+    
+        this->transformVertices(firstTransform, i, command.firstVertex, command.vertexCount);
+        firstTransform = i + 1;
+    
+        switch (command.type) {
+            case COMMAND_LINE:
+                Line::rasterizeLineBresenham(this->transformed[0], this->transformed[1], sink);
+                break;
+            case COMMAND_POLYGON:
+                if (command.filled) {
+                    Polygon::rasterizeFilledPolygon(this->transformed, sink);
+                } else {
+                    Polygon::rasterizeNotFilledPolygon(this->transformed, sink);
+                }
+                break;
+            case COMMAND_CIRCUMFERENCE:
+                Circumference::rasterizeCircumferenceBresenham(this->transformed[0], (int) command.arguments[0], sink);
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * CommandBuffer.hpp
+ * Class that records the scene of a frame as a list of commands, so it can be
+ * built on one thread and rasterized on another (see RenderThread.hpp).
+ * The vertices of every command live in a single pool owned by the buffer,
+ * and both vectors keep their capacity when the buffer is cleared, so a
+ * recycled buffer records a frame without allocating.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef CommandBuffer_hpp
+#define CommandBuffer_hpp
+
+#include <vector>
+#include "Vertex2d.hpp"
+#include "VertexSpan.hpp"
+#include "Framebuffer.hpp"
+
+enum RenderCommandType {COMMAND_CLEAR, COMMAND_TRANSLATE, COMMAND_ROTATE, COMMAND_SCALE,
+    COMMAND_LINE, COMMAND_POLYGON, COMMAND_CIRCUMFERENCE};
+
+struct RenderCommand {
+    RenderCommandType type;
+    // Range of the command vertices in the pool of the buffer
+    unsigned int firstVertex;
+    unsigned int vertexCount;
+    // Meaning depends on the type: the clear color, the transformation
+    // arguments or the radius of a circumference
+    float arguments[4];
+    bool filled;
+};
+
+class CommandBuffer {
+public:
+    CommandBuffer();
+    void clear();
+    bool isEmpty() const;
+    const std::vector<RenderCommand>& getCommands() const;
+    void recordClear(float red, float green, float blue);
+    void recordTranslate(float dx, float dy);
+    void recordRotate(float angle, float xPivot, float yPivot);
+    void recordScale(float xFactor, float yFactor, float xPivot, float yPivot);
+    void recordLine(const Vertex2d& initialPoint, const Vertex2d& finalPoint);
+    void recordPolygon(VertexSpan vertices, bool filled);
+    void recordCircumference(const Vertex2d& center, int radius);
+    void execute(Framebuffer& framebuffer);
+private:
+    RenderCommand& addCommand(RenderCommandType type);
+    void transformVertices(std::size_t firstTransform, std::size_t lastTransform, std::size_t firstVertex, std::size_t count);
+    std::vector<RenderCommand> commands;
+    std::vector<Vertex2d> vertices;
+    // Transformed copy of the vertices being drawn
+    std::vector<Vertex2d> transformed;
+};
+
+#endif /* CommandBuffer_hpp */
@@ -0,0 +1,124 @@
+/**
+ * DirtyRegionTracker.cpp
+ * Keeps the regions of the screen that changed since the last redraw.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "DirtyRegionTracker.hpp"
+#include <stdexcept>
+
+using namespace std;
+
+// Above this fraction of the screen, redrawing everything is cheaper than the regions
+#define FULL_REDRAW_FRACTION 0.5
+
+/**
+ * Constructor of the class. The whole screen starts dirty.
+ * @param width {int}
+ * @param height {int}
+ */
+DirtyRegionTracker::DirtyRegionTracker(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("The screen must have a positive size");
+    }
+    this->screen = BoundingBox(0, 0, width - 1, height - 1);
+    this->invalidateAll();
+}
+
+/**
+ * A figure moved or changed: both where it was and where it is now must be redrawn
+ * @param figureId {int}
+ * @param box {BoundingBox} - the new bounding box of the figure
+ */
+void DirtyRegionTracker::update(int figureId, const BoundingBox& box) {
+    BoundingBox& oldBox = this->boxes[figureId];
+    this->invalidate(oldBox.unite(box));
+    oldBox = box;
+}
+
+/**
+ * A figure left the scene: where it was must be redrawn
+ * @param figureId {int}
+ */
+void DirtyRegionTracker::remove(int figureId) {
+    auto it = this->boxes.find(figureId);
+    if (it != this->boxes.end()) {
+        this->invalidate(it->second);
+        this->boxes.erase(it);
+    }
+}
+
+/**
+ * Mark a region as dirty, merging it with the dirty regions it overlaps
+ * @param box {BoundingBox}
+ */
+void DirtyRegionTracker::invalidate(const BoundingBox& box) {
+    BoundingBox region = box.intersect(this->screen);
+    if (region.isEmpty()) {
+        return;
+    }
+    
+    // Merging can make the region reach others, so repeat until nothing overlaps
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < this->dirtyRegions.size(); i++) {
+            if (this->dirtyRegions[i].intersects(region)) {
+                region = region.unite(this->dirtyRegions[i]);
+                this->dirtyRegions[i] = this->dirtyRegions.back();
+                this->dirtyRegions.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    this->dirtyRegions.push_back(region);
+    
+    long dirtyArea = 0;
+    for (const BoundingBox& dirtyRegion : this->dirtyRegions) {
+        dirtyArea += dirtyRegion.getArea();
+    }
+    if (dirtyArea > FULL_REDRAW_FRACTION * this->screen.getArea()) {
+        this->invalidateAll();
+    }
+}
+
+/**
+ * Mark the whole screen as dirty
+ */
+void DirtyRegionTracker::invalidateAll() {
+    this->dirtyRegions.assign(1, this->screen);
+}
+
+/**
+ * Getter for the last bounding box of a figure
+ * @param figureId {int}
+ * @return {const BoundingBox&}
+ */
+const BoundingBox& DirtyRegionTracker::getBox(int figureId) const {
+    auto it = this->boxes.find(figureId);
+    if (it == this->boxes.end()) {
+        throw invalid_argument("Unknown figure");
+    }
+    return it->second;
+}
+
+/**
+ * Getter for the dirty regions, which never overlap
+ * @return {const vector<BoundingBox>&}
+ */
+const vector<BoundingBox>& DirtyRegionTracker::getDirtyRegions() const {
+    return this->dirtyRegions;
+}
+
+bool DirtyRegionTracker::isDirty() const {
+    return !this->dirtyRegions.empty();
+}
+
+/**
+ * Forget the dirty regions, after they are redrawn
+ */
+void DirtyRegionTracker::clear() {
+    this->dirtyRegions.clear();
+}
@@ -0,0 +1,35 @@
+/**
+ * DirtyRegionTracker.hpp
+ * Keeps the regions of the screen that changed since the last redraw. Every
+ * time a figure moves or changes, the union of its old and new bounding boxes
+ * becomes dirty. Overlapping regions are merged, and when they cover most of
+ * the screen the whole screen is redrawn instead.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef DirtyRegionTracker_hpp
+#define DirtyRegionTracker_hpp
+
+#include <map>
+#include <vector>
+#include "BoundingBox.hpp"
+
+class DirtyRegionTracker {
+public:
+    DirtyRegionTracker(int width, int height);
+    void update(int figureId, const BoundingBox& box);
+    void remove(int figureId);
+    void invalidate(const BoundingBox& box);
+    void invalidateAll();
+    const BoundingBox& getBox(int figureId) const;
+    const std::vector<BoundingBox>& getDirtyRegions() const;
+    bool isDirty() const;
+    void clear();
+private:
+    BoundingBox screen;
+    std::map<int, BoundingBox> boxes;
+    std::vector<BoundingBox> dirtyRegions;
+};
+
+#endif /* DirtyRegionTracker_hpp */
@@ -0,0 +1,174 @@
+/**
+ * FrameArena.cpp
+ * Bump allocator for the transient data of a frame (or of a batch of work).
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "FrameArena.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+
+// Global static pointer used to ensure a single instance of the frame arena
+FrameArena* FrameArena::instance = NULL;
+
+// The arena of the innermost Scope alive in each thread
+static thread_local FrameArena *currentArena = NULL;
+
+/**
+ * Constructor of the class. No memory is taken until the first allocation.
+ * @param blockSize {size_t} - size of each block asked to the heap
+ */
+FrameArena::FrameArena(size_t blockSize):firstBlock(NULL), currentBlock(NULL), offset(0),
+    bytesUsed(0), highWaterMark(0), capacity(0) {
+    if (blockSize == 0) {
+        throw invalid_argument("The block size of the arena must be positive");
+    }
+    this->blockSize = blockSize;
+}
+
+/**
+ * Destructor. Gives all the blocks back to the heap.
+ */
+FrameArena::~FrameArena() {
+    Block *block = this->firstBlock;
+    while (block) {
+        Block *next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+}
+
+/**
+ * The arena used by the display loop, reset once per frame
+ * @return {FrameArena*}
+ */
+FrameArena* FrameArena::getInstance() {
+    if ( !instance ) {
+        instance = new FrameArena();
+    }
+    return instance;
+}
+
+/**
+ * The arena of the innermost Scope alive in this thread
+ * @return {FrameArena*} - NULL when there is no Scope
+ */
+FrameArena* FrameArena::getCurrent() {
+    return currentArena;
+}
+
+/**
+ * Slow path of allocate: move on to the next block, reusing the blocks
+ * kept from earlier frames, or ask the heap for a new one
+ * @param bytes {size_t}
+ * @param alignment {size_t}
+ * @return {void*}
+ */
+void* FrameArena::allocateFromNextBlock(size_t bytes, size_t alignment) {
+    Block *next = this->currentBlock ? this->currentBlock->next : this->firstBlock;
+    
+    // Blocks kept from earlier frames that are too small are given back
+    while (next && next->size < bytes + alignment) {
+        Block *tooSmall = next;
+        next = next->next;
+        this->capacity -= tooSmall->size;
+        ::operator delete(tooSmall);
+    }
+    
+    if (!next) {
+        size_t size = max(this->blockSize, bytes + alignment);
+        next = static_cast<Block*>(::operator new(sizeof(Block) + size));
+        next->next = NULL;
+        next->size = size;
+        this->capacity += size;
+    }
+    
+    // Link the block after the current one
+    if (this->currentBlock) {
+        this->currentBlock->next = next;
+    } else {
+        this->firstBlock = next;
+    }
+    
+    // The bytes left in the previous block count as used until it is reset
+    if (this->currentBlock) {
+        this->bytesUsed += this->currentBlock->size - this->offset;
+    }
+    this->currentBlock = next;
+    this->offset = 0;
+    return this->allocate(bytes, alignment);
+}
+
+/**
+ * Give back everything allocated from the arena, keeping its blocks
+ */
+void FrameArena::reset() {
+    this->currentBlock = NULL;
+    this->offset = 0;
+    this->bytesUsed = 0;
+}
+
+/**
+ * Current position of the arena
+ * @return {Marker}
+ */
+FrameArena::Marker FrameArena::mark() const {
+    Marker marker;
+    marker.block = this->currentBlock;
+    marker.offset = this->offset;
+    marker.bytesUsed = this->bytesUsed;
+    return marker;
+}
+
+/**
+ * Give back everything allocated after the marker was taken
+ * @param marker {Marker}
+ */
+void FrameArena::rewind(const Marker& marker) {
+    this->currentBlock = marker.block;
+    this->offset = marker.offset;
+    this->bytesUsed = marker.bytesUsed;
+}
+
+/**
+ * Getter for the bytes in use, counting alignment padding
+ * @return {size_t}
+ */
+size_t FrameArena::getBytesUsed() const {
+    return this->bytesUsed;
+}
+
+/**
+ * Getter for the most bytes ever in use at once
+ * @return {size_t}
+ */
+size_t FrameArena::getHighWaterMark() const {
+    return this->highWaterMark;
+}
+
+/**
+ * Getter for the bytes taken from the heap
+ * @return {size_t}
+ */
+size_t FrameArena::getCapacity() const {
+    return this->capacity;
+}
+
+/**
+ * Constructor of the scope
+ * @param arena {FrameArena&}
+ */
+FrameArena::Scope::Scope(FrameArena& _arena):arena(_arena), previous(currentArena), marker(_arena.mark()) {
+    currentArena = &_arena;
+}
+
+/**
+ * Destructor of the scope. Rewinds the arena and restores the previous one.
+ */
+FrameArena::Scope::~Scope() {
+    this->arena.rewind(this->marker);
+    currentArena = this->previous;
+}
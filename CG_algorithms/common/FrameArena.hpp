@@ -0,0 +1,162 @@
+/**
+ * FrameArena.hpp
+ * Bump allocator for the transient data of a frame (or of a batch of work):
+ * edges tables, active edges... Allocating is a pointer increment, freeing
+ * a single object does nothing and reset() releases everything at once in
+ * O(1). The memory blocks are kept between frames, so after the first frames
+ * the arena stops asking the heap for memory.
+ * It is not thread safe: each thread must use its own arena.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef FrameArena_hpp
+#define FrameArena_hpp
+
+#include <cstddef>
+#include <new>
+
+class FrameArena {
+private:
+    struct Block {
+        Block *next;
+        std::size_t size;
+    };
+public:
+    // Position of the arena, used to give back everything allocated after it
+    struct Marker {
+        Block *block;
+        std::size_t offset;
+        std::size_t bytesUsed;
+    };
+    
+    // Makes an arena the current one of the thread while it lives; on
+    // destruction, gives back everything allocated from it in the meantime
+    class Scope {
+    public:
+        Scope(FrameArena& arena);
+        ~Scope();
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        FrameArena& arena;
+        FrameArena *previous;
+        Marker marker;
+    };
+    
+    FrameArena(std::size_t blockSize = 64 * 1024);
+    ~FrameArena();
+    static FrameArena* getInstance();
+    static FrameArena* getCurrent();
+    void* allocate(std::size_t bytes, std::size_t alignment);
+    void reset();
+    Marker mark() const;
+    void rewind(const Marker& marker);
+    std::size_t getBytesUsed() const;
+    std::size_t getHighWaterMark() const;
+    std::size_t getCapacity() const;
+private:
+    FrameArena(const FrameArena&);
+    FrameArena& operator=(const FrameArena&);
+    void* allocateFromNextBlock(std::size_t bytes, std::size_t alignment);
+    static char* blockData(Block *block);
+    
+    Block *firstBlock;
+    Block *currentBlock;
+    std::size_t offset;
+    std::size_t blockSize;
+    std::size_t bytesUsed;
+    std::size_t highWaterMark;
+    std::size_t capacity;
+    static FrameArena *instance;
+};
+
+/**
+ * Allocate bytes from the arena
+ * @param bytes {size_t}
+ * @param alignment {size_t} - must be a power of two
+ * @return {void*}
+ */
+inline void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    if (this->currentBlock) {
+        std::size_t start = (this->offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= this->currentBlock->size) {
+            this->bytesUsed += start + bytes - this->offset;
+            this->offset = start + bytes;
+            if (this->bytesUsed > this->highWaterMark) {
+                this->highWaterMark = this->bytesUsed;
+            }
+            return blockData(this->currentBlock) + start;
+        }
+    }
+    return this->allocateFromNextBlock(bytes, alignment);
+}
+
+/**
+ * Where the memory of a block starts, right after its header
+ * @param block {Block*}
+ * @return {char*}
+ */
+inline char* FrameArena::blockData(Block *block) {
+    return reinterpret_cast<char*>(block) + sizeof(Block);
+}
+
+/**
+ * Standard allocator that takes its memory from a FrameArena, so the
+ * containers of the library can live in it. Without an arena it falls back
+ * to the heap, which allows the same container types to outlive a frame.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+    
+    ArenaAllocator():arena(NULL) {}
+    explicit ArenaAllocator(FrameArena *_arena):arena(_arena) {}
+    
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other):arena(other.getArena()) {}
+    
+    T* allocate(std::size_t count) {
+        if (this->arena) {
+            return static_cast<T*>(this->arena->allocate(count * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+    
+    // Memory from the arena is only given back on reset
+    void deallocate(T *pointer, std::size_t) {
+        if (!this->arena) {
+            ::operator delete(pointer);
+        }
+    }
+    
+    FrameArena* getArena() const {
+        return this->arena;
+    }
+private:
+    FrameArena *arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() != b.getArena();
+}
+
+#endif /* FrameArena_hpp */
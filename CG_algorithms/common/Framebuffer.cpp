@@ -0,0 +1,101 @@
+/**
+ * Framebuffer.cpp
+ * Class that represents a retained RGB image where the rasterizers can draw
+ * directly. The row 0 is the bottom of the screen, like in OpenGL.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Framebuffer.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include "Trace.hpp"
+#include "OpenGL/gl.h"
+
+using namespace std;
+
+/**
+ * Constructor of the class. The buffer starts black.
+ * @param width {int}
+ * @param height {int}
+ */
+Framebuffer::Framebuffer(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("A framebuffer must have a positive size");
+    }
+    
+    this->width = width;
+    this->height = height;
+    this->pixels.assign(3 * width * height, 0);
+}
+
+/**
+ * Getter for the width
+ * @return {int}
+ */
+int Framebuffer::getWidth() const {
+    return this->width;
+}
+
+/**
+ * Getter for the height
+ * @return {int}
+ */
+int Framebuffer::getHeight() const {
+    return this->height;
+}
+
+/**
+ * Getter for the raw pixels (RGB, row 0 at the bottom)
+ * @return {const unsigned char*}
+ */
+const unsigned char* Framebuffer::getPixels() const {
+    return this->pixels.data();
+}
+
+/**
+ * Fill the whole buffer with a color
+ * @param red {float}, green {float}, blue {float}
+ */
+void Framebuffer::clear(float red, float green, float blue) {
+    // A gray has the same byte in every channel, so the buffer is set at once
+    if (toByte(red) == toByte(green) && toByte(green) == toByte(blue)) {
+        fill(this->pixels.begin(), this->pixels.end(), toByte(red));
+        return;
+    }
+    
+    // Otherwise the first row is filled pixel by pixel and copied to the others
+    Vertex2d color;
+    color.setRGBColors(red, green, blue);
+    this->fillSpan(0, this->width - 1, 0, color);
+    size_t rowSize = 3 * (size_t) this->width;
+    for (int y = 1; y < this->height; y++) {
+        copy(this->pixels.begin(), this->pixels.begin() + rowSize, this->pixels.begin() + y * rowSize);
+    }
+}
+
+/**
+ * Fill a region of the buffer with a color. The region is clipped against the buffer limits.
+ * @param region {BoundingBox}
+ * @param red {float}, green {float}, blue {float}
+ */
+void Framebuffer::clearRegion(const BoundingBox& region, float red, float green, float blue) {
+    Vertex2d color;
+    color.setRGBColors(red, green, blue);
+    int yMin = max(region.getYMin(), 0);
+    int yMax = min(region.getYMax(), this->height - 1);
+    for (int y = yMin; y <= yMax; y++) {
+        this->fillSpan(region.getXMin(), region.getXMax(), y, color);
+    }
+}
+
+/**
+ * Draw the buffer on the screen, using OpenGL library.
+ * The raster position is the bottom left corner of the window.
+ */
+void Framebuffer::present() const {
+    CG_TRACE_SPAN("present");
+    glRasterPos2i(0, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glDrawPixels(this->width, this->height, GL_RGB, GL_UNSIGNED_BYTE, this->pixels.data());
+}
@@ -0,0 +1,108 @@
+/**
+ * Framebuffer.hpp
+ * Class that represents a retained RGB image where the rasterizers can draw
+ * directly. The row 0 is the bottom of the screen, like in OpenGL.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Framebuffer_hpp
+#define Framebuffer_hpp
+
+#include <vector>
+#include "Vertex2d.hpp"
+#include "BoundingBox.hpp"
+
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+    int getWidth() const;
+    int getHeight() const;
+    const unsigned char* getPixels() const;
+    void clear(float red, float green, float blue);
+    void clearRegion(const BoundingBox& region, float red, float green, float blue);
+    void setPixel(int x, int y, const Vertex2d& color);
+    void fillSpan(int xStart, int xEnd, int y, const Vertex2d& color);
+    void blendPixel(int x, int y, const Vertex2d& color, float coverage);
+    void present() const;
+private:
+    static unsigned char toByte(float);
+    int width;
+    int height;
+    // RGB, 3 bytes per pixel, row by row
+    std::vector<unsigned char> pixels;
+};
+
+/**
+ * Convert a color channel in [0, 1] to a byte
+ * @param value {float}
+ * @return {unsigned char}
+ */
+inline unsigned char Framebuffer::toByte(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return 255;
+    return (unsigned char) (value * 255.0f + 0.5f);
+}
+
+/**
+ * Set the color of a single pixel. Pixels outside the buffer are ignored.
+ * @param x {int}, y {int}
+ * @param color {Vertex2d} - only the colors of the vertex are used
+ */
+inline void Framebuffer::setPixel(int x, int y, const Vertex2d& color) {
+    if (x < 0 || y < 0 || x >= this->width || y >= this->height) {
+        return;
+    }
+    unsigned char *pixel = &this->pixels[3 * (y * this->width + x)];
+    pixel[0] = toByte(color.getRed());
+    pixel[1] = toByte(color.getGreen());
+    pixel[2] = toByte(color.getBlue());
+}
+
+/**
+ * Set the color of a horizontal span of pixels, both ends included.
+ * The span is clipped against the buffer limits.
+ * @param xStart {int}, xEnd {int}, y {int}
+ * @param color {Vertex2d} - only the colors of the vertex are used
+ */
+inline void Framebuffer::fillSpan(int xStart, int xEnd, int y, const Vertex2d& color) {
+    if (y < 0 || y >= this->height) {
+        return;
+    }
+    if (xStart < 0) xStart = 0;
+    if (xEnd >= this->width) xEnd = this->width - 1;
+    if (xStart > xEnd) {
+        return;
+    }
+    
+    unsigned char red = toByte(color.getRed());
+    unsigned char green = toByte(color.getGreen());
+    unsigned char blue = toByte(color.getBlue());
+    unsigned char *pixel = &this->pixels[3 * (y * this->width + xStart)];
+    
+    for (; xStart <= xEnd; xStart++, pixel += 3) {
+        pixel[0] = red;
+        pixel[1] = green;
+        pixel[2] = blue;
+    }
+}
+
+/**
+ * Mix the color of a pixel with the color of a figure that covers only part
+ * of it, in proportion to the covered area. Pixels outside the buffer are ignored.
+ * @param x {int}, y {int}
+ * @param color {Vertex2d} - only the colors of the vertex are used
+ * @param coverage {float} - fraction of the pixel covered, in [0, 1]
+ */
+inline void Framebuffer::blendPixel(int x, int y, const Vertex2d& color, float coverage) {
+    if (x < 0 || y < 0 || x >= this->width || y >= this->height) {
+        return;
+    }
+    unsigned char *pixel = &this->pixels[3 * (y * this->width + x)];
+    float remaining = 1.0f - coverage;
+    pixel[0] = toByte(color.getRed() * coverage + pixel[0] * remaining / 255.0f);
+    pixel[1] = toByte(color.getGreen() * coverage + pixel[1] * remaining / 255.0f);
+    pixel[2] = toByte(color.getBlue() * coverage + pixel[2] * remaining / 255.0f);
+}
+
+#endif /* Framebuffer_hpp */
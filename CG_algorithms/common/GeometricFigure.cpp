@@ -7,31 +7,41 @@
 
 #include "GeometricFigure.hpp"
 #include "../common/Vertex2d.hpp"
+#include "Trace.hpp"
 #include "OpenGL/gl.h"
 
 using namespace std;
 
 /**
- * Gets the points that forms the geometric figure
- * @return points {vector<int>}
+ * Gets the points that forms the geometric figure, without copying them
+ * @return points {const vector<Vertex2d>&}
  */
-vector<Vertex2d> GeometricFigure::getPoints() const {
+const vector<Vertex2d>& GeometricFigure::getPoints() const {
     return this->points;
 }
 
 /**
  * Sets the points that will form the geometric figure
- * @param newPoints {vector<int>} the new figure points
+ * @param newPoints {vector<Vertex2d>} the new figure points
  */
-void GeometricFigure::setPoints(vector<Vertex2d> newPoints) {
+void GeometricFigure::setPoints(const vector<Vertex2d>& newPoints) {
     this->points = newPoints;
 }
 
+/**
+ * Sets the points that will form the geometric figure, taking over
+ * the storage of the given vector
+ * @param newPoints {vector<Vertex2d>&&} the new figure points
+ */
+void GeometricFigure::setPoints(vector<Vertex2d>&& newPoints) {
+    this->points = std::move(newPoints);
+}
+
 /**
  * Add a new point to the geometric figure
  * @param newPoint {Vertex2d}
  */
-void GeometricFigure::addPoint(Vertex2d newPoint) {
+void GeometricFigure::addPoint(const Vertex2d& newPoint) {
     this->points.push_back(newPoint);
 }
 
@@ -40,9 +50,10 @@ void GeometricFigure::addPoint(Vertex2d newPoint) {
  * using OpenGL library
  */
 void GeometricFigure::plotPoints() {
+    CG_TRACE_SPAN("plot", this->type, this->points.size());
     glBegin(GL_POINTS);
     
-    for (Vertex2d point : this->getPoints()) {
+    for (const Vertex2d& point : this->points) {
         glColor3f(point.getRed(), point.getGreen(), point.getBlue());
         glVertex3i(point.getX(), point.getY(), point.getZ() - 1);
     }
@@ -62,6 +73,23 @@ void GeometricFigure::setType(GeometricFigureType _type) {
  * Get the type of the GeometricFigure
  * @return type {GeometricFigureType}
  */
-GeometricFigureType GeometricFigure::getType() {
+GeometricFigureType GeometricFigure::getType() const {
     return this->type;
 }
+
+/**
+ * Get the bounding box of the figure, without walking its points. Every
+ * pixel the figure rasterizes to is inside it.
+ * @return {const BoundingBox&}
+ */
+const BoundingBox& GeometricFigure::getBoundingBox() const {
+    return this->boundingBox;
+}
+
+/**
+ * Set the bounding box of a figure made only of points
+ * @param box {BoundingBox}
+ */
+void GeometricFigure::setBoundingBox(const BoundingBox& box) {
+    this->boundingBox = box;
+}
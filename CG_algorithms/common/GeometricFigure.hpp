@@ -10,20 +10,27 @@
 
 #include <vector>
 #include "../common/Vertex2d.hpp"
+#include "BoundingBox.hpp"
 
 enum GeometricFigureType {LINE, POLYGON, CIRCUMFERENCE };
 
 class GeometricFigure {
 public:
-    std::vector<Vertex2d> getPoints() const;
-    void setPoints(std::vector<Vertex2d>);
-    void addPoint(Vertex2d);
+    const std::vector<Vertex2d>& getPoints() const;
+    void setPoints(const std::vector<Vertex2d>&);
+    void setPoints(std::vector<Vertex2d>&&);
+    void addPoint(const Vertex2d&);
     void plotPoints();
     void setType(GeometricFigureType _type);
-    GeometricFigureType getType();
+    GeometricFigureType getType() const;
+    const BoundingBox& getBoundingBox() const;
+    void setBoundingBox(const BoundingBox& box);
 protected:
     std::vector<Vertex2d> points;
     GeometricFigureType type;
+    // Of the geometry (vertices, end points, center and radius), not of the
+    // points: kept up to date by the figures whenever it changes
+    BoundingBox boundingBox;
 };
 
 #endif /* GeometricFigure_hpp */
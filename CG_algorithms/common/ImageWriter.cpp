@@ -0,0 +1,281 @@
+/**
+ * ImageWriter.cpp
+ * Image files written one row at a time, from the top of the image down.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "ImageWriter.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+// Biggest deflate block without compression
+static const size_t MAX_STORED_BLOCK = 65535;
+// The blocks are written as an IDAT chunk once they get this big
+static const size_t CHUNK_SIZE = 1 << 18;
+static const unsigned int ADLER_MODULO = 65521;
+// Most bytes summed before the Adler-32 sums can overflow
+static const size_t ADLER_MAX_RUN = 5552;
+
+/**
+ * Constructor of the class
+ * @param output {ostream&} - where the file goes; it must be opened in binary mode
+ */
+ImageWriter::ImageWriter(ostream& output):output(output), width(0), height(0), rowsWritten(0) {}
+
+ImageWriter::~ImageWriter() {}
+
+/**
+ * Start the image, writing the header of the file
+ * @param width {int}
+ * @param height {int}
+ */
+void ImageWriter::begin(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw invalid_argument("The image must have at least one pixel");
+    }
+    this->width = width;
+    this->height = height;
+    this->rowsWritten = 0;
+    this->writeHeader();
+}
+
+/**
+ * Write the next row of the image, from the top down
+ * @param row {const unsigned char*} - width RGB pixels
+ */
+void ImageWriter::writeRow(const unsigned char *row) {
+    if (this->rowsWritten == this->height) {
+        throw invalid_argument("Every row of the image was already written");
+    }
+    this->writeRowData(row);
+    this->rowsWritten++;
+}
+
+/**
+ * End the image, after its last row
+ */
+void ImageWriter::finish() {
+    if (this->rowsWritten != this->height) {
+        throw invalid_argument("The image is missing rows");
+    }
+    this->writeTrailer();
+    this->output.flush();
+    if (!this->output) {
+        throw invalid_argument("Could not write the image");
+    }
+}
+
+/**
+ * Getters for the size of the image
+ * @return {int}
+ */
+int ImageWriter::getWidth() const {
+    return this->width;
+}
+
+int ImageWriter::getHeight() const {
+    return this->height;
+}
+
+PpmImageWriter::PpmImageWriter(ostream& output):ImageWriter(output) {}
+
+void PpmImageWriter::writeHeader() {
+    this->output << "P6\n" << this->width << " " << this->height << "\n255\n";
+}
+
+void PpmImageWriter::writeRowData(const unsigned char *row) {
+    this->output.write((const char*) row, 3 * this->width);
+}
+
+void PpmImageWriter::writeTrailer() {}
+
+/**
+ * Table of the CRC-32 of every byte value, for updateCrc
+ */
+struct CrcTable {
+    unsigned int values[256];
+    
+    CrcTable() {
+        for (unsigned int i = 0; i < 256; i++) {
+            unsigned int value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            this->values[i] = value;
+        }
+    }
+};
+
+/**
+ * CRC-32 of the PNG chunks, with the table built on the first call. The
+ * writers of the batch renderer run on several threads; a local static is
+ * built by only one of them, and the others wait for it.
+ * @param crc {unsigned int} - the CRC of the bytes before, 0 at first
+ * @param data {const unsigned char*}
+ * @param size {size_t}
+ * @return {unsigned int}
+ */
+static unsigned int updateCrc(unsigned int crc, const unsigned char *data, size_t size) {
+    static const CrcTable table;
+    
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * Append a 32 bits number in big endian, the order of the PNG fields
+ * @param bytes {vector<unsigned char>&}
+ * @param value {unsigned int}
+ */
+static void appendBigEndian(vector<unsigned char>& bytes, unsigned int value) {
+    bytes.push_back((unsigned char) (value >> 24));
+    bytes.push_back((unsigned char) (value >> 16));
+    bytes.push_back((unsigned char) (value >> 8));
+    bytes.push_back((unsigned char) value);
+}
+
+PngImageWriter::PngImageWriter(ostream& output):ImageWriter(output), adlerLow(1), adlerHigh(0) {}
+
+/**
+ * Write the PNG signature, the IHDR chunk and the zlib header
+ */
+void PngImageWriter::writeHeader() {
+    static const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    this->output.write((const char*) signature, sizeof(signature));
+    
+    vector<unsigned char> header;
+    appendBigEndian(header, (unsigned int) this->width);
+    appendBigEndian(header, (unsigned int) this->height);
+    // 8 bits per channel, RGB, deflate, no filter, no interlacing
+    header.push_back(8);
+    header.push_back(2);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    this->writeChunk("IHDR", header.data(), header.size());
+    
+    this->chunk.clear();
+    this->block.clear();
+    this->block.reserve(MAX_STORED_BLOCK);
+    this->adlerLow = 1;
+    this->adlerHigh = 0;
+    // zlib header: deflate with a 32 KB window, no dictionary
+    this->chunk.push_back(0x78);
+    this->chunk.push_back(0x01);
+}
+
+/**
+ * Every row starts with its filter type, 0 for none
+ * @param row {const unsigned char*}
+ */
+void PngImageWriter::writeRowData(const unsigned char *row) {
+    const unsigned char filter = 0;
+    this->appendData(&filter, 1);
+    this->appendData(row, 3 * (size_t) this->width);
+}
+
+/**
+ * Close the deflate stream with the last block and the Adler-32 of the
+ * uncompressed data, then end the file
+ */
+void PngImageWriter::writeTrailer() {
+    this->emitBlock(true);
+    appendBigEndian(this->chunk, (this->adlerHigh << 16) | this->adlerLow);
+    this->writeChunk("IDAT", this->chunk.data(), this->chunk.size());
+    this->chunk.clear();
+    this->writeChunk("IEND", NULL, 0);
+}
+
+/**
+ * Add uncompressed bytes to the deflate stream
+ * @param data {const unsigned char*}
+ * @param size {size_t}
+ */
+void PngImageWriter::appendData(const unsigned char *data, size_t size) {
+    // The sums are only reduced every few thousand bytes, when they could overflow
+    for (size_t done = 0; done < size;) {
+        size_t run = min(size - done, ADLER_MAX_RUN);
+        for (size_t i = done; i < done + run; i++) {
+            this->adlerLow += data[i];
+            this->adlerHigh += this->adlerLow;
+        }
+        this->adlerLow %= ADLER_MODULO;
+        this->adlerHigh %= ADLER_MODULO;
+        done += run;
+    }
+    
+    while (size > 0) {
+        size_t count = min(size, MAX_STORED_BLOCK - this->block.size());
+        this->block.insert(this->block.end(), data, data + count);
+        data += count;
+        size -= count;
+        if (this->block.size() == MAX_STORED_BLOCK) {
+            this->emitBlock(false);
+        }
+    }
+}
+
+/**
+ * Move the pending bytes to the chunk as a deflate block without
+ * compression, writing the chunk when it is big enough
+ * @param lastBlock {bool} - whether it ends the deflate stream
+ */
+void PngImageWriter::emitBlock(bool lastBlock) {
+    unsigned int size = (unsigned int) this->block.size();
+    this->chunk.push_back(lastBlock ? 1 : 0);
+    this->chunk.push_back((unsigned char) size);
+    this->chunk.push_back((unsigned char) (size >> 8));
+    this->chunk.push_back((unsigned char) ~size);
+    this->chunk.push_back((unsigned char) (~size >> 8));
+    this->chunk.insert(this->chunk.end(), this->block.begin(), this->block.end());
+    this->block.clear();
+    
+    if (!lastBlock && this->chunk.size() >= CHUNK_SIZE) {
+        this->writeChunk("IDAT", this->chunk.data(), this->chunk.size());
+        this->chunk.clear();
+    }
+}
+
+/**
+ * Write a PNG chunk: its size, type, data and CRC
+ * @param type {const char*} - the four letters of the type
+ * @param data {const unsigned char*}
+ * @param size {size_t}
+ */
+void PngImageWriter::writeChunk(const char *type, const unsigned char *data, size_t size) {
+    vector<unsigned char> prefix;
+    appendBigEndian(prefix, (unsigned int) size);
+    prefix.insert(prefix.end(), type, type + 4);
+    this->output.write((const char*) prefix.data(), prefix.size());
+    if (size > 0) {
+        this->output.write((const char*) data, size);
+    }
+    
+    unsigned int crc = updateCrc(0, prefix.data() + 4, 4);
+    crc = updateCrc(crc, data, size);
+    vector<unsigned char> suffix;
+    appendBigEndian(suffix, crc);
+    this->output.write((const char*) suffix.data(), suffix.size());
+}
+
+/**
+ * Create the writer for the format of a file name: PNG for ".png", PPM otherwise
+ * @param path {string} - the name of the file
+ * @param output {ostream&} - where the file goes
+ * @return {ImageWriter*} - to be deleted by the caller
+ */
+ImageWriter* createImageWriter(const string& path, ostream& output) {
+    string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".png") {
+        return new PngImageWriter(output);
+    }
+    return new PpmImageWriter(output);
+}
@@ -0,0 +1,76 @@
+/**
+ * ImageWriter.hpp
+ * Image files written one row at a time, from the top of the image down, so
+ * an image never has to be whole in memory to be saved (see StreamingRenderer).
+ * Every row is width RGB pixels, 3 bytes per pixel.
+ *
+ * PpmImageWriter writes binary PPM (P6). PngImageWriter writes PNG with the
+ * rows stored in uncompressed deflate blocks: the file is about as big as a
+ * PPM, but any PNG reader opens it and no compression library is needed.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef ImageWriter_hpp
+#define ImageWriter_hpp
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ImageWriter {
+public:
+    ImageWriter(std::ostream& output);
+    virtual ~ImageWriter();
+    void begin(int width, int height);
+    void writeRow(const unsigned char *row);
+    void finish();
+    int getWidth() const;
+    int getHeight() const;
+protected:
+    virtual void writeHeader() = 0;
+    virtual void writeRowData(const unsigned char *row) = 0;
+    virtual void writeTrailer() = 0;
+    
+    std::ostream& output;
+    int width;
+    int height;
+private:
+    ImageWriter(const ImageWriter&);
+    ImageWriter& operator=(const ImageWriter&);
+    
+    int rowsWritten;
+};
+
+class PpmImageWriter : public ImageWriter {
+public:
+    PpmImageWriter(std::ostream& output);
+protected:
+    void writeHeader();
+    void writeRowData(const unsigned char *row);
+    void writeTrailer();
+};
+
+class PngImageWriter : public ImageWriter {
+public:
+    PngImageWriter(std::ostream& output);
+protected:
+    void writeHeader();
+    void writeRowData(const unsigned char *row);
+    void writeTrailer();
+private:
+    void appendData(const unsigned char *data, std::size_t size);
+    void emitBlock(bool lastBlock);
+    void writeChunk(const char *type, const unsigned char *data, std::size_t size);
+    
+    // The deflate blocks not written yet, in a single IDAT chunk
+    std::vector<unsigned char> chunk;
+    // Uncompressed bytes waiting for the current deflate block
+    std::vector<unsigned char> block;
+    unsigned int adlerLow;
+    unsigned int adlerHigh;
+};
+
+ImageWriter* createImageWriter(const std::string& path, std::ostream& output);
+
+#endif /* ImageWriter_hpp */
@@ -0,0 +1,117 @@
+/**
+ * MpmcQueue.hpp
+ * Bounded lock-free queue for any number of producer and consumer threads.
+ * Every slot of the ring (Capacity slots, a power of two) carries a sequence
+ * number that tells whether it is ready to be written or read in the current
+ * lap, so the threads only race on the head and tail counters. Pushing on a
+ * full queue or popping on an empty one fails instead of waiting.
+ * When there is only one producer and one consumer, SpscQueue is cheaper.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef MpmcQueue_hpp
+#define MpmcQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, std::size_t Capacity>
+class MpmcQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+public:
+    MpmcQueue():head(0), tail(0) {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    /**
+     * Add an element to the queue
+     * @param value {T}
+     * @return {bool} - false when the queue is full
+     */
+    bool tryPush(const T& value) {
+        std::size_t position = this->head.load(std::memory_order_relaxed);
+    
+        for (;;) {
+            Slot& slot = this->slots[position & (Capacity - 1)];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) position;
+    
+            if (difference == 0) {
+                // The slot is free in this lap, try to claim it
+                if (this->head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // The slot still holds an element of the previous lap
+                return false;
+            } else {
+                // Another producer claimed it first
+                position = this->head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    /**
+     * Take the oldest element of the queue
+     * @param value {T&} - where the element is written
+     * @return {bool} - false when the queue is empty
+     */
+    bool tryPop(T& value) {
+        std::size_t position = this->tail.load(std::memory_order_relaxed);
+    
+        for (;;) {
+            Slot& slot = this->slots[position & (Capacity - 1)];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) (position + 1);
+    
+            if (difference == 0) {
+                if (this->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = slot.value;
+                    // Free the slot for the next lap
+                    slot.sequence.store(position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = this->tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    /**
+     * Number of elements in the queue; only exact when every thread is idle
+     * @return {size_t}
+     */
+    std::size_t size() const {
+        std::size_t currentHead = this->head.load(std::memory_order_acquire);
+        std::size_t currentTail = this->tail.load(std::memory_order_acquire);
+        return currentHead > currentTail ? currentHead - currentTail : 0;
+    }
+    
+    bool empty() const {
+        return this->size() == 0;
+    }
+private:
+    MpmcQueue(const MpmcQueue&);
+    MpmcQueue& operator=(const MpmcQueue&);
+    
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+    
+    Slot slots[Capacity];
+    // Head and tail are written by different threads, keep them on different cache lines
+    char slotsPadding[64];
+    std::atomic<std::size_t> head;
+    char headPadding[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail;
+};
+
+#endif /* MpmcQueue_hpp */
@@ -0,0 +1,313 @@
+/**
+ * Pipeline.cpp
+ * The 2D pipeline as stages running on worker threads of their own.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Pipeline.hpp"
+#include "PixelSink.hpp"
+#include "Trace.hpp"
+#include "FrameArena.hpp"
+#include "../lines/Line.hpp"
+#include "../lines/Circumference.hpp"
+#include "../polygons/Polygon.hpp"
+#include <stdexcept>
+
+using namespace std;
+
+PipelineFigure::PipelineFigure():type(POLYGON), radius(0), filled(false), hasTransformation(false), tag(0), visible(true) {}
+
+/**
+ * Push to a queue, waiting while it is full. This is the backpressure: a
+ * stage does not take more figures while the next one can not keep up.
+ * @param queue {Queue&}
+ * @param figure {PipelineFigure*}
+ */
+template <typename Queue>
+static void pushWaiting(Queue& queue, PipelineFigure *figure) {
+    while (!queue.tryPush(figure)) {
+        this_thread::yield();
+    }
+}
+
+/**
+ * Pop from a queue, waiting while it is empty and the stage before it is running
+ * @param queue {Queue&}
+ * @param running {atomic<bool>&} - whether the stage before is still running
+ * @param figure {PipelineFigure*&} - where the figure is written
+ * @return {bool} - false when the stage before stopped and the queue is empty
+ */
+template <typename Queue>
+static bool popWaiting(Queue& queue, const atomic<bool>& running, PipelineFigure*& figure) {
+    for (;;) {
+        // Read the flag before trying, so a figure pushed just before it was cleared is not lost
+        bool wasRunning = running.load();
+        if (queue.tryPop(figure)) {
+            return true;
+        }
+        if (!wasRunning) {
+            return false;
+        }
+        this_thread::yield();
+    }
+}
+
+/**
+ * Constructor of the class. The workers only start with start().
+ * @param bottomLeftCorner {Vertex2d} - of the clipping window
+ * @param topRightCorner {Vertex2d} - of the clipping window
+ * @param rasterWorkers {int} - number of threads rasterizing the figures
+ */
+Pipeline::Pipeline(const Vertex2d& bottomLeftCorner, const Vertex2d& topRightCorner, int rasterWorkers):
+    window(bottomLeftCorner, topRightCorner), rasterWorkers(rasterWorkers),
+    transformRunning(false), clipRunning(false), rasterRunning(false), discardingOutput(false),
+    submitted(0), received(0) {
+    if (rasterWorkers < 1) {
+        throw invalid_argument("The pipeline needs at least one raster worker");
+    }
+}
+
+Pipeline::~Pipeline() {
+    this->stop();
+}
+
+/**
+ * Start the workers of every stage
+ */
+void Pipeline::start() {
+    if (this->transformRunning.load()) {
+        throw invalid_argument("The pipeline is already running");
+    }
+    
+    this->transformRunning.store(true);
+    this->clipRunning.store(true);
+    this->rasterRunning.store(true);
+    
+    this->transformWorker = thread(&Pipeline::runTransformStage, this);
+    this->clipWorker = thread(&Pipeline::runClipStage, this);
+    for (int i = 0; i < this->rasterWorkers; i++) {
+        this->rasterWorkerThreads.push_back(thread(&Pipeline::runRasterStage, this));
+    }
+}
+
+/**
+ * Stop the workers, one stage after the other, after the figures already
+ * submitted went through. The figures not received by then are dropped: the
+ * raster workers do not wait for room in the output anymore, so stopping
+ * never hangs on a full output queue.
+ */
+void Pipeline::stop() {
+    if (!this->transformRunning.exchange(false)) {
+        return;
+    }
+    
+    this->discardingOutput.store(true);
+    this->transformWorker.join();
+    this->clipRunning.store(false);
+    this->clipWorker.join();
+    this->rasterRunning.store(false);
+    for (thread& worker : this->rasterWorkerThreads) {
+        worker.join();
+    }
+    this->rasterWorkerThreads.clear();
+    
+    // The figures still waiting in the output would come out of a restarted pipeline
+    PipelineFigure *figure;
+    while (this->outputQueue.tryPop(figure)) {
+        this->received++;
+    }
+    this->discardingOutput.store(false);
+}
+
+/**
+ * Submit a figure, unless the pipeline is full. Only one thread may submit.
+ * @param figure {PipelineFigure*}
+ * @return {bool} - false when the transform stage can not take it yet
+ */
+bool Pipeline::trySubmit(PipelineFigure *figure) {
+    if (!this->transformQueue.tryPush(figure)) {
+        return false;
+    }
+    this->submitted++;
+    return true;
+}
+
+/**
+ * Submit a figure, waiting while the pipeline is full. Only one thread may submit.
+ * @param figure {PipelineFigure*}
+ */
+void Pipeline::submit(PipelineFigure *figure) {
+    pushWaiting(this->transformQueue, figure);
+    this->submitted++;
+}
+
+/**
+ * Take a figure that went through every stage, if there is one
+ * @param figure {PipelineFigure*&} - where the figure is written
+ * @return {bool} - false when no figure is ready
+ */
+bool Pipeline::tryReceive(PipelineFigure*& figure) {
+    if (!this->outputQueue.tryPop(figure)) {
+        return false;
+    }
+    this->received++;
+    return true;
+}
+
+/**
+ * Take a figure that went through every stage, waiting for it.
+ * There must be a figure in flight, otherwise it waits forever.
+ * @return {PipelineFigure*}
+ */
+PipelineFigure* Pipeline::receive() {
+    PipelineFigure *figure;
+    while (!this->tryReceive(figure)) {
+        this_thread::yield();
+    }
+    return figure;
+}
+
+/**
+ * Number of figures submitted and not received yet
+ * @return {unsigned long}
+ */
+unsigned long Pipeline::getFiguresInFlight() const {
+    return this->submitted.load() - this->received.load();
+}
+
+/**
+ * Take a figure through every stage on the calling thread, the way the
+ * pipeline ran before it had workers. Only while the pipeline is stopped.
+ * @param figure {PipelineFigure*}
+ */
+void Pipeline::process(PipelineFigure *figure) {
+    if (this->transformRunning.load()) {
+        throw invalid_argument("The pipeline is running, submit the figure instead");
+    }
+    this->transform(figure);
+    this->clip(figure);
+    this->rasterize(figure);
+}
+
+/**
+ * Apply the modeling transformation to the figure vertices
+ * @param figure {PipelineFigure*}
+ */
+void Pipeline::transform(PipelineFigure *figure) {
+    if (!figure->hasTransformation) {
+        return;
+    }
+    
+    CG_TRACE_SPAN("transform", figure->type, (unsigned int) figure->vertices.size());
+    figure->transformation.transformVertices(figure->vertices.data(), figure->vertices.size());
+}
+
+/**
+ * Clip the figure against the window, replacing its vertices by the clipped
+ * ones. The circumferences are not clipped (see ViewportWindow::clip).
+ * @param figure {PipelineFigure*}
+ */
+void Pipeline::clip(PipelineFigure *figure) {
+    switch (figure->type) {
+        case LINE: {
+            this->window.clipLine(Line(figure->vertices[0], figure->vertices[1]));
+            figure->visible = !this->window.getVisibleObjects().empty();
+            if (figure->visible) {
+                const Line *clippedLine = static_cast<const Line*>(this->window.getVisibleObjects().back());
+                figure->vertices[0] = clippedLine->getInitialPoint();
+                figure->vertices[1] = clippedLine->getFinalPoint();
+            }
+            break;
+        }
+        case POLYGON: {
+            this->window.clipPolygon(Polygon(figure->vertices));
+            VertexSpan clippedVertices = static_cast<const Polygon*>(this->window.getVisibleObjects().back())->getVertices();
+            figure->visible = clippedVertices.size() >= 3;
+            figure->vertices.assign(clippedVertices.begin(), clippedVertices.end());
+            break;
+        }
+        case CIRCUMFERENCE:
+            figure->visible = true;
+            break;
+    }
+    
+    // The window keeps the clipped figures, they are not needed anymore
+    this->window.clearVisibleObjects();
+}
+
+/**
+ * Rasterize a visible figure into its points
+ * @param figure {PipelineFigure*}
+ */
+void Pipeline::rasterize(PipelineFigure *figure) {
+    figure->points.clear();
+    if (!figure->visible) {
+        return;
+    }
+    
+    CG_TRACE_SPAN("raster", figure->type, (unsigned int) figure->vertices.size());
+    VectorPixelSink sink(figure->points);
+    
+    switch (figure->type) {
+        case LINE:
+            Line::rasterizeLineBresenham(figure->vertices[0], figure->vertices[1], sink);
+            break;
+        case POLYGON:
+            if (figure->filled) {
+                Polygon::rasterizeFilledPolygon(figure->vertices, sink);
+            } else {
+                Polygon::rasterizeNotFilledPolygon(figure->vertices, sink);
+            }
+            break;
+        case CIRCUMFERENCE:
+            Circumference::rasterizeCircumferenceBresenham(figure->vertices[0], figure->radius, sink);
+            break;
+    }
+}
+
+/**
+ * Body of the transform worker
+ */
+void Pipeline::runTransformStage() {
+    PipelineFigure *figure;
+    while (popWaiting(this->transformQueue, this->transformRunning, figure)) {
+        this->transform(figure);
+        pushWaiting(this->clipQueue, figure);
+    }
+}
+
+/**
+ * Body of the clip worker
+ */
+void Pipeline::runClipStage() {
+    PipelineFigure *figure;
+    while (popWaiting(this->clipQueue, this->clipRunning, figure)) {
+        this->clip(figure);
+        pushWaiting(this->rasterQueue, figure);
+    }
+}
+
+/**
+ * Body of each raster worker
+ */
+void Pipeline::runRasterStage() {
+    // The edges tables of each figure are given back as soon as it is rasterized
+    FrameArena arena;
+    PipelineFigure *figure;
+    while (popWaiting(this->rasterQueue, this->rasterRunning, figure)) {
+        {
+            FrameArena::Scope figureScope(arena);
+            this->rasterize(figure);
+        }
+    
+        // Nobody receives the figures anymore once the pipeline is stopping
+        while (!this->outputQueue.tryPush(figure)) {
+            if (this->discardingOutput.load()) {
+                this->received++;
+                break;
+            }
+            this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * Pipeline.hpp
+ * The 2D pipeline (modeling transformation, clipping and scan conversion) as
+ * stages running on worker threads of their own. The figures flow from stage
+ * to stage through bounded lock-free queues, so while one figure is being
+ * rasterized the next ones are already being transformed and clipped, and the
+ * figures of frame N+1 can be transformed while frame N is rasterized.
+ * When a stage falls behind, its queue fills up and the stages before it wait
+ * (backpressure), down to submit.
+ *
+ *   submit -> [transform] -> [clip] -> [raster x N] -> receive
+ *
+ * The rasterization is the slowest stage, so it can have several workers; the
+ * figures may then come out in a different order than they went in.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Pipeline_hpp
+#define Pipeline_hpp
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Vertex2d.hpp"
+#include "VertexSpan.hpp"
+#include "GeometricFigure.hpp"
+#include "ViewportWindow.hpp"
+#include "SpscQueue.hpp"
+#include "MpmcQueue.hpp"
+#include "../2D_transformations/Matrix2d.hpp"
+
+// Number of figures each queue between two stages can hold
+#define PIPELINE_QUEUE_CAPACITY 256
+
+/**
+ * A figure going through the pipeline. The caller owns it: it is filled and
+ * submitted, and comes back from receive with its pixels, ready to be reused.
+ */
+struct PipelineFigure {
+    PipelineFigure();
+    
+    GeometricFigureType type;
+    // The polygon vertices, the two ends of a line or the center of a circumference
+    VertexBuffer vertices;
+    int radius;
+    bool filled;
+    // Applied by the transform stage, only when hasTransformation is set
+    Matrix2d transformation;
+    bool hasTransformation;
+    // Free for the caller, e.g. the frame the figure belongs to
+    unsigned long tag;
+    
+    // Set by the clip stage, false when the figure is entirely outside the window
+    bool visible;
+    // Set by the raster stage
+    std::vector<Vertex2d> points;
+};
+
+class Pipeline {
+public:
+    Pipeline(const Vertex2d& bottomLeftCorner, const Vertex2d& topRightCorner, int rasterWorkers = 1);
+    ~Pipeline();
+    void start();
+    void stop();
+    bool trySubmit(PipelineFigure *figure);
+    void submit(PipelineFigure *figure);
+    bool tryReceive(PipelineFigure*& figure);
+    PipelineFigure* receive();
+    unsigned long getFiguresInFlight() const;
+    void process(PipelineFigure *figure);
+private:
+    Pipeline(const Pipeline&);
+    Pipeline& operator=(const Pipeline&);
+    void runTransformStage();
+    void runClipStage();
+    void runRasterStage();
+    void transform(PipelineFigure *figure);
+    void clip(PipelineFigure *figure);
+    void rasterize(PipelineFigure *figure);
+    
+    // Only used by the clip worker
+    ViewportWindow window;
+    int rasterWorkers;
+    
+    SpscQueue<PipelineFigure*, PIPELINE_QUEUE_CAPACITY> transformQueue;
+    SpscQueue<PipelineFigure*, PIPELINE_QUEUE_CAPACITY> clipQueue;
+    MpmcQueue<PipelineFigure*, PIPELINE_QUEUE_CAPACITY> rasterQueue;
+    MpmcQueue<PipelineFigure*, PIPELINE_QUEUE_CAPACITY> outputQueue;
+    
+    std::thread transformWorker;
+    std::thread clipWorker;
+    std::vector<std::thread> rasterWorkerThreads;
+    // Each stage keeps going until the stage before it stopped and its queue is empty
+    std::atomic<bool> transformRunning;
+    std::atomic<bool> clipRunning;
+    std::atomic<bool> rasterRunning;
+    // Set while stopping, so the raster workers drop the figures the output has no room for
+    std::atomic<bool> discardingOutput;
+    std::atomic<unsigned long> submitted;
+    std::atomic<unsigned long> received;
+};
+
+#endif /* Pipeline_hpp */
@@ -0,0 +1,97 @@
+/**
+ * PixelRange.hpp
+ * Lazy, single pass range of pixels, built on top of a pixel generator.
+ *
+ * A generator is any class with the method
+ *
+ *   bool next(Vertex2d& pixel);
+ *
+ * which writes the next pixel and returns true, or returns false when
+ * there are no pixels left. The range only asks for a pixel when the
+ * iterator is incremented, so consumers that stop early (hit tests,
+ * sampling) do not pay for the whole figure, and nothing is allocated per
+ * pixel. The iterators are input iterators, so the range works with the
+ * standard algorithms (find_if, count_if, for_each...), but it can only
+ * be walked once.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef PixelRange_hpp
+#define PixelRange_hpp
+
+#include <cstddef>
+#include <iterator>
+#include "Vertex2d.hpp"
+
+template <typename Generator>
+class PixelRange {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Vertex2d value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Vertex2d* pointer;
+        typedef const Vertex2d& reference;
+        
+        iterator():generator(NULL) {}
+        
+        explicit iterator(Generator *_generator):generator(_generator) {
+            this->advance();
+        }
+        
+        reference operator*() const {
+            return this->pixel;
+        }
+        
+        pointer operator->() const {
+            return &this->pixel;
+        }
+        
+        iterator& operator++() {
+            this->advance();
+            return *this;
+        }
+        
+        iterator operator++(int) {
+            iterator previous = *this;
+            this->advance();
+            return previous;
+        }
+        
+        // Only the end state is compared: every iterator on a finished range is equal
+        bool operator==(const iterator& other) const {
+            return this->generator == other.generator;
+        }
+        
+        bool operator!=(const iterator& other) const {
+            return this->generator != other.generator;
+        }
+    private:
+        void advance() {
+            if (this->generator != NULL && !this->generator->next(this->pixel)) {
+                this->generator = NULL;
+            }
+        }
+        
+        Generator *generator;
+        Vertex2d pixel;
+    };
+    
+    // The arguments are forwarded to the generator constructor
+    template <typename... Args>
+    explicit PixelRange(const Args&... args):generator(args...) {}
+    
+    iterator begin() {
+        return iterator(&this->generator);
+    }
+    
+    iterator end() {
+        return iterator();
+    }
+private:
+    Generator generator;
+};
+
+#endif /* PixelRange_hpp */
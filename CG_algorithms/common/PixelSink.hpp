@@ -0,0 +1,181 @@
+/**
+ * PixelSink.hpp
+ * Destinations for the pixels generated by the rasterizers.
+ *
+ * Every rasterizer (Line, Circumference and Polygon) is a template on the
+ * sink type, so the calls below are resolved and inlined at compile time.
+ * A sink is any class with these two methods:
+ *
+ *   void plot(int x, int y, const Vertex2d& color);
+ *   void span(int xStart, int xEnd, int y, const Vertex2d& color);
+ *
+ * span is a horizontal run of pixels, both ends included. Only the colors of
+ * the color vertex are meaningful.
+ *
+ * The anti-aliased rasterizers (Line::rasterizeLineWu and
+ * Polygon::rasterizeAntialiasedPolygon) also need a third one, for the pixels
+ * only partially covered by the figure, with coverage in (0, 1):
+ *
+ *   void plotCoverage(int x, int y, const Vertex2d& color, float coverage);
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef PixelSink_hpp
+#define PixelSink_hpp
+
+#include <vector>
+#include <algorithm>
+#include "Vertex2d.hpp"
+#include "Framebuffer.hpp"
+#include "BoundingBox.hpp"
+
+/**
+ * Sink that appends the pixels to a vector of vertices,
+ * which is how GeometricFigure keeps its points
+ */
+class VectorPixelSink {
+public:
+    VectorPixelSink(std::vector<Vertex2d>& _points):points(_points) {}
+    
+    void plot(int x, int y, const Vertex2d& color) {
+        this->points.push_back(color);
+        this->points.back().setX(x);
+        this->points.back().setY(y);
+    }
+    
+    void span(int xStart, int xEnd, int y, const Vertex2d& color) {
+        for (; xStart <= xEnd; xStart++) {
+            this->plot(xStart, y, color);
+        }
+    }
+private:
+    std::vector<Vertex2d>& points;
+};
+
+/**
+ * Sink that only counts the pixels
+ */
+class CountingPixelSink {
+public:
+    CountingPixelSink():count(0) {}
+    
+    void plot(int, int, const Vertex2d&) {
+        this->count++;
+    }
+    
+    void plotCoverage(int, int, const Vertex2d&, float) {
+        this->count++;
+    }
+    
+    void span(int xStart, int xEnd, int, const Vertex2d&) {
+        if (xEnd >= xStart) {
+            this->count += xEnd - xStart + 1;
+        }
+    }
+    
+    long getCount() const {
+        return this->count;
+    }
+private:
+    long count;
+};
+
+/**
+ * A horizontal run of pixels, both ends included
+ */
+struct PixelSpan {
+    int xStart;
+    int xEnd;
+    int y;
+};
+
+/**
+ * Sink that keeps the pixels as a list of spans. Consecutive pixels on
+ * the same row are merged into a single span.
+ */
+class SpanListPixelSink {
+public:
+    SpanListPixelSink(std::vector<PixelSpan>& _spans):spans(_spans) {}
+    
+    void plot(int x, int y, const Vertex2d& color) {
+        this->span(x, x, y, color);
+    }
+    
+    void span(int xStart, int xEnd, int y, const Vertex2d&) {
+        if (xEnd < xStart) {
+            return;
+        }
+        if (!this->spans.empty()) {
+            PixelSpan &last = this->spans.back();
+            if (last.y == y && last.xEnd + 1 == xStart) {
+                last.xEnd = xEnd;
+                return;
+            }
+        }
+        PixelSpan newSpan = {xStart, xEnd, y};
+        this->spans.push_back(newSpan);
+    }
+private:
+    std::vector<PixelSpan>& spans;
+};
+
+/**
+ * Sink that writes the pixels straight into a Framebuffer
+ */
+class FramebufferPixelSink {
+public:
+    FramebufferPixelSink(Framebuffer& _framebuffer):framebuffer(_framebuffer) {}
+    
+    void plot(int x, int y, const Vertex2d& color) {
+        this->framebuffer.setPixel(x, y, color);
+    }
+    
+    void span(int xStart, int xEnd, int y, const Vertex2d& color) {
+        this->framebuffer.fillSpan(xStart, xEnd, y, color);
+    }
+    
+    void plotCoverage(int x, int y, const Vertex2d& color, float coverage) {
+        this->framebuffer.blendPixel(x, y, color, coverage);
+    }
+private:
+    Framebuffer& framebuffer;
+};
+
+/**
+ * Sink that only lets through the pixels inside a box, cutting the spans
+ * at its borders, and forwards them to another sink
+ */
+template <typename Sink>
+class ClippedPixelSink {
+public:
+    ClippedPixelSink(Sink& _sink, const BoundingBox& _box):sink(_sink), box(_box) {}
+    
+    void plot(int x, int y, const Vertex2d& color) {
+        if (this->box.contains(x, y)) {
+            this->sink.plot(x, y, color);
+        }
+    }
+    
+    void plotCoverage(int x, int y, const Vertex2d& color, float coverage) {
+        if (this->box.contains(x, y)) {
+            this->sink.plotCoverage(x, y, color, coverage);
+        }
+    }
+    
+    void span(int xStart, int xEnd, int y, const Vertex2d& color) {
+        if (y < this->box.getYMin() || y > this->box.getYMax()) {
+            return;
+        }
+        xStart = std::max(xStart, this->box.getXMin());
+        xEnd = std::min(xEnd, this->box.getXMax());
+        if (xStart <= xEnd) {
+            this->sink.span(xStart, xEnd, y, color);
+        }
+    }
+private:
+    Sink& sink;
+    BoundingBox box;
+};
+
+#endif /* PixelSink_hpp */
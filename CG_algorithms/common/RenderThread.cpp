@@ -0,0 +1,162 @@
+/**
+ * RenderThread.cpp
+ * Class that rasterizes the frames on a thread of its own.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "RenderThread.hpp"
+#include "Trace.hpp"
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+
+// How long the render thread sleeps when there is nothing to render, in milliseconds
+#define RENDER_THREAD_IDLE_INTERVAL 1
+
+/**
+ * Constructor of the class. All the command buffers start free.
+ * @param width {int}
+ * @param height {int}
+ */
+RenderThread::RenderThread(int width, int height):
+    framebuffers{Framebuffer(width, height), Framebuffer(width, height)},
+    frontIndex(0), hasFrame(false), running(false), renderedFrames(0), skippedFrames(0) {
+    for (int i = 0; i < RENDER_THREAD_BUFFERS; i++) {
+        this->recycled.tryPush(&this->commandBuffers[i]);
+    }
+}
+
+RenderThread::~RenderThread() {
+    this->stop();
+}
+
+/**
+ * Start the render thread
+ */
+void RenderThread::start() {
+    if (this->running.exchange(true)) {
+        throw invalid_argument("The render thread is already running");
+    }
+    this->worker = thread(&RenderThread::run, this);
+}
+
+/**
+ * Stop the render thread, after the frame it is rendering
+ */
+void RenderThread::stop() {
+    if (!this->running.exchange(false)) {
+        return;
+    }
+    this->worker.join();
+}
+
+bool RenderThread::isRunning() const {
+    return this->running.load();
+}
+
+/**
+ * Take a free command buffer to record the next frame. Only the update
+ * thread may call it.
+ * @return {CommandBuffer*} - an empty buffer, or NULL when the render thread
+ * still holds all of them and this frame should be skipped
+ */
+CommandBuffer* RenderThread::acquire() {
+    CommandBuffer *commandBuffer = NULL;
+    if (!this->recycled.tryPop(commandBuffer)) {
+        this->skippedFrames++;
+        return NULL;
+    }
+    commandBuffer->clear();
+    return commandBuffer;
+}
+
+/**
+ * Hand a recorded command buffer to the render thread. Only the update
+ * thread may call it.
+ * @param commandBuffer {CommandBuffer*} - a buffer taken with acquire
+ */
+void RenderThread::submit(CommandBuffer *commandBuffer) {
+    // There are as many slots as buffers, so it never fails
+    this->submitted.tryPush(commandBuffer);
+}
+
+/**
+ * Draw the last completed frame on the screen. Only the thread that owns the
+ * OpenGL context may call it.
+ * @return {bool} - false when no frame has been completed yet
+ */
+bool RenderThread::present() {
+    lock_guard<mutex> lock(this->frontMutex);
+    if (!this->hasFrame) {
+        return false;
+    }
+    this->framebuffers[this->frontIndex].present();
+    return true;
+}
+
+/**
+ * Number of frames rasterized so far
+ * @return {unsigned long}
+ */
+unsigned long RenderThread::getRenderedFrames() const {
+    return this->renderedFrames.load();
+}
+
+/**
+ * Number of frames that were recorded or submitted but never rasterized,
+ * because the render thread was behind
+ * @return {unsigned long}
+ */
+unsigned long RenderThread::getSkippedFrames() const {
+    return this->skippedFrames.load();
+}
+
+/**
+ * Rasterize the newest submitted buffer into the back framebuffer and make
+ * it the front one. Older buffers still waiting are recycled without being
+ * rasterized, since each buffer holds a whole frame.
+ * @return {bool} - false when nothing was submitted
+ */
+bool RenderThread::renderLatest() {
+    CommandBuffer *latest = NULL;
+    CommandBuffer *commandBuffer;
+    
+    while (this->submitted.tryPop(commandBuffer)) {
+        if (latest) {
+            this->recycled.tryPush(latest);
+            this->skippedFrames++;
+        }
+        latest = commandBuffer;
+    }
+    
+    if (!latest) {
+        return false;
+    }
+    
+    {
+        CG_TRACE_SPAN("frame");
+        // Only this thread writes the back framebuffer, the GLUT thread just reads the front one
+        FrameArena::Scope frameScope(this->arena);
+        latest->execute(this->framebuffers[1 - this->frontIndex]);
+    }
+    this->recycled.tryPush(latest);
+    
+    lock_guard<mutex> lock(this->frontMutex);
+    this->frontIndex = 1 - this->frontIndex;
+    this->hasFrame = true;
+    this->renderedFrames++;
+    return true;
+}
+
+/**
+ * Body of the render thread
+ */
+void RenderThread::run() {
+    while (this->running.load()) {
+        if (!this->renderLatest()) {
+            this_thread::sleep_for(chrono::milliseconds(RENDER_THREAD_IDLE_INTERVAL));
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * RenderThread.hpp
+ * Class that rasterizes the frames on a thread of its own. The update side
+ * (the GLUT timer) records each frame into a CommandBuffer and submits it
+ * through a lock-free queue; the render thread executes the newest submitted
+ * buffer into the back framebuffer and then swaps it with the front one. The
+ * GLUT thread only draws the front framebuffer, so a slow frame no longer
+ * delays the input or the next update.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef RenderThread_hpp
+#define RenderThread_hpp
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "CommandBuffer.hpp"
+#include "Framebuffer.hpp"
+#include "FrameArena.hpp"
+#include "SpscQueue.hpp"
+
+// Number of command buffers shared by the update and render threads
+#define RENDER_THREAD_BUFFERS 4
+
+class RenderThread {
+public:
+    RenderThread(int width, int height);
+    ~RenderThread();
+    void start();
+    void stop();
+    bool isRunning() const;
+    CommandBuffer* acquire();
+    void submit(CommandBuffer *commandBuffer);
+    bool present();
+    unsigned long getRenderedFrames() const;
+    unsigned long getSkippedFrames() const;
+private:
+    RenderThread(const RenderThread&);
+    RenderThread& operator=(const RenderThread&);
+    void run();
+    bool renderLatest();
+    
+    CommandBuffer commandBuffers[RENDER_THREAD_BUFFERS];
+    // Update thread -> render thread
+    SpscQueue<CommandBuffer*, RENDER_THREAD_BUFFERS> submitted;
+    // Render thread -> update thread, the buffers free to record
+    SpscQueue<CommandBuffer*, RENDER_THREAD_BUFFERS> recycled;
+    
+    Framebuffer framebuffers[2];
+    int frontIndex;
+    bool hasFrame;
+    // Held while the front framebuffer is drawn or swapped
+    std::mutex frontMutex;
+    // The singleton arena belongs to the GLUT thread
+    FrameArena arena;
+    
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<unsigned long> renderedFrames;
+    std::atomic<unsigned long> skippedFrames;
+};
+
+#endif /* RenderThread_hpp */
@@ -0,0 +1,117 @@
+/**
+ * RetainedRenderer.cpp
+ * Draws a scene into a retained Framebuffer, redrawing only what changed.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "RetainedRenderer.hpp"
+#include "PixelSink.hpp"
+#include "Trace.hpp"
+#include "../polygons/Polygon.hpp"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor of the class. The first render draws the whole screen.
+ * @param width {int}
+ * @param height {int}
+ */
+RetainedRenderer::RetainedRenderer(int width, int height):framebuffer(width, height), tracker(width, height) {}
+
+/**
+ * Add a figure to the scene, or tell the renderer it moved or changed
+ * @param figureId {int}
+ * @param figure {const GeometricFigure*} - not owned
+ */
+void RetainedRenderer::setFigure(int figureId, const GeometricFigure *figure) {
+    const BoundingBox& box = figure->getBoundingBox();
+    this->figures[figureId] = figure;
+    this->tracker.update(figureId, box);
+    this->grid.update(figureId, box);
+}
+
+/**
+ * Take a figure out of the scene
+ * @param figureId {int}
+ */
+void RetainedRenderer::removeFigure(int figureId) {
+    this->figures.erase(figureId);
+    this->tracker.remove(figureId);
+    this->grid.remove(figureId);
+}
+
+/**
+ * Redraw the whole screen on the next render
+ */
+void RetainedRenderer::invalidateAll() {
+    this->tracker.invalidateAll();
+}
+
+/**
+ * Rasterize a figure again, only inside a region. Filled polygons are
+ * rasterized by spans; the other figures draw the points they hold.
+ * @param figure {const GeometricFigure*}
+ * @param region {BoundingBox}
+ */
+void RetainedRenderer::drawFigure(const GeometricFigure *figure, const BoundingBox& region) {
+    FramebufferPixelSink framebufferSink(this->framebuffer);
+    ClippedPixelSink<FramebufferPixelSink> sink(framebufferSink, region);
+    
+    if (figure->getType() == POLYGON && static_cast<const Polygon*>(figure)->isFilled()) {
+        static_cast<const Polygon*>(figure)->rasterize(sink);
+        return;
+    }
+    
+    for (const Vertex2d& point : figure->getPoints()) {
+        sink.plot((int) point.getX(), (int) point.getY(), point);
+    }
+}
+
+/**
+ * Redraw the dirty regions: clear them and rasterize again the figures
+ * that intersect them, in the order of their ids
+ * @return {long} - number of pixels in the redrawn regions
+ */
+long RetainedRenderer::render() {
+    CG_TRACE_SPAN("render");
+    long redrawnPixels = 0;
+    
+    for (const BoundingBox& region : this->tracker.getDirtyRegions()) {
+        this->framebuffer.clearRegion(region, 0.0f, 0.0f, 0.0f);
+        redrawnPixels += region.getArea();
+        
+        this->grid.query(region, this->candidates);
+        sort(this->candidates.begin(), this->candidates.end());
+        for (int figureId : this->candidates) {
+            this->drawFigure(this->figures[figureId], region);
+        }
+    }
+    
+    this->tracker.clear();
+    return redrawnPixels;
+}
+
+/**
+ * Draw the framebuffer on the screen
+ */
+void RetainedRenderer::present() const {
+    this->framebuffer.present();
+}
+
+/**
+ * Getter for the framebuffer
+ * @return {const Framebuffer&}
+ */
+const Framebuffer& RetainedRenderer::getFramebuffer() const {
+    return this->framebuffer;
+}
+
+/**
+ * Getter for the dirty region tracker
+ * @return {const DirtyRegionTracker&}
+ */
+const DirtyRegionTracker& RetainedRenderer::getDirtyRegionTracker() const {
+    return this->tracker;
+}
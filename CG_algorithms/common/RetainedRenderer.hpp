@@ -0,0 +1,48 @@
+/**
+ * RetainedRenderer.hpp
+ * Draws a scene into a retained Framebuffer, redrawing only what changed.
+ * The figures are registered once; when one of them moves or changes, it is
+ * registered again and the union of its old and new bounding boxes becomes
+ * dirty. render() clears the dirty regions and rasterizes again only the
+ * figures that intersect them, so a few small animated shapes over a big
+ * static scene cost about as much as the shapes themselves. The figures
+ * that intersect a region are found with a SpatialGrid.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef RetainedRenderer_hpp
+#define RetainedRenderer_hpp
+
+#include <map>
+#include <vector>
+#include "Framebuffer.hpp"
+#include "DirtyRegionTracker.hpp"
+#include "SpatialGrid.hpp"
+#include "GeometricFigure.hpp"
+
+class RetainedRenderer {
+public:
+    RetainedRenderer(int width, int height);
+    void setFigure(int figureId, const GeometricFigure *figure);
+    void removeFigure(int figureId);
+    void invalidateAll();
+    long render();
+    void present() const;
+    const Framebuffer& getFramebuffer() const;
+    const DirtyRegionTracker& getDirtyRegionTracker() const;
+private:
+    RetainedRenderer(const RetainedRenderer&);
+    RetainedRenderer& operator=(const RetainedRenderer&);
+    void drawFigure(const GeometricFigure *figure, const BoundingBox& region);
+    
+    Framebuffer framebuffer;
+    DirtyRegionTracker tracker;
+    SpatialGrid grid;
+    // Reused by render() for the figures found in the grid
+    std::vector<int> candidates;
+    // The figures are not owned, they must outlive the renderer or be removed
+    std::map<int, const GeometricFigure*> figures;
+};
+
+#endif /* RetainedRenderer_hpp */
@@ -0,0 +1,193 @@
+/**
+ * SceneFile.cpp
+ * Scenes described in text files, rendered by the batch renderer.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "SceneFile.hpp"
+#include "../2D_transformations/TransformationMatrix.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+Scene::Scene():width(0), height(0) {
+    this->background.setRGBColors(0.0f, 0.0f, 0.0f);
+}
+
+/**
+ * Read the numbers left on a line of the file
+ * @param line {istringstream&}
+ * @return {vector<float>}
+ */
+static vector<float> readNumbers(istringstream& line) {
+    vector<float> numbers;
+    string word;
+    while (line >> word) {
+        istringstream number(word);
+        float value;
+        if (!(number >> value) || !number.eof()) {
+            throw invalid_argument("\"" + word + "\" is not a number");
+        }
+        numbers.push_back(value);
+    }
+    return numbers;
+}
+
+/**
+ * Make sure a command got as many numbers as it takes
+ * @param command {string}
+ * @param numbers {vector<float>}
+ * @param count {size_t}
+ */
+static void expectNumbers(const string& command, const vector<float>& numbers, size_t count) {
+    if (numbers.size() != count) {
+        ostringstream message;
+        message << command << " takes " << count << " numbers, not " << numbers.size();
+        throw invalid_argument(message.str());
+    }
+}
+
+/**
+ * Read a scene file
+ * @param path {string}
+ * @return {Scene}
+ */
+Scene SceneFile::read(const string& path) {
+    ifstream file(path.c_str());
+    if (!file) {
+        throw invalid_argument("Could not read the scene file " + path);
+    }
+    return SceneFile::parse(file, path);
+}
+
+/**
+ * Read a scene from its text (see SceneFile.hpp for the commands)
+ * @param input {istream&}
+ * @param name {string} - of the scene, in the error messages
+ * @return {Scene}
+ */
+Scene SceneFile::parse(istream& input, const string& name) {
+    TransformationMatrix *transformations = TransformationMatrix::getInstance();
+    Scene scene;
+    scene.name = name;
+    bool hasWindow = false;
+    Vertex2d color;
+    color.setRGBColors(1.0f, 1.0f, 1.0f);
+    // The transformations waiting for the next figure
+    PipelineFigure next;
+    
+    string text;
+    for (int lineNumber = 1; getline(input, text); lineNumber++) {
+        try {
+            text = text.substr(0, text.find('#'));
+            istringstream line(text);
+            string command;
+            if (!(line >> command)) {
+                continue;
+            }
+    
+            string style;
+            if (command == "polygon" && !(line >> style)) {
+                throw invalid_argument("polygon must be filled or outline");
+            }
+            vector<float> numbers = readNumbers(line);
+    
+            if (command == "size") {
+                expectNumbers(command, numbers, 2);
+                if (numbers[0] < 1 || numbers[1] < 1) {
+                    throw invalid_argument("The image must have at least one pixel");
+                }
+                scene.width = (int) numbers[0];
+                scene.height = (int) numbers[1];
+                continue;
+            }
+            if (command == "background") {
+                expectNumbers(command, numbers, 3);
+                scene.background.setRGBColors(numbers[0], numbers[1], numbers[2]);
+                continue;
+            }
+            if (command == "window") {
+                expectNumbers(command, numbers, 4);
+                scene.windowBottomLeft = Vertex2d(numbers[0], numbers[1]);
+                scene.windowTopRight = Vertex2d(numbers[2], numbers[3]);
+                hasWindow = true;
+                continue;
+            }
+            if (command == "color") {
+                expectNumbers(command, numbers, 3);
+                color.setRGBColors(numbers[0], numbers[1], numbers[2]);
+                continue;
+            }
+    
+            if (command == "translate" || command == "rotate" || command == "scale") {
+                Matrix2d matrix;
+                if (command == "translate") {
+                    expectNumbers(command, numbers, 2);
+                    matrix = transformations->getTranslationMatrix(numbers[0], numbers[1]);
+                } else if (command == "rotate") {
+                    expectNumbers(command, numbers, 3);
+                    matrix = transformations->getRotationMatrix(numbers[0], numbers[1], numbers[2]);
+                } else {
+                    expectNumbers(command, numbers, 4);
+                    matrix = transformations->getScaleMatrix(numbers[0], numbers[1], numbers[2], numbers[3]);
+                }
+                // The later transformations are applied after the earlier ones
+                next.transformation = next.hasTransformation ? matrix * next.transformation : matrix;
+                next.hasTransformation = true;
+                continue;
+            }
+    
+            if (scene.width == 0) {
+                throw invalid_argument("The size must come before the figures");
+            }
+    
+            if (command == "polygon") {
+                if (style != "filled" && style != "outline") {
+                    throw invalid_argument("polygon must be filled or outline, not " + style);
+                }
+                if (numbers.size() < 6 || numbers.size() % 2 != 0) {
+                    throw invalid_argument("polygon takes at least three pairs of coordinates");
+                }
+                next.type = POLYGON;
+                next.filled = style == "filled";
+                for (size_t i = 0; i < numbers.size(); i += 2) {
+                    next.vertices.push_back(Vertex2d(numbers[i], numbers[i + 1]));
+                }
+            } else if (command == "line") {
+                expectNumbers(command, numbers, 4);
+                next.type = LINE;
+                next.vertices.push_back(Vertex2d(numbers[0], numbers[1]));
+                next.vertices.push_back(Vertex2d(numbers[2], numbers[3]));
+            } else if (command == "circle") {
+                expectNumbers(command, numbers, 3);
+                next.type = CIRCUMFERENCE;
+                next.vertices.push_back(Vertex2d(numbers[0], numbers[1]));
+                next.radius = (int) numbers[2];
+            } else {
+                throw invalid_argument("Unknown command " + command);
+            }
+    
+            for (Vertex2d& vertice : next.vertices) {
+                vertice.setRGBColors(color.getRed(), color.getGreen(), color.getBlue());
+            }
+            scene.figures.push_back(next);
+            next = PipelineFigure();
+        } catch (const invalid_argument& error) {
+            ostringstream message;
+            message << name << ":" << lineNumber << ": " << error.what();
+            throw invalid_argument(message.str());
+        }
+    }
+    
+    if (scene.width == 0) {
+        throw invalid_argument(name + ": the scene has no size");
+    }
+    if (!hasWindow) {
+        scene.windowBottomLeft = Vertex2d(0, 0);
+        scene.windowTopRight = Vertex2d(scene.width - 1, scene.height - 1);
+    }
+    return scene;
+}
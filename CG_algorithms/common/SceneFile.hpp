@@ -0,0 +1,52 @@
+/**
+ * SceneFile.hpp
+ * Scenes described in text files, rendered by the batch renderer (see
+ * batch/BatchRenderer.hpp). One command per line, the numbers separated by
+ * spaces, and everything after a # is a comment:
+ *
+ *   size 640 480                     image size, required before the figures
+ *   background 0 0 0                 color of the empty pixels (RGB in [0, 1])
+ *   window 0 0 639 479               clipping window, the whole image by default
+ *   color 1 0 0                      color of the figures that follow
+ *   translate 10 20                  \
+ *   rotate 45 100 100                 | transformations of the next figure,
+ *   scale 2 2 100 100                /  angle in degrees, pivot at the end
+ *   polygon filled 0 0 0 50 50 50    filled polygon, or "polygon outline"
+ *   line 0 0 100 50
+ *   circle 320 240 100               center and radius
+ *
+ * Like in CommandBuffer, the transformations written before a figure are
+ * applied to it in order, and only to it.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef SceneFile_hpp
+#define SceneFile_hpp
+
+#include <istream>
+#include <string>
+#include <vector>
+#include "Vertex2d.hpp"
+#include "Pipeline.hpp"
+
+struct Scene {
+    Scene();
+    
+    std::string name;
+    int width;
+    int height;
+    Vertex2d background;
+    Vertex2d windowBottomLeft;
+    Vertex2d windowTopRight;
+    // Ready to go through Pipeline::process, in the order they are drawn
+    std::vector<PipelineFigure> figures;
+};
+
+class SceneFile {
+public:
+    static Scene read(const std::string& path);
+    static Scene parse(std::istream& input, const std::string& name);
+};
+
+#endif /* SceneFile_hpp */
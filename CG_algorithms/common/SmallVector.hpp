@@ -0,0 +1,164 @@
+/**
+ * SmallVector.hpp
+ * Contiguous container with room for N elements inside the object itself.
+ * Small polygons (squares, stars...) never touch the heap; bigger ones move
+ * to a heap block, like a std::vector. The elements are always contiguous,
+ * so they can be handed to the algorithms as a VertexSpan.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef SmallVector_hpp
+#define SmallVector_hpp
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+template <typename T, std::size_t N>
+class SmallVector {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    
+    SmallVector():elements(inlineElements()), count(0), capacityValue(N) {}
+    
+    SmallVector(const T* first, std::size_t size):elements(inlineElements()), count(0), capacityValue(N) {
+        this->assign(first, first + size);
+    }
+    
+    SmallVector(const SmallVector& other):elements(inlineElements()), count(0), capacityValue(N) {
+        this->assign(other.begin(), other.end());
+    }
+    
+    SmallVector(SmallVector&& other):elements(inlineElements()), count(0), capacityValue(N) {
+        this->takeFrom(other);
+    }
+    
+    ~SmallVector() {
+        this->clear();
+        this->releaseHeap();
+    }
+    
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            this->assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    
+    SmallVector& operator=(SmallVector&& other) {
+        if (this != &other) {
+            this->clear();
+            this->releaseHeap();
+            this->takeFrom(other);
+        }
+        return *this;
+    }
+    
+    std::size_t size() const { return this->count; }
+    std::size_t capacity() const { return this->capacityValue; }
+    bool empty() const { return this->count == 0; }
+    // Whether the elements still live inside the object
+    bool isInline() const { return this->elements == this->inlineElements(); }
+    
+    T* data() { return this->elements; }
+    const T* data() const { return this->elements; }
+    iterator begin() { return this->elements; }
+    iterator end() { return this->elements + this->count; }
+    const_iterator begin() const { return this->elements; }
+    const_iterator end() const { return this->elements + this->count; }
+    
+    T& operator[](std::size_t index) { return this->elements[index]; }
+    const T& operator[](std::size_t index) const { return this->elements[index]; }
+    T& front() { return this->elements[0]; }
+    const T& front() const { return this->elements[0]; }
+    T& back() { return this->elements[this->count - 1]; }
+    const T& back() const { return this->elements[this->count - 1]; }
+    
+    void push_back(const T& value) {
+        if (this->count == this->capacityValue) {
+            // value may live inside this container, so copy it before growing
+            T copy(value);
+            this->reserve(2 * this->capacityValue);
+            new (this->elements + this->count) T(std::move(copy));
+        } else {
+            new (this->elements + this->count) T(value);
+        }
+        this->count++;
+    }
+    
+    void pop_back() {
+        this->count--;
+        this->elements[this->count].~T();
+    }
+    
+    void clear() {
+        for (std::size_t i = 0; i < this->count; i++) {
+            this->elements[i].~T();
+        }
+        this->count = 0;
+    }
+    
+    void reserve(std::size_t newCapacity) {
+        if (newCapacity <= this->capacityValue) {
+            return;
+        }
+        
+        T *newElements = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+        for (std::size_t i = 0; i < this->count; i++) {
+            new (newElements + i) T(std::move(this->elements[i]));
+            this->elements[i].~T();
+        }
+        
+        this->releaseHeap();
+        this->elements = newElements;
+        this->capacityValue = newCapacity;
+    }
+    
+    void assign(const T* first, const T* last) {
+        this->clear();
+        this->reserve(last - first);
+        for (; first != last; first++, this->count++) {
+            new (this->elements + this->count) T(*first);
+        }
+    }
+private:
+    T* inlineElements() { return reinterpret_cast<T*>(this->storage); }
+    const T* inlineElements() const { return reinterpret_cast<const T*>(this->storage); }
+    
+    void releaseHeap() {
+        if (!this->isInline()) {
+            ::operator delete(this->elements);
+            this->elements = this->inlineElements();
+            this->capacityValue = N;
+        }
+    }
+    
+    // Move the elements of other into this (empty, inline) container
+    void takeFrom(SmallVector& other) {
+        if (other.isInline()) {
+            for (std::size_t i = 0; i < other.count; i++) {
+                new (this->elements + i) T(std::move(other.elements[i]));
+            }
+            this->count = other.count;
+            other.clear();
+        } else {
+            this->elements = other.elements;
+            this->count = other.count;
+            this->capacityValue = other.capacityValue;
+            other.elements = other.inlineElements();
+            other.count = 0;
+            other.capacityValue = N;
+        }
+    }
+    
+    T *elements;
+    std::size_t count;
+    std::size_t capacityValue;
+    typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage[N];
+};
+
+#endif /* SmallVector_hpp */
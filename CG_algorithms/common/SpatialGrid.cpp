@@ -0,0 +1,253 @@
+/**
+ * SpatialGrid.cpp
+ * Uniform grid over the bounding boxes of the figures.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "SpatialGrid.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+using namespace std;
+
+// Figures over more cells than this are tested by every query instead
+#define MAX_CELLS_PER_FIGURE 64
+
+/**
+ * Division rounded towards minus infinity, so the cells keep their size
+ * on the negative side of the axes too
+ * @param value {int}
+ * @param divisor {int} - positive
+ * @return {int}
+ */
+static int floorDivide(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+/**
+ * Key of a cell in the map of cells
+ * @param column {int}
+ * @param row {int}
+ * @return {long long}
+ */
+static long long getCellKey(int column, int row) {
+    return (long long) (((uint64_t) (uint32_t) column << 32) | (uint32_t) row);
+}
+
+/**
+ * Constructor of the class
+ * @param cellSize {int} - side of the cells, in pixels. About the size of a
+ *                         typical figure works best.
+ */
+SpatialGrid::SpatialGrid(int cellSize):cellSize(cellSize), queryStamp(0) {
+    if (cellSize <= 0) {
+        throw invalid_argument("The cells of the grid must have a positive size");
+    }
+}
+
+/**
+ * Add a figure to the grid, or tell the grid it moved or changed. A figure
+ * that stays in the same cells only has its box replaced.
+ * @param figureId {int}
+ * @param box {BoundingBox} - the new bounding box of the figure
+ */
+void SpatialGrid::update(int figureId, const BoundingBox& box) {
+    auto it = this->slots.find(figureId);
+    if (it != this->slots.end()) {
+        Entry& entry = this->entries[it->second];
+        BoundingBox cells = this->getCellRange(box);
+        entry.box = box;
+        if (cells != entry.cells) {
+            this->unlink(it->second);
+            entry.cells = cells;
+            this->link(it->second);
+        }
+        return;
+    }
+    
+    size_t slot;
+    if (this->freeSlots.empty()) {
+        slot = this->entries.size();
+        this->entries.push_back(Entry());
+    } else {
+        slot = this->freeSlots.back();
+        this->freeSlots.pop_back();
+    }
+    Entry& entry = this->entries[slot];
+    entry.figureId = figureId;
+    entry.box = box;
+    entry.cells = this->getCellRange(box);
+    entry.queryStamp = 0;
+    this->slots[figureId] = slot;
+    this->link(slot);
+}
+
+/**
+ * Take a figure out of the grid
+ * @param figureId {int}
+ */
+void SpatialGrid::remove(int figureId) {
+    auto it = this->slots.find(figureId);
+    if (it == this->slots.end()) {
+        return;
+    }
+    this->unlink(it->second);
+    this->freeSlots.push_back(it->second);
+    this->slots.erase(it);
+}
+
+bool SpatialGrid::contains(int figureId) const {
+    return this->slots.find(figureId) != this->slots.end();
+}
+
+/**
+ * Getter for the box of a figure
+ * @param figureId {int}
+ * @return {const BoundingBox&}
+ */
+const BoundingBox& SpatialGrid::getBox(int figureId) const {
+    auto it = this->slots.find(figureId);
+    if (it == this->slots.end()) {
+        throw invalid_argument("The figure is not in the grid");
+    }
+    return this->entries[it->second].box;
+}
+
+/**
+ * Number of figures in the grid
+ * @return {size_t}
+ */
+size_t SpatialGrid::size() const {
+    return this->slots.size();
+}
+
+void SpatialGrid::clear() {
+    this->entries.clear();
+    this->freeSlots.clear();
+    this->slots.clear();
+    this->cells.clear();
+    this->largeSlots.clear();
+}
+
+/**
+ * Find the figures whose box intersects a region. A figure is listed in
+ * several cells, so each query gets a new stamp and every figure is
+ * reported only the first time it is seen with it. The order of the
+ * figures is not specified.
+ * @param region {BoundingBox}
+ * @param figureIds {vector<int>&} - replaced by the figures found
+ */
+void SpatialGrid::query(const BoundingBox& region, vector<int>& figureIds) {
+    figureIds.clear();
+    if (region.isEmpty()) {
+        return;
+    }
+    this->queryStamp++;
+    
+    for (size_t slot : this->largeSlots) {
+        this->visit(slot, region, figureIds);
+    }
+    
+    BoundingBox range = this->getCellRange(region);
+    // A region bigger than the occupied part of the plane walks the stored cells instead
+    if ((unsigned long) range.getArea() > this->cells.size()) {
+        for (auto it = this->cells.begin(); it != this->cells.end(); it++) {
+            int column = (int) (uint32_t) ((uint64_t) it->first >> 32);
+            int row = (int) (uint32_t) it->first;
+            if (range.contains(column, row)) {
+                for (size_t slot : it->second) {
+                    this->visit(slot, region, figureIds);
+                }
+            }
+        }
+        return;
+    }
+    
+    for (int row = range.getYMin(); row <= range.getYMax(); row++) {
+        for (int column = range.getXMin(); column <= range.getXMax(); column++) {
+            auto it = this->cells.find(getCellKey(column, row));
+            if (it == this->cells.end()) {
+                continue;
+            }
+            for (size_t slot : it->second) {
+                this->visit(slot, region, figureIds);
+            }
+        }
+    }
+}
+
+/**
+ * The cells a box overlaps, as a box in cell coordinates
+ * @param box {BoundingBox}
+ * @return {BoundingBox} - empty for an empty box
+ */
+BoundingBox SpatialGrid::getCellRange(const BoundingBox& box) const {
+    if (box.isEmpty()) {
+        return BoundingBox();
+    }
+    return BoundingBox(floorDivide(box.getXMin(), this->cellSize), floorDivide(box.getYMin(), this->cellSize),
+                       floorDivide(box.getXMax(), this->cellSize), floorDivide(box.getYMax(), this->cellSize));
+}
+
+/**
+ * List a figure in the cells of its box, or with the large figures
+ * @param slot {size_t}
+ */
+void SpatialGrid::link(size_t slot) {
+    Entry& entry = this->entries[slot];
+    entry.large = entry.cells.getArea() > MAX_CELLS_PER_FIGURE;
+    if (entry.large) {
+        this->largeSlots.push_back(slot);
+        return;
+    }
+    for (int row = entry.cells.getYMin(); row <= entry.cells.getYMax(); row++) {
+        for (int column = entry.cells.getXMin(); column <= entry.cells.getXMax(); column++) {
+            this->cells[getCellKey(column, row)].push_back(slot);
+        }
+    }
+}
+
+/**
+ * Take a figure out of the cells it was listed in. Empty cells are dropped,
+ * so the figures moving around do not leave the map growing.
+ * @param slot {size_t}
+ */
+void SpatialGrid::unlink(size_t slot) {
+    const Entry& entry = this->entries[slot];
+    if (entry.large) {
+        this->largeSlots.erase(find(this->largeSlots.begin(), this->largeSlots.end(), slot));
+        return;
+    }
+    for (int row = entry.cells.getYMin(); row <= entry.cells.getYMax(); row++) {
+        for (int column = entry.cells.getXMin(); column <= entry.cells.getXMax(); column++) {
+            auto it = this->cells.find(getCellKey(column, row));
+            vector<size_t>& cell = it->second;
+            // The order in a cell does not matter, the last slot takes the place of the removed one
+            *find(cell.begin(), cell.end(), slot) = cell.back();
+            cell.pop_back();
+            if (cell.empty()) {
+                this->cells.erase(it);
+            }
+        }
+    }
+}
+
+/**
+ * Report a figure of a visited cell, once per query
+ * @param slot {size_t}
+ * @param region {BoundingBox}
+ * @param figureIds {vector<int>&}
+ */
+void SpatialGrid::visit(size_t slot, const BoundingBox& region, vector<int>& figureIds) {
+    Entry& entry = this->entries[slot];
+    if (entry.queryStamp == this->queryStamp) {
+        return;
+    }
+    entry.queryStamp = this->queryStamp;
+    if (entry.box.intersects(region)) {
+        figureIds.push_back(entry.figureId);
+    }
+}
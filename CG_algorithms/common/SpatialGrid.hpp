@@ -0,0 +1,59 @@
+/**
+ * SpatialGrid.hpp
+ * Uniform grid over the bounding boxes of the figures, to find the ones that
+ * may touch a region (the viewport window, a dirty region) without testing
+ * every figure of the scene. The plane is cut in square cells and every
+ * figure is listed in the cells its box overlaps; only the cells that hold
+ * figures are stored, so the grid has no bounds. A query visits the cells of
+ * the region, so it costs about the figures near the region, not the scene.
+ * Figures that would cover too many cells are kept in a list of their own,
+ * tested by every query.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef SpatialGrid_hpp
+#define SpatialGrid_hpp
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "BoundingBox.hpp"
+
+class SpatialGrid {
+public:
+    SpatialGrid(int cellSize = 64);
+    void update(int figureId, const BoundingBox& box);
+    void remove(int figureId);
+    bool contains(int figureId) const;
+    const BoundingBox& getBox(int figureId) const;
+    std::size_t size() const;
+    void clear();
+    // Not const: the query marks the figures it visits, see query()
+    void query(const BoundingBox& region, std::vector<int>& figureIds);
+private:
+    struct Entry {
+        int figureId;
+        BoundingBox box;
+        // The cells the box overlaps, in cell coordinates
+        BoundingBox cells;
+        bool large;
+        unsigned long queryStamp;
+    };
+    
+    BoundingBox getCellRange(const BoundingBox& box) const;
+    void link(std::size_t slot);
+    void unlink(std::size_t slot);
+    void visit(std::size_t slot, const BoundingBox& region, std::vector<int>& figureIds);
+    
+    int cellSize;
+    std::vector<Entry> entries;
+    std::vector<std::size_t> freeSlots;
+    std::unordered_map<int, std::size_t> slots;
+    // Slots of the figures in each cell, by the key of the cell
+    std::unordered_map<long long, std::vector<std::size_t>> cells;
+    std::vector<std::size_t> largeSlots;
+    unsigned long queryStamp;
+};
+
+#endif /* SpatialGrid_hpp */
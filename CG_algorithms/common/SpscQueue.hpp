@@ -0,0 +1,75 @@
+/**
+ * SpscQueue.hpp
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread. The elements live in a ring of Capacity slots (a power of two);
+ * pushing on a full queue or popping on an empty one fails instead of waiting.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef SpscQueue_hpp
+#define SpscQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+public:
+    SpscQueue():head(0), tail(0) {}
+    
+    /**
+     * Add an element to the queue. Only the producer thread may call it.
+     * @param value {T}
+     * @return {bool} - false when the queue is full
+     */
+    bool tryPush(const T& value) {
+        std::size_t currentHead = this->head.load(std::memory_order_relaxed);
+        if (currentHead - this->tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        this->slots[currentHead & (Capacity - 1)] = value;
+        this->head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * Take the oldest element of the queue. Only the consumer thread may call it.
+     * @param value {T&} - where the element is written
+     * @return {bool} - false when the queue is empty
+     */
+    bool tryPop(T& value) {
+        std::size_t currentTail = this->tail.load(std::memory_order_relaxed);
+        if (currentTail == this->head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = this->slots[currentTail & (Capacity - 1)];
+        this->tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * Number of elements in the queue; only exact when both threads are idle
+     * @return {size_t}
+     */
+    std::size_t size() const {
+        return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+    }
+    
+    bool empty() const {
+        return this->size() == 0;
+    }
+private:
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+    
+    T slots[Capacity];
+    // Head and tail are written by different threads, keep them on different cache lines
+    char slotsPadding[64];
+    std::atomic<std::size_t> head;
+    char headPadding[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail;
+};
+
+#endif /* SpscQueue_hpp */
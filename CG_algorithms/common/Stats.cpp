@@ -0,0 +1,184 @@
+/**
+ * Stats.cpp
+ * Instrumentation of the pipeline: counters and stage duration histograms.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Stats.hpp"
+#include "AllocationCounter.hpp"
+#include <iomanip>
+
+using namespace std;
+
+atomic<unsigned long> Stats::counters[COUNTER_COUNT];
+atomic<unsigned long> Stats::buckets[STAGE_COUNT][HISTOGRAM_BUCKETS];
+atomic<unsigned long> Stats::totalNanoseconds[STAGE_COUNT];
+atomic<unsigned long> Stats::maxNanoseconds[STAGE_COUNT];
+unsigned long Stats::dumpInterval = 100;
+unsigned long Stats::frames = 0;
+
+/**
+ * Whether the project was built with CG_ENABLE_STATS
+ * @return {bool}
+ */
+bool Stats::isEnabled() {
+#ifdef CG_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Record the duration of a stage in its histogram
+ * @param stage {Stage}
+ * @param nanoseconds {unsigned long}
+ */
+void Stats::record(Stage stage, unsigned long nanoseconds) {
+    unsigned long microseconds = nanoseconds / 1000;
+    int bucket = 0;
+    while (microseconds > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+        microseconds >>= 1;
+        bucket++;
+    }
+    
+    buckets[stage][bucket].fetch_add(1, memory_order_relaxed);
+    totalNanoseconds[stage].fetch_add(nanoseconds, memory_order_relaxed);
+    
+    unsigned long currentMax = maxNanoseconds[stage].load(memory_order_relaxed);
+    while (nanoseconds > currentMax &&
+           !maxNanoseconds[stage].compare_exchange_weak(currentMax, nanoseconds, memory_order_relaxed)) {}
+}
+
+/**
+ * Getter for a counter
+ * @param counter {Counter}
+ * @return {unsigned long}
+ */
+unsigned long Stats::getCounter(Counter counter) {
+    return counters[counter].load(memory_order_relaxed);
+}
+
+/**
+ * Getter for the histogram of a stage
+ * @param stage {Stage}
+ * @return {Histogram}
+ */
+Stats::Histogram Stats::getHistogram(Stage stage) {
+    Histogram histogram;
+    histogram.count = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        histogram.buckets[i] = buckets[stage][i].load(memory_order_relaxed);
+        histogram.count += histogram.buckets[i];
+    }
+    histogram.totalNanoseconds = totalNanoseconds[stage].load(memory_order_relaxed);
+    histogram.maxNanoseconds = maxNanoseconds[stage].load(memory_order_relaxed);
+    return histogram;
+}
+
+/**
+ * Name of a counter, as shown by dump
+ * @param counter {Counter}
+ * @return {const char*}
+ */
+const char* Stats::getCounterName(Counter counter) {
+    switch (counter) {
+        case EDGES_INSERTED: return "edges inserted";
+        case SCANLINES: return "scanlines";
+        case SPANS: return "spans";
+        case PIXELS_DDA: return "pixels (DDA)";
+        case PIXELS_BRESENHAM: return "pixels (Bresenham)";
+        case PIXELS_RUN_SLICE: return "pixels (run slice)";
+        case PIXELS_CIRCUMFERENCE: return "pixels (circumference)";
+        case PIXELS_SCAN_LINE: return "pixels (scan line)";
+        case PIXELS_WU: return "pixels (Wu)";
+        case PIXELS_COVERAGE: return "pixels (coverage)";
+        case PIXELS_TRIANGLES: return "pixels (triangles)";
+        case CLIP_ACCEPTED: return "clip accepted";
+        case CLIP_REJECTED: return "clip rejected";
+        case CLIP_INTERSECTED: return "clip intersected";
+        case MATRIX_MULTIPLIES: return "matrix multiplies";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Name of a stage, as shown by dump
+ * @param stage {Stage}
+ * @return {const char*}
+ */
+const char* Stats::getStageName(Stage stage) {
+    switch (stage) {
+        case STAGE_FRAME: return "frame";
+        case STAGE_CLEAR: return "clear";
+        case STAGE_DRAW: return "draw";
+        case STAGE_PRESENT: return "present";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Zero every counter and histogram
+ */
+void Stats::reset() {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counters[i].store(0, memory_order_relaxed);
+    }
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            buckets[stage][i].store(0, memory_order_relaxed);
+        }
+        totalNanoseconds[stage].store(0, memory_order_relaxed);
+        maxNanoseconds[stage].store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * Print the counters and the histograms of the stages
+ * @param out {ostream&}
+ */
+void Stats::dump(ostream& out) {
+    out << "--- stats ---" << endl;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        out << left << setw(24) << getCounterName(Counter(i)) << right << getCounter(Counter(i)) << endl;
+    }
+    if (AllocationCounter::isEnabled()) {
+        out << left << setw(24) << "allocations" << right << AllocationCounter::getAllocations() << endl;
+    }
+    
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        Histogram histogram = getHistogram(Stage(stage));
+        if (histogram.count == 0) {
+            continue;
+        }
+        
+        out << getStageName(Stage(stage)) << ": " << histogram.count << " samples, mean "
+            << fixed << setprecision(1) << histogram.totalNanoseconds / 1000.0 / histogram.count
+            << "us, max " << histogram.maxNanoseconds / 1000.0 << "us" << endl;
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            if (histogram.buckets[i] > 0) {
+                out << "  < " << setw(8) << (1ul << i) << "us  " << histogram.buckets[i] << endl;
+            }
+        }
+    }
+}
+
+/**
+ * Setter for how many frames go between two dumps of endFrame
+ * @param _frames {unsigned long} - 0 disables the dumps
+ */
+void Stats::setDumpInterval(unsigned long _frames) {
+    dumpInterval = _frames;
+}
+
+/**
+ * Mark the end of a frame, dumping the stats every dumpInterval frames
+ * @param out {ostream&}
+ */
+void Stats::endFrame(ostream& out) {
+    frames++;
+    if (dumpInterval > 0 && frames % dumpInterval == 0) {
+        dump(out);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * Stats.hpp
+ * Instrumentation of the pipeline: counters of the work done by each stage
+ * and histograms of the duration of the display stages. It only records
+ * when the project is built with CG_ENABLE_STATS defined; otherwise the
+ * CG_STATS_* macros expand to nothing, so the hot paths pay nothing, and
+ * every getter returns 0.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Stats_hpp
+#define Stats_hpp
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+class Stats {
+public:
+    enum Counter {
+        EDGES_INSERTED,
+        SCANLINES,
+        SPANS,
+        PIXELS_DDA,
+        PIXELS_BRESENHAM,
+        PIXELS_RUN_SLICE,
+        PIXELS_CIRCUMFERENCE,
+        PIXELS_SCAN_LINE,
+        PIXELS_WU,
+        PIXELS_COVERAGE,
+        PIXELS_TRIANGLES,
+        CLIP_ACCEPTED,
+        CLIP_REJECTED,
+        CLIP_INTERSECTED,
+        MATRIX_MULTIPLIES,
+        COUNTER_COUNT
+    };
+    
+    enum Stage {
+        STAGE_FRAME,
+        STAGE_CLEAR,
+        STAGE_DRAW,
+        STAGE_PRESENT,
+        STAGE_COUNT
+    };
+    
+    // Bucket i holds the durations in [2^(i-1), 2^i) microseconds; bucket 0 is below 1us
+    enum { HISTOGRAM_BUCKETS = 24 };
+    
+    struct Histogram {
+        unsigned long buckets[HISTOGRAM_BUCKETS];
+        unsigned long count;
+        unsigned long totalNanoseconds;
+        unsigned long maxNanoseconds;
+    };
+    
+    // Records the time between its construction and destruction in a stage
+    class ScopedTimer {
+    public:
+        ScopedTimer(Stage _stage):stage(_stage), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            Stats::record(this->stage, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count());
+        }
+    private:
+        Stage stage;
+        std::chrono::steady_clock::time_point start;
+    };
+    
+    static bool isEnabled();
+    static void add(Counter counter, unsigned long amount);
+    static void record(Stage stage, unsigned long nanoseconds);
+    static unsigned long getCounter(Counter counter);
+    static Histogram getHistogram(Stage stage);
+    static const char* getCounterName(Counter counter);
+    static const char* getStageName(Stage stage);
+    static void reset();
+    static void dump(std::ostream& out);
+    static void setDumpInterval(unsigned long frames);
+    static void endFrame(std::ostream& out);
+private:
+    static std::atomic<unsigned long> counters[COUNTER_COUNT];
+    static std::atomic<unsigned long> buckets[STAGE_COUNT][HISTOGRAM_BUCKETS];
+    static std::atomic<unsigned long> totalNanoseconds[STAGE_COUNT];
+    static std::atomic<unsigned long> maxNanoseconds[STAGE_COUNT];
+    static unsigned long dumpInterval;
+    static unsigned long frames;
+};
+
+/**
+ * Add to a counter
+ * @param counter {Counter}
+ * @param amount {unsigned long}
+ */
+inline void Stats::add(Counter counter, unsigned long amount) {
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+#define CG_STATS_CONCAT_(a, b) a##b
+#define CG_STATS_CONCAT(a, b) CG_STATS_CONCAT_(a, b)
+
+#ifdef CG_ENABLE_STATS
+#define CG_STATS_ADD(counter, amount) Stats::add(Stats::counter, (amount))
+#define CG_STATS_TIMER(stage) Stats::ScopedTimer CG_STATS_CONCAT(statsTimer, __LINE__)(Stats::stage)
+#define CG_STATS_END_FRAME(out) Stats::endFrame(out)
+#else
+#define CG_STATS_ADD(counter, amount) ((void) 0)
+#define CG_STATS_TIMER(stage) ((void) 0)
+#define CG_STATS_END_FRAME(out) ((void) 0)
+#endif
+
+#endif /* Stats_hpp */
@@ -0,0 +1,254 @@
+/**
+ * StreamingRenderer.cpp
+ * Renders a scene straight into an image file, a band of rows at a time.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "StreamingRenderer.hpp"
+#include "PixelSink.hpp"
+#include "Trace.hpp"
+#include "../polygons/Polygon.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Whether a figure is drawn from its scan lines instead of its points
+ * @param figure {const GeometricFigure*}
+ * @return {bool}
+ */
+static bool isFilledPolygon(const GeometricFigure *figure) {
+    return figure->getType() == POLYGON && static_cast<const Polygon*>(figure)->isFilled();
+}
+
+/**
+ * Constructor of the class
+ * @param width {int}
+ * @param height {int}
+ * @param bandHeight {int} - rows rendered before they are written
+ */
+StreamingRenderer::StreamingRenderer(int width, int height, int bandHeight):
+    width(width), height(height), band(width, bandHeight), peakActiveFigures(0) {
+    if (width <= 0 || height <= 0 || bandHeight <= 0) {
+        throw invalid_argument("The image and its bands must have at least one pixel");
+    }
+    this->background.setRGBColors(0.0f, 0.0f, 0.0f);
+}
+
+/**
+ * Color of the pixels no figure covers
+ * @param red {float}, green {float}, blue {float}
+ */
+void StreamingRenderer::setBackground(float red, float green, float blue) {
+    this->background.setRGBColors(red, green, blue);
+}
+
+/**
+ * Add a figure to the scene, over the ones added before.
+ * Polygons that are not filled, lines and circumferences must hold their points.
+ * @param figure {const GeometricFigure*} - not owned, it must outlive render()
+ */
+void StreamingRenderer::addFigure(const GeometricFigure *figure) {
+    PendingFigure pending;
+    pending.figure = figure;
+    pending.order = this->figures.size();
+    pending.topRow = this->getTopRow(figure);
+    this->figures.push_back(pending);
+}
+
+/**
+ * Row of the image where a figure starts, from the top, or the height of the
+ * image when it has nothing to draw. For filled polygons it may be a row above
+ * the first one they cover, which only activates them a little earlier.
+ * @param figure {const GeometricFigure*}
+ * @return {int}
+ */
+int StreamingRenderer::getTopRow(const GeometricFigure *figure) const {
+    float maxY = -INFINITY;
+    if (isFilledPolygon(figure)) {
+        // Polygons that can not be filled never start
+        if (static_cast<const Polygon*>(figure)->getVertices().size() < 3) {
+            return this->height;
+        }
+        for (const Vertex2d& vertice : static_cast<const Polygon*>(figure)->getVertices()) {
+            maxY = max(maxY, vertice.getY());
+        }
+        // The mirrored polygon starts on the scan line of its lowest vertice
+        return (int) floorf(this->height - maxY);
+    }
+    
+    if (figure->getPoints().empty()) {
+        return this->height;
+    }
+    for (const Vertex2d& point : figure->getPoints()) {
+        maxY = max(maxY, point.getY());
+    }
+    return this->height - 1 - (int) maxY;
+}
+
+/**
+ * Prepare a figure for the bands, keeping the figures in the order they were added
+ * @param pending {PendingFigure}
+ */
+void StreamingRenderer::activate(const PendingFigure& pending) {
+    list<ActiveFigure>::iterator position = this->activeFigures.end();
+    while (position != this->activeFigures.begin() && prev(position)->order > pending.order) {
+        position--;
+    }
+    ActiveFigure& active = *this->activeFigures.emplace(position);
+    active.figure = pending.figure;
+    active.order = pending.order;
+    active.hasPendingSpan = false;
+    active.nextPoint = 0;
+    
+    if (isFilledPolygon(pending.figure)) {
+        VertexSpan vertices = static_cast<const Polygon*>(pending.figure)->getVertices();
+        const Vertex2d& firstPoint = vertices.front();
+        active.color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    
+        // Mirror the polygon so its scan lines go from the top of the image down.
+        // y becomes height - y: the rows it covers stay the same ones
+        VertexBuffer mirrored(vertices.begin(), vertices.size());
+        for (Vertex2d& vertice : mirrored) {
+            vertice.setY(this->height - vertice.getY());
+        }
+        active.scanLines.reset(new ScanLinePixelGenerator(mirrored));
+        return;
+    }
+    
+    const vector<Vertex2d>& points = pending.figure->getPoints();
+    active.pointsByRow.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        active.pointsByRow[i] = i;
+    }
+    auto isAbove = [&points](size_t a, size_t b) {
+        return points[a].getY() > points[b].getY();
+    };
+    auto isBelow = [&points](size_t a, size_t b) {
+        return points[a].getY() < points[b].getY();
+    };
+    
+    // The points of a line already go up or down the image, only the other
+    // figures need a sort
+    if (is_sorted(active.pointsByRow.begin(), active.pointsByRow.end(), isBelow)) {
+        reverse(active.pointsByRow.begin(), active.pointsByRow.end());
+    }
+    if (!is_sorted(active.pointsByRow.begin(), active.pointsByRow.end(), isAbove)) {
+        sort(active.pointsByRow.begin(), active.pointsByRow.end(), isAbove);
+    }
+}
+
+/**
+ * Draw the part of a figure inside the current band
+ * @param active {ActiveFigure&}
+ * @param bandTop {int} - first row of the band in the image
+ * @param bandBottom {int} - last row of the band in the image
+ * @return {bool} - false when the figure has nothing below the band
+ */
+bool StreamingRenderer::drawIntoBand(ActiveFigure& active, int bandTop, int bandBottom) {
+    FramebufferPixelSink sink(this->band);
+    
+    if (active.scanLines) {
+        while (active.hasPendingSpan || active.scanLines->nextSpan(active.spanStart, active.spanEnd, active.spanRow)) {
+            // The span belongs to a band below, keep it for later
+            if (active.spanRow > bandBottom) {
+                active.hasPendingSpan = true;
+                return true;
+            }
+            active.hasPendingSpan = false;
+    
+            // Rows above the image are only walked through
+            if (active.spanRow >= bandTop) {
+                sink.span(active.spanStart, active.spanEnd, active.spanRow - bandTop, active.color);
+            }
+        }
+        return false;
+    }
+    
+    const vector<Vertex2d>& points = active.figure->getPoints();
+    for (; active.nextPoint < active.pointsByRow.size(); active.nextPoint++) {
+        const Vertex2d& point = points[active.pointsByRow[active.nextPoint]];
+        int row = this->height - 1 - (int) point.getY();
+        if (row > bandBottom) {
+            return true;
+        }
+        if (row >= bandTop) {
+            sink.plot((int) point.getX(), row - bandTop, point);
+        }
+    }
+    return false;
+}
+
+/**
+ * Render the scene into an image, a band after the other, from the top
+ * @param writer {ImageWriter&} - the file the rows go to
+ */
+void StreamingRenderer::render(ImageWriter& writer) {
+    CG_TRACE_SPAN("streamingRender", 0, (unsigned int) this->figures.size());
+    
+    // Stable, so the figures starting on the same row stay in the order they were added
+    vector<PendingFigure> pendingFigures(this->figures);
+    stable_sort(pendingFigures.begin(), pendingFigures.end(), [](const PendingFigure& a, const PendingFigure& b) {
+        return a.topRow < b.topRow;
+    });
+    
+    writer.begin(this->width, this->height);
+    this->activeFigures.clear();
+    this->peakActiveFigures = 0;
+    size_t nextFigure = 0;
+    int bandHeight = this->band.getHeight();
+    const unsigned char *bandPixels = this->band.getPixels();
+    
+    for (int bandTop = 0; bandTop < this->height; bandTop += bandHeight) {
+        int bandBottom = min(bandTop + bandHeight, this->height) - 1;
+        this->band.clear(this->background.getRed(), this->background.getGreen(), this->background.getBlue());
+    
+        while (nextFigure < pendingFigures.size() && pendingFigures[nextFigure].topRow <= bandBottom) {
+            this->activate(pendingFigures[nextFigure++]);
+        }
+        this->peakActiveFigures = max(this->peakActiveFigures, this->activeFigures.size());
+    
+        for (list<ActiveFigure>::iterator it = this->activeFigures.begin(); it != this->activeFigures.end();) {
+            if (this->drawIntoBand(*it, bandTop, bandBottom)) {
+                it++;
+            } else {
+                it = this->activeFigures.erase(it);
+            }
+        }
+    
+        for (int row = bandTop; row <= bandBottom; row++) {
+            writer.writeRow(bandPixels + 3 * (size_t) (row - bandTop) * this->width);
+        }
+    }
+    
+    this->activeFigures.clear();
+    writer.finish();
+}
+
+/**
+ * Getters for the size of the image and of the bands
+ * @return {int}
+ */
+int StreamingRenderer::getWidth() const {
+    return this->width;
+}
+
+int StreamingRenderer::getHeight() const {
+    return this->height;
+}
+
+int StreamingRenderer::getBandHeight() const {
+    return this->band.getHeight();
+}
+
+/**
+ * Most figures active at once in the last render, which bounds its memory
+ * with the band
+ * @return {size_t}
+ */
+size_t StreamingRenderer::getPeakActiveFigures() const {
+    return this->peakActiveFigures;
+}
@@ -0,0 +1,83 @@
+/**
+ * StreamingRenderer.hpp
+ * Renders a scene straight into an image file, a band of rows at a time, for
+ * canvases too big to hold in a Framebuffer. The figures are sorted by their
+ * top row (the biggest y of their edges table). Going down the image, a figure
+ * becomes active when the band reaches its top row and is dropped after its
+ * last row, and each band goes to the ImageWriter as soon as every active
+ * figure drew its part of it: no figure left can touch those rows anymore.
+ *
+ * Filled polygons keep only the state of the Scan Line algorithm, which goes
+ * down one band after the other (see ScanLinePixelGenerator::nextSpan). The
+ * other figures draw the points they hold. So the memory is the band plus the
+ * active figures, whatever the height of the image.
+ *
+ * The image has its top row first, while the y of the scene grows upwards like
+ * in the Framebuffer: the scene is mirrored before it is rasterized, which may
+ * move the border pixels of sloped edges by one compared to the Framebuffer.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef StreamingRenderer_hpp
+#define StreamingRenderer_hpp
+
+#include <vector>
+#include <list>
+#include <memory>
+#include "Framebuffer.hpp"
+#include "GeometricFigure.hpp"
+#include "ImageWriter.hpp"
+#include "../polygons/ScanLinePixelGenerator.hpp"
+
+class StreamingRenderer {
+public:
+    StreamingRenderer(int width, int height, int bandHeight = 64);
+    void setBackground(float red, float green, float blue);
+    void addFigure(const GeometricFigure *figure);
+    void render(ImageWriter& writer);
+    int getWidth() const;
+    int getHeight() const;
+    int getBandHeight() const;
+    std::size_t getPeakActiveFigures() const;
+private:
+    StreamingRenderer(const StreamingRenderer&);
+    StreamingRenderer& operator=(const StreamingRenderer&);
+    
+    // A figure of the scene, in the order it was added
+    struct PendingFigure {
+        const GeometricFigure *figure;
+        std::size_t order;
+        int topRow;
+    };
+    
+    // A figure the bands are going through
+    struct ActiveFigure {
+        const GeometricFigure *figure;
+        std::size_t order;
+        Vertex2d color;
+        // Filled polygons: the scan lines, and the first span below the last band
+        std::unique_ptr<ScanLinePixelGenerator> scanLines;
+        bool hasPendingSpan;
+        int spanStart, spanEnd, spanRow;
+        // Other figures: their points, sorted by row
+        std::vector<std::size_t> pointsByRow;
+        std::size_t nextPoint;
+    };
+    
+    int getTopRow(const GeometricFigure *figure) const;
+    void activate(const PendingFigure& pending);
+    bool drawIntoBand(ActiveFigure& active, int bandTop, int bandBottom);
+    
+    int width;
+    int height;
+    Vertex2d background;
+    std::vector<PendingFigure> figures;
+    // Sorted by order, so the figures added last are drawn over the others
+    std::list<ActiveFigure> activeFigures;
+    // The rows of the current band; its row 0 is the top one
+    Framebuffer band;
+    std::size_t peakActiveFigures;
+};
+
+#endif /* StreamingRenderer_hpp */
@@ -0,0 +1,282 @@
+/**
+ * Trace.cpp
+ * Timeline of the pipeline stages, written as Chrome trace-event JSON.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Trace.hpp"
+#include "SpscQueue.hpp"
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace std;
+
+// Number of events each thread can hold before the flusher drains them
+#define TRACE_RING_CAPACITY 16384
+
+// How often the flusher drains the rings, in milliseconds
+#define TRACE_FLUSH_INTERVAL 10
+
+// Ring of one thread: that thread pushes, the flusher pops
+struct TraceRing {
+    SpscQueue<TraceEvent, TRACE_RING_CAPACITY> events;
+    unsigned int threadId;
+    atomic<unsigned long> dropped;
+    bool named;
+    // Set when the thread is gone: the flusher frees the ring once drained
+    bool exited;
+};
+
+// Owner of the ring of a thread. When the thread exits, the ring goes to the
+// flusher for a last drain, or is freed at once when no trace is written
+struct TraceRingOwner {
+    TraceRing *ring;
+    
+    TraceRingOwner():ring(NULL) {}
+    ~TraceRingOwner();
+};
+
+atomic<bool> Trace::recording(false);
+
+static mutex ringsMutex;
+static vector<TraceRing*> rings;
+static unsigned int nextThreadId = 1;
+static unsigned long droppedByExitedThreads = 0;
+static thread_local TraceRingOwner threadRing;
+
+static mutex fileMutex;
+static FILE *traceFile = NULL;
+static bool firstEvent = true;
+static thread flusher;
+static atomic<bool> flusherRunning(false);
+static chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+/**
+ * Name of a figure type, as shown in the trace
+ * @param figureType {int}
+ * @return {const char*}
+ */
+static const char* getFigureName(int figureType) {
+    switch (figureType) {
+        case LINE: return "LINE";
+        case POLYGON: return "POLYGON";
+        case CIRCUMFERENCE: return "CIRCUMFERENCE";
+        default: return NULL;
+    }
+}
+
+/**
+ * Free the ring of a thread that exited, keeping its count of dropped events.
+ * Only called with ringsMutex locked.
+ * @param ring {TraceRing*}
+ */
+static void releaseRing(TraceRing *ring) {
+    droppedByExitedThreads += ring->dropped.load(memory_order_relaxed);
+    rings.erase(find(rings.begin(), rings.end(), ring));
+    delete ring;
+}
+
+/**
+ * Destructor of the owner, run when its thread exits
+ */
+TraceRingOwner::~TraceRingOwner() {
+    if (!this->ring) {
+        return;
+    }
+    lock_guard<mutex> fileLock(fileMutex);
+    lock_guard<mutex> lock(ringsMutex);
+    if (traceFile) {
+        this->ring->exited = true;
+    } else {
+        releaseRing(this->ring);
+    }
+}
+
+/**
+ * Write the events waiting in every ring to the trace file, and free the
+ * rings of the threads that exited. Only called with fileMutex locked.
+ */
+static void drainRings() {
+    lock_guard<mutex> lock(ringsMutex);
+    TraceEvent event;
+    vector<TraceRing*> exitedRings;
+    
+    for (TraceRing *ring : rings) {
+        if (!ring->named) {
+            fprintf(traceFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                    firstEvent ? "" : ",\n", ring->threadId, ring->threadId);
+            firstEvent = false;
+            ring->named = true;
+        }
+        
+        while (ring->events.tryPop(event)) {
+            fprintf(traceFile, "%s{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                    firstEvent ? "" : ",\n", event.name, event.startNanoseconds / 1000.0,
+                    event.durationNanoseconds / 1000.0, ring->threadId);
+            firstEvent = false;
+            
+            const char *figureName = getFigureName(event.figureType);
+            if (figureName) {
+                fprintf(traceFile, ",\"args\":{\"figure\":\"%s\",\"vertices\":%u}", figureName, event.vertexCount);
+            }
+            fputs("}", traceFile);
+        }
+        
+        // Its thread is gone, so nothing else is pushed to it
+        if (ring->exited) {
+            exitedRings.push_back(ring);
+        }
+    }
+    
+    for (TraceRing *ring : exitedRings) {
+        releaseRing(ring);
+    }
+}
+
+/**
+ * Body of the flusher thread: drain the rings until the trace stops
+ */
+static void flushPeriodically() {
+    while (flusherRunning.load()) {
+        {
+            lock_guard<mutex> lock(fileMutex);
+            drainRings();
+        }
+        this_thread::sleep_for(chrono::milliseconds(TRACE_FLUSH_INTERVAL));
+    }
+}
+
+/**
+ * Constructor of the span. Nothing is measured when no trace is being written.
+ * @param name {const char*} - must outlive the trace, a string literal
+ * @param figureType {int} - a GeometricFigureType, or NO_FIGURE
+ * @param vertexCount {unsigned int}
+ */
+Trace::Span::Span(const char *name, int figureType, unsigned int vertexCount):recording(Trace::isRecording()) {
+    if (this->recording) {
+        this->event.name = name;
+        this->event.figureType = figureType;
+        this->event.vertexCount = vertexCount;
+        this->event.startNanoseconds = Trace::now();
+    }
+}
+
+/**
+ * Destructor of the span, where it is recorded
+ */
+Trace::Span::~Span() {
+    if (this->recording) {
+        this->event.durationNanoseconds = Trace::now() - this->event.startNanoseconds;
+        Trace::record(this->event);
+    }
+}
+
+/**
+ * Whether the project was built with CG_ENABLE_TRACE
+ * @return {bool}
+ */
+bool Trace::isEnabled() {
+#ifdef CG_ENABLE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Start writing a trace. The flusher thread starts with it.
+ * @param path {string} - the JSON file to write
+ */
+void Trace::start(const string& path) {
+    lock_guard<mutex> lock(fileMutex);
+    if (traceFile) {
+        throw invalid_argument("A trace is already being written");
+    }
+    
+    traceFile = fopen(path.c_str(), "w");
+    if (!traceFile) {
+        throw invalid_argument("Could not write the trace file " + path);
+    }
+    
+    fputs("{\"traceEvents\":[\n", traceFile);
+    firstEvent = true;
+    {
+        lock_guard<mutex> ringsLock(ringsMutex);
+        for (TraceRing *ring : rings) {
+            ring->named = false;
+        }
+    }
+    
+    flusherRunning.store(true);
+    flusher = thread(flushPeriodically);
+    recording.store(true);
+}
+
+/**
+ * Stop the trace, writing the events left in the rings and closing the file
+ */
+void Trace::stop() {
+    if (!recording.exchange(false)) {
+        return;
+    }
+    
+    flusherRunning.store(false);
+    flusher.join();
+    
+    lock_guard<mutex> lock(fileMutex);
+    drainRings();
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", traceFile);
+    fclose(traceFile);
+    traceFile = NULL;
+}
+
+/**
+ * Push an event to the ring of the calling thread. When the ring is full,
+ * the event is dropped instead of waiting for the flusher.
+ * @param event {TraceEvent}
+ */
+void Trace::record(const TraceEvent& event) {
+    TraceRing *ring = threadRing.ring;
+    if (!ring) {
+        ring = new TraceRing();
+        ring->dropped.store(0);
+        ring->named = false;
+        ring->exited = false;
+        
+        lock_guard<mutex> lock(ringsMutex);
+        ring->threadId = nextThreadId++;
+        rings.push_back(ring);
+        threadRing.ring = ring;
+    }
+    
+    if (!ring->events.tryPush(event)) {
+        ring->dropped.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+/**
+ * Time since the program started
+ * @return {unsigned long long} - in nanoseconds
+ */
+unsigned long long Trace::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+/**
+ * Number of events lost because a ring was full
+ * @return {unsigned long}
+ */
+unsigned long Trace::getDroppedEvents() {
+    lock_guard<mutex> lock(ringsMutex);
+    unsigned long dropped = droppedByExitedThreads;
+    for (TraceRing *ring : rings) {
+        dropped += ring->dropped.load(memory_order_relaxed);
+    }
+    return dropped;
+}
@@ -0,0 +1,72 @@
+/**
+ * Trace.hpp
+ * Timeline of the pipeline stages, written as Chrome trace-event JSON (open it
+ * in chrome://tracing or ui.perfetto.dev). Each thread records its spans in
+ * its own lock-free ring, and a background thread drains the rings into the
+ * file, so the hot path never touches the file. The spans are only recorded
+ * when the project is built with CG_ENABLE_TRACE defined; otherwise the
+ * CG_TRACE_SPAN macro expands to nothing.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Trace_hpp
+#define Trace_hpp
+
+#include <atomic>
+#include <string>
+#include "GeometricFigure.hpp"
+
+// A span not related to a figure
+#define NO_FIGURE (-1)
+
+struct TraceEvent {
+    const char *name;
+    int figureType;
+    unsigned int vertexCount;
+    unsigned long long startNanoseconds;
+    unsigned long long durationNanoseconds;
+};
+
+class Trace {
+public:
+    // Records a span from its construction to its destruction
+    class Span {
+    public:
+        Span(const char *name, int figureType = NO_FIGURE, unsigned int vertexCount = 0);
+        ~Span();
+    private:
+        Span(const Span&);
+        Span& operator=(const Span&);
+        TraceEvent event;
+        bool recording;
+    };
+    
+    static bool isEnabled();
+    static bool isRecording();
+    static void start(const std::string& path);
+    static void stop();
+    static void record(const TraceEvent& event);
+    static unsigned long long now();
+    static unsigned long getDroppedEvents();
+private:
+    static std::atomic<bool> recording;
+};
+
+/**
+ * Whether a trace is being written
+ * @return {bool}
+ */
+inline bool Trace::isRecording() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+#ifdef CG_ENABLE_TRACE
+#define CG_TRACE_CONCAT_(a, b) a##b
+#define CG_TRACE_CONCAT(a, b) CG_TRACE_CONCAT_(a, b)
+#define CG_TRACE_SPAN(...) Trace::Span CG_TRACE_CONCAT(traceSpan, __LINE__)(__VA_ARGS__)
+#else
+#define CG_TRACE_SPAN(...) ((void) 0)
+#endif
+
+#endif /* Trace_hpp */
@@ -7,24 +7,27 @@
  */
 
 #include "Vertex2d.hpp"
+#include <stdint.h>
 
 /**
  * Constructor that initialize all the coordinates to 0
  */
-Vertex2d::Vertex2d() {
-    this->setX(0.0f);
-    this->setY(0.0f);
-    this->setZ(1.0f);
+template <typename T>
+BasicVertex2d<T>::BasicVertex2d() {
+    this->setX(0);
+    this->setY(0);
+    this->setZ(1);
     this->setRGBColors(1.0, 1.0, 1.0);
 }
 
 /**
  * @constructor
- * @param {float} - the x coordinate of the point
- * @param {float} - the y coordinate of the point
- * @param {float} - the z parameter of the point
+ * @param {T} - the x coordinate of the point
+ * @param {T} - the y coordinate of the point
+ * @param {T} - the z parameter of the point
  */
-Vertex2d::Vertex2d(float x, float y, float z) {
+template <typename T>
+BasicVertex2d<T>::BasicVertex2d(T x, T y, T z) {
     this->setX(x);
     this->setY(y);
     this->setZ(z);
@@ -33,44 +36,49 @@ Vertex2d::Vertex2d(float x, float y, float z) {
 
 /**
  * @constructor
- * @param {float} - the x coordinate of the point
- * @param {float} - the y coordinate of the point
+ * @param {T} - the x coordinate of the point
+ * @param {T} - the y coordinate of the point
  */
-Vertex2d::Vertex2d(float x, float y) {
+template <typename T>
+BasicVertex2d<T>::BasicVertex2d(T x, T y) {
     this->setX(x);
     this->setY(y);
-    this->setZ(1.0f);
+    this->setZ(1);
     this->setRGBColors(1.0, 1.0, 1.0);
 }
 
 /**
  * Overload handler for the less than operator
  */
-bool Vertex2d::operator<(const Vertex2d& point) const {
+template <typename T>
+bool BasicVertex2d<T>::operator<(const BasicVertex2d& point) const {
     return this->y < point.getY();
 }
 
 /**
  * Getter for the x coordinate
- * @return {float}
+ * @return {T}
  */
-float Vertex2d::getX() const {
+template <typename T>
+T BasicVertex2d<T>::getX() const {
     return this->x;
 }
 
 /**
  * Getter for the y coordinate
- * @return {float}
+ * @return {T}
  */
-float Vertex2d::getY() const {
+template <typename T>
+T BasicVertex2d<T>::getY() const {
     return this->y;
 }
 
 /**
  * Gets the z value of the vertex
- * @return {float}
+ * @return {T}
  */
-float Vertex2d::getZ() const {
+template <typename T>
+T BasicVertex2d<T>::getZ() const {
     return this->z;
 }
 
@@ -78,7 +86,8 @@ float Vertex2d::getZ() const {
  * Get the red ammount of the vertex
  * @return {float}
  */
-float Vertex2d::getRed() const {
+template <typename T>
+float BasicVertex2d<T>::getRed() const {
     return this->red;
 }
 
@@ -86,7 +95,8 @@ float Vertex2d::getRed() const {
  * Get the green ammount of the vertex
  * @return {float}
  */
-float Vertex2d::getGreen() const {
+template <typename T>
+float BasicVertex2d<T>::getGreen() const {
     return this->green;
 }
 
@@ -94,31 +104,35 @@ float Vertex2d::getGreen() const {
  * Get the blue ammount of the vertex
  * @return {float}
  */
-float Vertex2d::getBlue() const {
+template <typename T>
+float BasicVertex2d<T>::getBlue() const {
     return this->blue;
 }
 
 /**
  * Setter for the x coordinate
- * @param _x {float} - the new x coordinate
+ * @param _x {T} - the new x coordinate
  */
-void Vertex2d::setX(float _x) {
+template <typename T>
+void BasicVertex2d<T>::setX(T _x) {
     this->x = _x;
 }
 
 /**
  * Setter for the y coordinate
- * @param _y {float} - the new y coordinate
+ * @param _y {T} - the new y coordinate
  */
-void Vertex2d::setY(float _y) {
+template <typename T>
+void BasicVertex2d<T>::setY(T _y) {
     this->y = _y;
 }
 
 /**
  * Setter for the z coordinate
- * @param _z {float} - the new z coordinate
+ * @param _z {T} - the new z coordinate
  */
-void Vertex2d::setZ(float _z) {
+template <typename T>
+void BasicVertex2d<T>::setZ(T _z) {
     this->z = _z;
 }
 
@@ -126,7 +140,8 @@ void Vertex2d::setZ(float _z) {
  * Set the red ammount of the vertex
  * @param _red {float}
  */
-void Vertex2d::setRed(float _red) {
+template <typename T>
+void BasicVertex2d<T>::setRed(float _red) {
     this->red = _red;
 }
 
@@ -134,7 +149,8 @@ void Vertex2d::setRed(float _red) {
  * Setter for green ammount of the vertex
  * @param _green {float}
  */
-void Vertex2d::setGreen(float _green) {
+template <typename T>
+void BasicVertex2d<T>::setGreen(float _green) {
     this->green = _green;
 }
 
@@ -142,11 +158,13 @@ void Vertex2d::setGreen(float _green) {
  * Setter for blue ammount of the vertex
  * @param _blue {float}
  */
-void Vertex2d::setBlue(float _blue) {
+template <typename T>
+void BasicVertex2d<T>::setBlue(float _blue) {
     this->blue = _blue;
 }
 
-void Vertex2d::setRGBColors(float _red, float _green, float _blue) {
+template <typename T>
+void BasicVertex2d<T>::setRGBColors(float _red, float _green, float _blue) {
     this->setRed(_red);
     this->setGreen(_green);
     this->setBlue(_blue);
@@ -156,7 +174,15 @@ void Vertex2d::setRGBColors(float _red, float _green, float _blue) {
  * Returns the length of this vector (Read Only)
  * @return {float}
  */
-float Vertex2d::magnitude() const {
-    float _magnitude = sqrt(x*x + y*y);
+template <typename T>
+float BasicVertex2d<T>::magnitude() const {
+    typedef typename CoordinateTraits<T>::Real Real;
+    float _magnitude = sqrt((Real) x * x + (Real) y * y);
     return _magnitude;
-}
\ No newline at end of file
+}
+
+// The coordinate types the vertices are built for, see Vertex2d.hpp
+template class BasicVertex2d<int16_t>;
+template class BasicVertex2d<int32_t>;
+template class BasicVertex2d<float>;
+template class BasicVertex2d<double>;
@@ -2,6 +2,12 @@
  * Vertex2d.hpp
  * Class that represent a coordinate in two dimensions. It is used
  * in the Scan Line algorithm
+ *
+ * The coordinates are of any of the types BasicVertex2d is instantiated for
+ * (int16_t, int32_t, float and double), so each workload can keep its
+ * vertices in the narrowest type that holds them, or in double for canvases
+ * past 2^24 pixels. The colors are always float. Vertex2d, the float one, is
+ * the one the figures keep.
  * @author Lucas Pinheiro (@lucaspin)
  * @author Dalton Lima (@daltonbr)
  */
@@ -11,37 +17,83 @@
 
 #include <list>
 #include <math.h>
+#include <cmath>
+#include <stdint.h>
 
-class Vertex2d {
+template <typename T>
+class BasicVertex2d {
 public:
+    typedef T Coordinate;
     
-    Vertex2d();
-    Vertex2d(float, float, float);
-    Vertex2d(float, float);
-    float getX() const;
-    float getY() const;
-    float getZ() const;
+    BasicVertex2d();
+    BasicVertex2d(T, T, T);
+    BasicVertex2d(T, T);
+    template <typename U> explicit BasicVertex2d(const BasicVertex2d<U>&);
+    T getX() const;
+    T getY() const;
+    T getZ() const;
     float getRed() const;
     float getGreen() const;
     float getBlue() const;
-    void setX(float);
-    void setY(float);
-    void setZ(float);
+    void setX(T);
+    void setY(T);
+    void setZ(T);
     void setRed(float);
     void setGreen(float);
     void setBlue(float);
     void setRGBColors(float, float, float);
-    bool operator<(const Vertex2d&) const;
+    bool operator<(const BasicVertex2d&) const;
     float magnitude() const;
-    Vertex2d normalized() const;
-    
+    BasicVertex2d normalized() const;
+
 private:
-    float x;
-    float y;
-    float z;
+    T x;
+    T y;
+    T z;
     float red;
     float green;
     float blue;
 };
 
+typedef BasicVertex2d<float> Vertex2d;
+
+/**
+ * Converting constructor, between vertices of different coordinate types.
+ * The coordinates are converted as by a cast, the colors are kept.
+ * @param other {BasicVertex2d<U>}
+ */
+template <typename T>
+template <typename U>
+BasicVertex2d<T>::BasicVertex2d(const BasicVertex2d<U>& other):
+    x((T) other.getX()), y((T) other.getY()), z((T) other.getZ()),
+    red(other.getRed()), green(other.getGreen()), blue(other.getBlue()) {}
+
+/**
+ * How the rasterizers treat a coordinate type. Real is the type they step
+ * along the figures with: float, except for the types whose values float
+ * can not hold exactly. toPixel rounds a coordinate to the nearest pixel;
+ * the integer types are pixels already, so they are not converted at all.
+ */
+template <typename T> struct CoordinateTraits;
+
+template <> struct CoordinateTraits<int16_t> {
+    typedef float Real;
+    static int toPixel(int16_t value) { return value; }
+};
+
+template <> struct CoordinateTraits<int32_t> {
+    typedef double Real;
+    static int toPixel(int32_t value) { return value; }
+};
+
+template <> struct CoordinateTraits<float> {
+    typedef float Real;
+    static int toPixel(float value) { return (int) lround(value); }
+};
+
+template <> struct CoordinateTraits<double> {
+    typedef double Real;
+    static int toPixel(double value) { return (int) lround(value); }
+};
+
 #endif /* Vertex2d_hpp */
@@ -0,0 +1,53 @@
+/**
+ * VertexSpan.hpp
+ * Read only view over contiguous vertices. It does not own nor copy them,
+ * so it is cheap to pass around by value. The polygon algorithms take their
+ * vertices as a VertexSpan, whatever container holds them. Like the
+ * vertices, it is a template on the coordinate type (see Vertex2d.hpp).
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef VertexSpan_hpp
+#define VertexSpan_hpp
+
+#include <cstddef>
+#include <vector>
+#include "Vertex2d.hpp"
+#include "SmallVector.hpp"
+
+// Owning storage for the vertices of a polygon; up to 16 vertices live inline
+typedef SmallVector<Vertex2d, 16> VertexBuffer;
+
+template <typename T>
+class BasicVertexSpan {
+public:
+    typedef const BasicVertex2d<T>* const_iterator;
+    typedef const BasicVertex2d<T>* iterator;
+    
+    BasicVertexSpan():first(NULL), count(0) {}
+    BasicVertexSpan(const BasicVertex2d<T> *_first, std::size_t _count):first(_first), count(_count) {}
+    BasicVertexSpan(const std::vector<BasicVertex2d<T>>& vertices):first(vertices.data()), count(vertices.size()) {}
+    
+    template <std::size_t N>
+    BasicVertexSpan(const SmallVector<BasicVertex2d<T>, N>& vertices):first(vertices.data()), count(vertices.size()) {}
+    
+    template <std::size_t N>
+    BasicVertexSpan(const BasicVertex2d<T> (&vertices)[N]):first(vertices), count(N) {}
+    
+    std::size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+    const BasicVertex2d<T>* data() const { return this->first; }
+    const_iterator begin() const { return this->first; }
+    const_iterator end() const { return this->first + this->count; }
+    const BasicVertex2d<T>& operator[](std::size_t index) const { return this->first[index]; }
+    const BasicVertex2d<T>& front() const { return this->first[0]; }
+    const BasicVertex2d<T>& back() const { return this->first[this->count - 1]; }
+private:
+    const BasicVertex2d<T> *first;
+    std::size_t count;
+};
+
+typedef BasicVertexSpan<float> VertexSpan;
+
+#endif /* VertexSpan_hpp */
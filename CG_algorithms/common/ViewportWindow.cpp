@@ -6,6 +6,7 @@
  */
 
 #include "ViewportWindow.hpp"
+#include <cmath>
 
 using namespace std;
 
@@ -14,16 +15,44 @@ using namespace std;
  * @param _bottomLeftCorner {Vertex2d}
  * @param _topRightCorner {Vertex2d}
  */
-ViewportWindow::ViewportWindow(Vertex2d _bottomLeftCorner, Vertex2d _topRightCorner) {
+ViewportWindow::ViewportWindow(const Vertex2d& _bottomLeftCorner, const Vertex2d& _topRightCorner) {
     this->setBottomLeftCorner(_bottomLeftCorner);
     this->setTopRightCorner(_topRightCorner);
 }
 
+/**
+ * Destructor. Deletes the clipped figures created by the window.
+ */
+ViewportWindow::~ViewportWindow() {
+    this->clearVisibleObjects();
+}
+
+/**
+ * Delete the clipped figures created by the window so far.
+ * GeometricFigure has no virtual destructor, so we delete them by their type.
+ */
+void ViewportWindow::clearVisibleObjects() {
+    for (GeometricFigure *figure : this->visibleObjects) {
+        switch (figure->getType()) {
+            case LINE:
+                delete static_cast<Line*>(figure);
+                break;
+            case POLYGON:
+                delete static_cast<Polygon*>(figure);
+                break;
+            case CIRCUMFERENCE:
+                delete static_cast<Circumference*>(figure);
+                break;
+        }
+    }
+    this->visibleObjects.clear();
+}
+
 /**
  * Setter for the bottomLeftCorner
  * @param _bottomLeftCorner {Vertex2d}
  */
-void ViewportWindow::setBottomLeftCorner(Vertex2d _bottomLeftCorner) {
+void ViewportWindow::setBottomLeftCorner(const Vertex2d& _bottomLeftCorner) {
     this->bottomLeftCorner = _bottomLeftCorner;
 }
 
@@ -31,7 +60,7 @@ void ViewportWindow::setBottomLeftCorner(Vertex2d _bottomLeftCorner) {
  * Setter for the topRightCorner
  * @param _topRightCorner {Vertex2d}
  */
-void ViewportWindow::setTopRightCorner(Vertex2d _topRightCorner) {
+void ViewportWindow::setTopRightCorner(const Vertex2d& _topRightCorner) {
     this->topRightCorner = _topRightCorner;
 }
 
@@ -39,7 +68,7 @@ void ViewportWindow::setTopRightCorner(Vertex2d _topRightCorner) {
  * Gets the bottomLeftCorner
  * @return {Vertex2d}
  */
-Vertex2d ViewportWindow::getBottomLeftCorner() {
+const Vertex2d& ViewportWindow::getBottomLeftCorner() const {
     return this->bottomLeftCorner;
 }
 
@@ -47,15 +76,35 @@ Vertex2d ViewportWindow::getBottomLeftCorner() {
  * Gets the topRightCorner
  * @return {Vertex2d}
  */
-Vertex2d ViewportWindow::getTopRightCorner() {
+const Vertex2d& ViewportWindow::getTopRightCorner() const {
     return this->topRightCorner;
 }
 
 /**
- * Getter for the currently visible objects of the window.
- * @return {list<GeometricFigure*>}
+ * Pixels covered by the window, rounded outwards
+ * @return {BoundingBox}
  */
-std::list<GeometricFigure*> ViewportWindow::getVisibleObjects() {
+BoundingBox ViewportWindow::getBoundingBox() const {
+    return BoundingBox((int) floor(this->bottomLeftCorner.getX()), (int) floor(this->bottomLeftCorner.getY()),
+                       (int) ceil(this->topRightCorner.getX()), (int) ceil(this->topRightCorner.getY()));
+}
+
+/**
+ * Find the figures whose bounding box intersects the window, without testing
+ * every figure of the scene. Only those need to go through clip().
+ * @param grid {SpatialGrid&} - the bounding boxes of the figures of the scene
+ * @param figureIds {vector<int>&} - replaced by the figures found
+ */
+void ViewportWindow::cull(SpatialGrid& grid, vector<int>& figureIds) const {
+    CG_TRACE_SPAN("cull");
+    grid.query(this->getBoundingBox(), figureIds);
+}
+
+/**
+ * Getter for the currently visible objects of the window, without copying the list.
+ * @return {const list<GeometricFigure*>&}
+ */
+const std::list<GeometricFigure*>& ViewportWindow::getVisibleObjects() const {
     return this->visibleObjects;
 }
 
@@ -66,11 +115,8 @@ std::list<GeometricFigure*> ViewportWindow::getVisibleObjects() {
  * @param _finalPoint {CodedVertex2d}
  * @return {bool}
  */
-bool ViewportWindow::clipLineAcceptanceTest(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint) {
-    vector<bool> falseVector = {false, false, false, false};
-    vector<bool> initialRegionCode = _initialPoint.getRegionCode();
-    vector<bool> finalRegionCode = _finalPoint.getRegionCode();
-    return ((initialRegionCode == falseVector) && (finalRegionCode == falseVector));
+bool ViewportWindow::clipLineAcceptanceTest(const CodedVertex2d& _initialPoint, const CodedVertex2d& _finalPoint) {
+    return (_initialPoint.getRegionCode() | _finalPoint.getRegionCode()) == 0;
 }
 
 /**
@@ -80,15 +126,8 @@ bool ViewportWindow::clipLineAcceptanceTest(CodedVertex2d _initialPoint, CodedVe
  * @param _finalPoint {CodedVertex2d}
  * @return {bool}
  */
-bool ViewportWindow::clipLineRejectionTest(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint) {
-    vector<bool> initialRegionCode = _initialPoint.getRegionCode();
-    vector<bool> finalRegionCode = _finalPoint.getRegionCode();
-    for (int i = 0; i < initialRegionCode.size(); i++) {
-        if (initialRegionCode[i] && finalRegionCode[i]) {
-            return true;
-        }
-    }
-    return false;
+bool ViewportWindow::clipLineRejectionTest(const CodedVertex2d& _initialPoint, const CodedVertex2d& _finalPoint) {
+    return (_initialPoint.getRegionCode() & _finalPoint.getRegionCode()) != 0;
 }
 
 /**
@@ -97,21 +136,21 @@ bool ViewportWindow::clipLineRejectionTest(CodedVertex2d _initialPoint, CodedVer
  * and the method redirects to the specific clipping algorithm.
  * @param _objects {list<GeometricFigure>}
  */
-void ViewportWindow::clip(list<GeometricFigure> _objects) {
-    list<GeometricFigure>::iterator it;
+void ViewportWindow::clip(const list<GeometricFigure>& _objects) {
+    list<GeometricFigure>::const_iterator it;
     for (it = _objects.begin(); it != _objects.end(); it++) {
         // Polygons
         switch (it->getType()) {
             case LINE: {
                 // TODO review this part
-                GeometricFigure* p = &*it;
-                clipLine(*static_cast<Line*>(p));
+                const GeometricFigure* p = &*it;
+                clipLine(*static_cast<const Line*>(p));
                 break;
             }
             case POLYGON: {
                 // TODO review this part
-                GeometricFigure* q = &*it;
-                clipPolygon(*static_cast<Polygon*>(q));
+                const GeometricFigure* q = &*it;
+                clipPolygon(*static_cast<const Polygon*>(q));
                 break;
             }
             case CIRCUMFERENCE: {
@@ -126,9 +165,11 @@ void ViewportWindow::clip(list<GeometricFigure> _objects) {
 /**
  * This is a line clipping method that uses the Cohen-Sutherland algorithm.
  * This method is temporally public for testing purposes.
+ * The clipped line only carries its end points, it is not rasterized.
  * @param _line {Line}
  */
-void ViewportWindow::clipLine(Line _line) {
+void ViewportWindow::clipLine(const Line& _line) {
+    CG_TRACE_SPAN("clip", LINE, 2);
     float xMin = this->getBottomLeftCorner().getX();
     float yMin = this->getBottomLeftCorner().getY();
     float xMax = this->getTopRightCorner().getX();
@@ -155,22 +196,28 @@ void ViewportWindow::clipLine(Line _line) {
     if (finalX < xMin) finalCodedPoint.setLeftRegionCode(true);
     
     bool actionTaken = false;
-    Vertex2d initialPoint = _line.getInitialPoint();
+    // The end points are only made a Line when accepted, so that its bounding box is computed once
+    Vertex2d clippedInitialPoint = _line.getInitialPoint();
+    Vertex2d clippedFinalPoint = _line.getFinalPoint();
+    const Vertex2d& initialPoint = _line.getInitialPoint();
     Vertex2d newPoint;
     newPoint.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
     
     while (!actionTaken) {
         if (clipLineAcceptanceTest(initialCodedPoint, finalCodedPoint)) {
-            visibleObjects.push_back(&_line);
+            CG_STATS_ADD(CLIP_ACCEPTED, 1);
+            visibleObjects.push_back(new Line(clippedInitialPoint, clippedFinalPoint));
             actionTaken = true;
         }
         
         if (!actionTaken && clipLineRejectionTest(initialCodedPoint, finalCodedPoint)) {
+            CG_STATS_ADD(CLIP_REJECTED, 1);
             actionTaken = true;
         }
         
         if (!actionTaken) {
             // Calculate the intersection
+            CG_STATS_ADD(CLIP_INTERSECTED, 1);
             float m = (finalY - initialY) / (finalX - initialX);
             float x1, y1;
             
@@ -183,7 +230,7 @@ void ViewportWindow::clipLine(Line _line) {
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 initialCodedPoint.setLeftRegionCode(false);
-                _line.setInitialPoint(newPoint);
+                clippedInitialPoint = newPoint;
                 
             } else if (finalCodedPoint.getLeftRegionCode()) {
                 x1 = xMin;
@@ -191,7 +238,7 @@ void ViewportWindow::clipLine(Line _line) {
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 finalCodedPoint.setLeftRegionCode(false);
-                _line.setFinalPoint(newPoint);
+                clippedFinalPoint = newPoint;
             }
             
             // Right Clipping
@@ -201,14 +248,14 @@ void ViewportWindow::clipLine(Line _line) {
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 initialCodedPoint.setRightRegionCode(false);
-                _line.setInitialPoint(newPoint);
+                clippedInitialPoint = newPoint;
             } else if (finalCodedPoint.getRightRegionCode()) {
                 x1 = xMax;
                 y1 = finalY - m * (finalX - x1);
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 finalCodedPoint.setRightRegionCode(false);
-                _line.setFinalPoint(newPoint);
+                clippedFinalPoint = newPoint;
             }
             
             // Bottom Clipping
@@ -218,14 +265,14 @@ void ViewportWindow::clipLine(Line _line) {
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 initialCodedPoint.setBottomRegionCode(false);
-                _line.setInitialPoint(newPoint);
+                clippedInitialPoint = newPoint;
             } else if (finalCodedPoint.getBottomRegionCode()) {
                 y1 = yMin;
                 x1 = finalX - ((finalY - y1) / m);
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 finalCodedPoint.setBottomRegionCode(false);
-                _line.setFinalPoint(newPoint);
+                clippedFinalPoint = newPoint;
             }
             
             // Top Clipping
@@ -235,27 +282,36 @@ void ViewportWindow::clipLine(Line _line) {
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 initialCodedPoint.setTopRegionCode(false);
-                _line.setInitialPoint(newPoint);
+                clippedInitialPoint = newPoint;
             } else if (finalCodedPoint.getTopRegionCode()) {
                 y1 = yMax;
                 x1 = finalX - ((finalY - y1) / m);
                 newPoint.setX(x1);
                 newPoint.setY(y1);
                 finalCodedPoint.setTopRegionCode(false);
-                _line.setFinalPoint(newPoint);
+                clippedFinalPoint = newPoint;
             }
         }
     }
 }
 
 /**
- * Method that determines if a polygon edge is entirely inside a SPECIFIC Limit (by its index) of the viewport.
- * @param _initialPoint {CodedVertex2d}
- * @param _finalPoint {CodedVertex2d}
- * @param index {int} - index of the RegionCode that will be checked (0 Top, 1 Bottom, 2 Right, 3 Left)
+ * Create the coded vertex of a point, with the region code of its position
+ * relative to the window
+ * @param x {float}, y {float}
+ * @param color {Vertex2d} - only the colors of the vertex are used
+ * @return {CodedVertex2d}
  */
-bool ViewportWindow::isEdgeInsideLimitByIndex(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint, int index) {
-    return !(_initialPoint.getRegionCodeByIndex(index) || _finalPoint.getRegionCodeByIndex(index));
+CodedVertex2d ViewportWindow::encodeVertex(float x, float y, const Vertex2d& color) const {
+    CodedVertex2d codedPoint(x, y);
+    codedPoint.Vertex2d::setRGBColors(color.getRed(), color.getGreen(), color.getBlue());
+    
+    if (y > this->topRightCorner.getY()) codedPoint.setTopRegionCode(true);
+    if (y < this->bottomLeftCorner.getY()) codedPoint.setBottomRegionCode(true);
+    if (x > this->topRightCorner.getX()) codedPoint.setRightRegionCode(true);
+    if (x < this->bottomLeftCorner.getX()) codedPoint.setLeftRegionCode(true);
+    
+    return codedPoint;
 }
 
 /**
@@ -265,132 +321,136 @@ bool ViewportWindow::isEdgeInsideLimitByIndex(CodedVertex2d _initialPoint, Coded
  * another method (not implemented).
  * @param _polygon {Polygon}
  */
-void ViewportWindow::clipPolygon(Polygon _polygon) {
+void ViewportWindow::clipPolygon(const Polygon& _polygon) {
+    CG_TRACE_SPAN("clip", POLYGON, _polygon.getVertices().size());
     float xMin = this->getBottomLeftCorner().getX();
     float yMin = this->getBottomLeftCorner().getY();
     float xMax = this->getTopRightCorner().getX();
     float yMax = this->getTopRightCorner().getY();
     
-    list<Vertex2d> polygonVertices = _polygon.getVerticesList();
-    list<CodedVertex2d> codedPolygonVertices;
+    VertexSpan polygonVertices = _polygon.getVertices();
+    
+    // Trivial tests with the bounding box: a polygon entirely inside the window
+    // is kept as it is, and one entirely outside is clipped away
+    const BoundingBox& box = _polygon.getBoundingBox();
+    if (box.isEmpty() || box.getXMax() < xMin || box.getYMax() < yMin || box.getXMin() > xMax || box.getYMin() > yMax) {
+        CG_STATS_ADD(CLIP_REJECTED, 1);
+        this->visibleObjects.push_back(new Polygon(VertexBuffer()));
+        return;
+    }
+    if (box.getXMin() >= xMin && box.getYMin() >= yMin && box.getXMax() <= xMax && box.getYMax() <= yMax) {
+        CG_STATS_ADD(CLIP_ACCEPTED, 1);
+        this->visibleObjects.push_back(new Polygon(polygonVertices));
+        return;
+    }
     
-    // We must convert the list of Vertex2d vertices to CodedVertex2d before do the actual clipping
+    SmallVector<CodedVertex2d, 16> codedPolygonVertices;
+    
+    // We must convert the Vertex2d vertices to CodedVertex2d before do the actual clipping
     for (auto it = polygonVertices.begin(); it != polygonVertices.end(); it++) {
-        float x = it->getX();
-        float y = it->getY();
-        CodedVertex2d codedPoint(x, y);
-        codedPoint.Vertex2d::setRGBColors(it->getRed(), it->getGreen(), it->getBlue());
-        
-        if (y > yMax) codedPoint.setTopRegionCode(true);
-        if (y < yMin) codedPoint.setBottomRegionCode(true);
-        if (x > xMax) codedPoint.setRightRegionCode(true);
-        if (x < xMin) codedPoint.setLeftRegionCode(true);
-        
-        codedPolygonVertices.push_back(codedPoint);
+        codedPolygonVertices.push_back(this->encodeVertex(it->getX(), it->getY(), *it));
     }
-
+    
     // This is a counter to keep track of the boundaries
     int counter = 0;
     
-    list<CodedVertex2d> newVertices;
+    // Whether any limit cut an edge, so the polygon is counted once
+    bool intersected = false;
+    
+    SmallVector<CodedVertex2d, 16> newVertices;
     
     // We must do the clipping until all the limits has been clipped
     while (counter < 4) {
         
         // Iterate through all the vertices
         for (auto it = codedPolygonVertices.begin(); it != codedPolygonVertices.end(); it++) {
-            auto nextVertice = next(it);
+            auto nextVertice = it + 1;
                 
             // We need to close the polygon
             if (nextVertice == codedPolygonVertices.end()) {
                 nextVertice = codedPolygonVertices.begin();
             }
             
-            // If polygon's edge is not totally inside the viewport, we must calculate the intersect
-            if (!this->isEdgeInsideLimitByIndex(*it, *nextVertice, counter)) {
-                CodedVertex2d newInitialVertice;
-                newInitialVertice.Vertex2d::setRGBColors(it->Vertex2d::getRed(), it->Vertex2d::getGreen(), it->Vertex2d::getGreen());
-                CodedVertex2d newFinalVertice;
-                newFinalVertice.Vertex2d::setRGBColors(it->Vertex2d::getRed(), it->Vertex2d::getGreen(), it->Vertex2d::getGreen());
-                
-                float x1 = 0.0, y1 = 0.0, m = 0.0;
-                float nextVerticeX = nextVertice->getX();
-                float nextVerticeY = nextVertice->getY();
+            bool isInitialInside = !it->getRegionCodeByIndex(counter);
+            bool isFinalInside = !nextVertice->getRegionCodeByIndex(counter);
+            
+            // Edge entirely inside this limit, only its final vertice is kept
+            if (isInitialInside && isFinalInside) {
+                newVertices.push_back(*nextVertice);
+                continue;
+            }
+            
+            // Edge entirely outside this limit, nothing is kept
+            if (!isInitialInside && !isFinalInside) {
+                continue;
+            }
+            
+            // The edge crosses the limit, so it is not parallel to it and the
+            // intersection is found by the parameter t of the edge
+            intersected = true;
+            float dx = nextVertice->getX() - it->getX();
+            float dy = nextVertice->getY() - it->getY();
+            float x1 = 0.0, y1 = 0.0, t = 0.0;
+            
+            switch (counter) {
+                case 0: // Top clipping
+                    t = (yMax - it->getY()) / dy;
+                    x1 = it->getX() + t * dx;
+                    y1 = yMax;
+                    break;
+                    
+                case 1: // Bottom clipping
+                    t = (yMin - it->getY()) / dy;
+                    x1 = it->getX() + t * dx;
+                    y1 = yMin;
+                    break;
                     
-                m = (nextVertice->getY() - it->getY()) / (nextVertice->getX() - it->getX());
+                case 2: // Right clipping
+                    t = (xMax - it->getX()) / dx;
+                    x1 = xMax;
+                    y1 = it->getY() + t * dy;
+                    break;
                     
-                if (it->getRegionCodeByIndex(counter)) {
-                    switch (counter) {
-                        case 0: // Top clipping
-                            x1 = nextVerticeX - ((nextVerticeY - yMax) / m);
-                            y1 = yMax;
-                            newInitialVertice.setTopRegionCode(false);
-                            break;
-                                
-                        case 1: // Bottom clipping
-                            x1 = nextVerticeX - ((nextVerticeY - yMin) / m);
-                            y1 = yMin;
-                            newInitialVertice.setBottomRegionCode(false);
-                            break;
-                            
-                        case 2: // Right clipping
-                            x1 = xMax;
-                            y1 = nextVerticeY - m * (nextVerticeX - xMax);
-                            newInitialVertice.setRightRegionCode(false);
-                            break;
-                                
-                        case 3: // Left clipping
-                            x1 = xMin;
-                            y1 = nextVerticeY - m * (nextVerticeX - xMin);
-                            newInitialVertice.setLeftRegionCode(false);
-                            break;
-                    }
-                        
-                    newInitialVertice.setX(x1);
-                    newInitialVertice.setY(y1);
-                    newVertices.push_back(newInitialVertice);
-                    // initialPoint outside, finalPoint inside ->  (intersection [calculated above], finalPoint)
-                    if (!nextVertice->getRegionCodeByIndex(counter)) {
-                        newVertices.push_back(*nextVertice);
-                    }
-                } else if (nextVertice->getRegionCodeByIndex(counter)) {
-                    switch (counter) {
-                        case 0: // Top clipping
-                            x1 = nextVerticeX - ((nextVerticeY - yMax) / m);
-                            y1 = yMax;
-                            break;
-                                
-                        case 1: // Bottom clipping
-                            x1 = nextVerticeX - ((nextVerticeY - yMin) / m);
-                            y1 = yMin;
-                            break;
-                                
-                        case 2: // Right clipping
-                            x1 = xMax;
-                            y1 = nextVerticeY - m * (nextVerticeX - xMax);
-                            break;
-                                
-                        case 3: // Left clipping
-                            x1 = xMin;
-                            y1 = nextVerticeY - m * (nextVerticeX - xMin);
-                            break;
-                    }
-                        
-                    newFinalVertice.setX(x1);
-                    newFinalVertice.setY(y1);
-                    newVertices.push_back(newFinalVertice);
-                }
-            } else {
+                case 3: // Left clipping
+                    t = (xMin - it->getX()) / dx;
+                    x1 = xMin;
+                    y1 = it->getY() + t * dy;
+                    break;
+            }
+            
+            // The intersection may still be outside the limits not clipped yet,
+            // so its region code is computed again from its coordinates
+            newVertices.push_back(this->encodeVertex(x1, y1, *it));
+            
+            // initialPoint outside, finalPoint inside ->  (intersection [calculated above], finalPoint)
+            if (!isInitialInside) {
                 newVertices.push_back(*nextVertice);
             }
         }
         
-        codedPolygonVertices = newVertices;
+        std::swap(codedPolygonVertices, newVertices);
         newVertices.clear();
         
         counter++;
     }
     
-    Polygon *clippedPolygon = new Polygon(codedPolygonVertices);
+    if (codedPolygonVertices.empty()) {
+        CG_STATS_ADD(CLIP_REJECTED, 1);
+    } else if (intersected) {
+        CG_STATS_ADD(CLIP_INTERSECTED, 1);
+    } else {
+        CG_STATS_ADD(CLIP_ACCEPTED, 1);
+    }
+    
+    // Convert the clipped CodedVertex2d vertices back to Vertex2d
+    VertexBuffer clippedVertices;
+    clippedVertices.reserve(codedPolygonVertices.size());
+    for (auto it = codedPolygonVertices.begin(); it != codedPolygonVertices.end(); it++) {
+        Vertex2d newVertex(it->getX(), it->getY());
+        newVertex.setRGBColors(it->Vertex2d::getRed(), it->Vertex2d::getGreen(), it->Vertex2d::getBlue());
+        clippedVertices.push_back(newVertex);
+    }
+    
+    Polygon *clippedPolygon = new Polygon(std::move(clippedVertices));
     this->visibleObjects.push_back(clippedPolygon);
 }
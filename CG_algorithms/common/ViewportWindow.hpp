@@ -10,32 +10,48 @@
 #include "Vertex2d.hpp"
 #include "GeometricFigure.hpp"
 #include "CodedVertex2d.hpp"
+#include "SmallVector.hpp"
+#include "VertexSpan.hpp"
+#include "BoundingBox.hpp"
+#include "SpatialGrid.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
 #include <list>
 #include "../lines/Line.hpp"
 #include "../polygons/Polygon.hpp"
+#include "../lines/Circumference.hpp"
 #include <iostream>
+#include <vector>
 
 class ViewportWindow {
 private:
     Vertex2d bottomLeftCorner;
     Vertex2d topRightCorner;
     std::list<GeometricFigure*> visibleObjects;
-    bool clipLineAcceptanceTest(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint);
-    bool clipLineRejectionTest(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint);
-    bool isEdgeInsideLimitByIndex(CodedVertex2d _initialPoint, CodedVertex2d _finalPoint, int index);
+    bool clipLineAcceptanceTest(const CodedVertex2d& _initialPoint, const CodedVertex2d& _finalPoint);
+    bool clipLineRejectionTest(const CodedVertex2d& _initialPoint, const CodedVertex2d& _finalPoint);
+    CodedVertex2d encodeVertex(float x, float y, const Vertex2d& color) const;
 public:
-    ViewportWindow(Vertex2d _bottomLeftCorner, Vertex2d topRightCorner);
-    void setBottomLeftCorner(Vertex2d _bottomLeftCorner);
-    void setTopRightCorner(Vertex2d _TopRightCorner);
-    Vertex2d getBottomLeftCorner();
-    Vertex2d getTopRightCorner();
-    std::list<GeometricFigure*> getVisibleObjects();
+    ViewportWindow(const Vertex2d& _bottomLeftCorner, const Vertex2d& topRightCorner);
+    ~ViewportWindow();
+    // The window owns the clipped figures, so it can not be copied
+    ViewportWindow(const ViewportWindow&) = delete;
+    ViewportWindow& operator=(const ViewportWindow&) = delete;
+    void setBottomLeftCorner(const Vertex2d& _bottomLeftCorner);
+    void setTopRightCorner(const Vertex2d& _TopRightCorner);
+    const Vertex2d& getBottomLeftCorner() const;
+    const Vertex2d& getTopRightCorner() const;
+    const std::list<GeometricFigure*>& getVisibleObjects() const;
+    BoundingBox getBoundingBox() const;
+    // The figures of the grid that may be inside the window, for clip() to take
+    void cull(SpatialGrid& grid, std::vector<int>& figureIds) const;
+    void clearVisibleObjects();
     // Method to make a triage of primites that will be clipped
-    void clip(std::list<GeometricFigure> _objects);
+    void clip(const std::list<GeometricFigure>& _objects);
     // Cohen-Sutherland algorithm to clip lines
-    void clipLine(Line _line);
+    void clipLine(const Line& _line);
     // Sutherland-Hodgman algorithm to clip Filled Concave Polygons
-    void clipPolygon(Polygon _polygon);
+    void clipPolygon(const Polygon& _polygon);
 };
 
 
@@ -10,6 +10,8 @@
 #include "../2D_transformations/Matrix2d.hpp"
 #include "../2D_transformations/TransformationMatrix.hpp"
 #include "../common/Vertex2d.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/Trace.hpp"
 
 using namespace std;
 
@@ -18,92 +20,42 @@ using namespace std;
  * @param center {Vertex2d}
  * @param radius {int}
  */
-Circumference::Circumference(Vertex2d center, int radius):GeometricFigure() {
+Circumference::Circumference(const Vertex2d& center, int radius):GeometricFigure(), radius(0) {
     this->setCenter(center);
     this->setRadius(radius);
     GeometricFigure::setType(CIRCUMFERENCE);
 }
 
 /**
- * Generate the points for a circunference
- * @param circumference (Circumference*)
- * @param center {Vertex2d} - the center of the circumference
- * @param currentPoint {Vertex2d} - the current point
+ * Generate a circumference, using the Bresenham algorithm for circumferences
+ * @param center {Vertex2d} the coordinate of the circumference's center
+ * @param radius the radius of the circumference
  */
- void Circumference::generateCircumferencePoints(Circumference *circumference, Vertex2d center, Vertex2d currentPoint) {
-    Vertex2d pointToAdd;
-    int x = currentPoint.getX();
-    int y = currentPoint.getY();
-    
-    pointToAdd.setX(center.getX() + x);
-    pointToAdd.setY(center.getY() + y);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() + y);
-    pointToAdd.setY(center.getY() + x);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() + y);
-    pointToAdd.setY(center.getY() - x);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() + x);
-    pointToAdd.setY(center.getY() - y);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() - x);
-    pointToAdd.setY(center.getY() - y);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() - y);
-    pointToAdd.setY(center.getY() - x);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() - y);
-    pointToAdd.setY(center.getY() + x);
-    circumference->addPoint(pointToAdd);
-    
-    pointToAdd.setX(center.getX() - x);
-    pointToAdd.setY(center.getY() + y);
-    circumference->addPoint(pointToAdd);
+Circumference Circumference::generateCircumferenceBresenham(const Vertex2d& center, int radius) {
+    CG_TRACE_SPAN("raster", CIRCUMFERENCE, 1);
+    Circumference circumference(center, radius);
+    VectorPixelSink sink(circumference.points);
+    Circumference::rasterizeCircumferenceBresenham(center, radius, sink);
+    return circumference;
 }
 
 /**
- * Generate a circumference, using the Bresenham algorithm for circumferences
+ * Lazy range over the pixels of a circumference, using the Bresenham algorithm.
+ * The pixels are only computed while the range is walked.
  * @param center {Vertex2d} the coordinate of the circumference's center
  * @param radius the radius of the circumference
+ * @return {PixelRange<CircumferencePixelGenerator>}
  */
-Circumference Circumference::generateCircumferenceBresenham(Vertex2d center, int radius) {
-    int currentX, currentY, d;
-    Circumference circumference(center, radius);
-    Circumference *reference = &circumference;
-    Vertex2d currentPoint;
-    
-    currentPoint.setX(0);
-    currentPoint.setY(radius);
-    d = 1 - radius;
-    
-    Circumference::generateCircumferencePoints(reference, center, currentPoint);
-    
-    currentX = currentPoint.getX();
-    currentY = currentPoint.getY();
-    
-    while (currentX < currentY) {
-        currentX = currentPoint.getX();
-        currentY = currentPoint.getY();
-        
-        if (d < 0) {
-            d = d + (2 * currentX) + 3;
-        } else {
-            d = d + 2 * (currentX - currentY) + 5;
-            currentPoint.setY(currentY - 1);
-        }
-        
-        currentPoint.setX(currentX + 1);
-        generateCircumferencePoints(reference, center, currentPoint);
-    }
-    
-    return circumference;
+PixelRange<CircumferencePixelGenerator> Circumference::iterateCircumferenceBresenham(const Vertex2d& center, int radius) {
+    return PixelRange<CircumferencePixelGenerator>(center, radius);
+}
+
+/**
+ * Lazy range over the pixels of this circumference
+ * @return {PixelRange<CircumferencePixelGenerator>}
+ */
+PixelRange<CircumferencePixelGenerator> Circumference::iteratePixels() const {
+    return Circumference::iterateCircumferenceBresenham(this->center, this->radius);
 }
 
 /**
@@ -116,6 +68,7 @@ void Circumference::setRadius(int newRadius) {
     }
     
     this->radius = newRadius;
+    this->updateBoundingBox();
 }
 
 /**
@@ -130,7 +83,7 @@ int Circumference::getRadius() const {
  * Getter for the circumference's center
  * @return {Vertex2d}
  */
-Vertex2d Circumference::getCenter() const {
+const Vertex2d& Circumference::getCenter() const {
     return this->center;
 }
 
@@ -138,20 +91,30 @@ Vertex2d Circumference::getCenter() const {
  * Setter for the circumference's center
  * @param newCenter {Vertex2d}
  */
-void Circumference::setCenter(Vertex2d newCenter) {
+void Circumference::setCenter(const Vertex2d& newCenter) {
     this->center = newCenter;
+    this->updateBoundingBox();
 }
 
-void Circumference::applyTransformationMatrix(Matrix2d transformationMatrix) {
-    // Generate a new center
+/**
+ * The bounding box of a circumference goes as far as its radius from the center
+ */
+void Circumference::updateBoundingBox() {
+    this->boundingBox = BoundingBox::ofExtents(this->center.getX() - this->radius, this->center.getY() - this->radius,
+                                               this->center.getX() + this->radius, this->center.getY() + this->radius);
+}
+
+void Circumference::applyTransformationMatrix(Matrix2d& transformationMatrix) {
+    CG_TRACE_SPAN("transform", CIRCUMFERENCE, 1);
+    // Generate a new center, in the color of the current one
     Vertex2d newCenter = transformationMatrix * this->getCenter();
+    newCenter.setRGBColors(this->center.getRed(), this->center.getGreen(), this->center.getBlue());
     
-    // Generate a new circumference with the new center
-    Circumference newCirc = Circumference::generateCircumferenceBresenham(newCenter, this->getRadius());
-    
-    // Set the new points
+    // Set the new center and rasterize the circumference again in place
     this->setCenter(newCenter);
-    GeometricFigure::setPoints(newCirc.GeometricFigure::getPoints());
+    this->points.clear();
+    VectorPixelSink sink(this->points);
+    this->rasterize(sink);
 }
 
 void Circumference::translate(float dx, float dy) {
@@ -12,21 +12,91 @@
 #include "../common/Vertex2d.hpp"
 #include "../common/GeometricFigure.hpp"
 #include "../2D_transformations/Matrix2d.hpp"
+#include "../common/PixelRange.hpp"
+#include "../common/Stats.hpp"
+#include "CircumferencePixelGenerator.hpp"
 
 class Circumference : public GeometricFigure {
 public:
-    Circumference(Vertex2d, int);
-    static Circumference generateCircumferenceBresenham(Vertex2d, int);
+    Circumference(const Vertex2d&, int);
+    static Circumference generateCircumferenceBresenham(const Vertex2d&, int);
+    template <typename Sink, typename T> static void rasterizeCircumferenceBresenham(const BasicVertex2d<T>&, int, Sink&);
+    template <typename Sink> void rasterize(Sink&) const;
+    static PixelRange<CircumferencePixelGenerator> iterateCircumferenceBresenham(const Vertex2d&, int);
+    PixelRange<CircumferencePixelGenerator> iteratePixels() const;
     void setRadius(int);
     int getRadius() const;
-    Vertex2d getCenter() const;
-    void setCenter(Vertex2d);
+    const Vertex2d& getCenter() const;
+    void setCenter(const Vertex2d&);
     void translate(float, float);
 private:
-    static void generateCircumferencePoints(Circumference*,Vertex2d, Vertex2d);
-    void applyTransformationMatrix(Matrix2d transformationMatrix);
+    template <typename Sink, typename T> static void plotCircumferencePoints(Sink&, const BasicVertex2d<T>&, const Vertex2d&, int, int);
+    void applyTransformationMatrix(Matrix2d& transformationMatrix);
+    void updateBoundingBox();
     int radius;
     Vertex2d center;
 };
 
+/**
+ * Send the eight symmetric points of a circumference to the sink
+ * @param sink {Sink&}
+ * @param center {BasicVertex2d<T>} - the center of the circumference
+ * @param color {Vertex2d} - the color of the points
+ * @param x {int}, y {int} - the current point, relative to the center
+ */
+template <typename Sink, typename T>
+void Circumference::plotCircumferencePoints(Sink& sink, const BasicVertex2d<T>& center, const Vertex2d& color, int x, int y) {
+    int centerX = center.getX();
+    int centerY = center.getY();
+    
+    CG_STATS_ADD(PIXELS_CIRCUMFERENCE, 8);
+    sink.plot(centerX + x, centerY + y, color);
+    sink.plot(centerX + y, centerY + x, color);
+    sink.plot(centerX + y, centerY - x, color);
+    sink.plot(centerX + x, centerY - y, color);
+    sink.plot(centerX - x, centerY - y, color);
+    sink.plot(centerX - y, centerY - x, color);
+    sink.plot(centerX - y, centerY + x, color);
+    sink.plot(centerX - x, centerY + y, color);
+}
+
+/**
+ * Rasterize a circumference into a sink, using the Bresenham (midpoint)
+ * algorithm for circumferences
+ * @param center {BasicVertex2d<T>} the coordinate of the circumference's center
+ * @param radius the radius of the circumference
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Circumference::rasterizeCircumferenceBresenham(const BasicVertex2d<T>& center, int radius, Sink& sink) {
+    int currentX = 0;
+    int currentY = radius;
+    int d = 1 - radius;
+    Vertex2d color;
+    color.setRGBColors(center.getRed(), center.getGreen(), center.getBlue());
+    
+    Circumference::plotCircumferencePoints(sink, center, color, currentX, currentY);
+    
+    while (currentX < currentY) {
+        if (d < 0) {
+            d = d + (2 * currentX) + 3;
+        } else {
+            d = d + 2 * (currentX - currentY) + 5;
+            currentY--;
+        }
+        
+        currentX++;
+        Circumference::plotCircumferencePoints(sink, center, color, currentX, currentY);
+    }
+}
+
+/**
+ * Rasterize this circumference into a sink
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Circumference::rasterize(Sink& sink) const {
+    Circumference::rasterizeCircumferenceBresenham(this->center, this->radius, sink);
+}
+
 #endif /* Circumference_hpp */
\ No newline at end of file
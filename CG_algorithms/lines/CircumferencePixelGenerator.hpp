@@ -0,0 +1,85 @@
+/**
+ * CircumferencePixelGenerator.hpp
+ * Pixel generator for circumferences, to be used with PixelRange. It produces
+ * the same pixels as Circumference::rasterizeCircumferenceBresenham, one at a time.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef CircumferencePixelGenerator_hpp
+#define CircumferencePixelGenerator_hpp
+
+#include "../common/Vertex2d.hpp"
+
+class CircumferencePixelGenerator {
+public:
+    CircumferencePixelGenerator(const Vertex2d&, int);
+    bool next(Vertex2d&);
+private:
+    int centerX;
+    int centerY;
+    int currentX;
+    int currentY;
+    int d;
+    // which of the eight symmetric points comes next
+    int octant;
+    Vertex2d color;
+};
+
+/**
+ * Constructor of the class
+ * @param center {Vertex2d} the coordinate of the circumference's center
+ * @param radius the radius of the circumference
+ */
+inline CircumferencePixelGenerator::CircumferencePixelGenerator(const Vertex2d& center, int radius) {
+    this->centerX = center.getX();
+    this->centerY = center.getY();
+    this->currentX = 0;
+    this->currentY = radius;
+    this->d = 1 - radius;
+    this->octant = 0;
+    this->color.setRGBColors(center.getRed(), center.getGreen(), center.getBlue());
+}
+
+/**
+ * Write the next pixel of the circumference
+ * @param pixel {Vertex2d&}
+ * @return {bool} - false when the circumference is over
+ */
+inline bool CircumferencePixelGenerator::next(Vertex2d& pixel) {
+    if (this->octant == 8) {
+        if (this->currentX >= this->currentY) {
+            return false;
+        }
+        
+        if (this->d < 0) {
+            this->d = this->d + (2 * this->currentX) + 3;
+        } else {
+            this->d = this->d + 2 * (this->currentX - this->currentY) + 5;
+            this->currentY--;
+        }
+        
+        this->currentX++;
+        this->octant = 0;
+    }
+    
+    int x = this->currentX;
+    int y = this->currentY;
+    pixel = this->color;
+    
+    // Same order as Circumference::plotCircumferencePoints
+    switch (this->octant++) {
+        case 0: pixel.setX(centerX + x); pixel.setY(centerY + y); break;
+        case 1: pixel.setX(centerX + y); pixel.setY(centerY + x); break;
+        case 2: pixel.setX(centerX + y); pixel.setY(centerY - x); break;
+        case 3: pixel.setX(centerX + x); pixel.setY(centerY - y); break;
+        case 4: pixel.setX(centerX - x); pixel.setY(centerY - y); break;
+        case 5: pixel.setX(centerX - y); pixel.setY(centerY - x); break;
+        case 6: pixel.setX(centerX - y); pixel.setY(centerY + x); break;
+        default: pixel.setX(centerX - x); pixel.setY(centerY + y); break;
+    }
+    
+    return true;
+}
+
+#endif /* CircumferencePixelGenerator_hpp */
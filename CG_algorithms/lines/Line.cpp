@@ -7,11 +7,12 @@
 
 #include "Line.hpp"
 #include <vector>
-#include <cmath>
 #include "../common/Vertex2d.hpp"
 #include "../2D_transformations/TransformationMatrix.hpp"
 #include "../2D_transformations/Matrix2d.hpp"
 #include "../common/ViewportWindow.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/Trace.hpp"
 
 using namespace std;
 
@@ -20,7 +21,7 @@ using namespace std;
  * @param initialPoint {Vertex2d}
  * @param finalPoint {Vertex2d}
  */
-Line::Line(Vertex2d initialPoint, Vertex2d finalPoint):GeometricFigure() {
+Line::Line(const Vertex2d& initialPoint, const Vertex2d& finalPoint):GeometricFigure() {
     this->setInitialPoint(initialPoint);
     this->setFinalPoint(finalPoint);
     GeometricFigure::setType(LINE);
@@ -42,104 +43,80 @@ Line::Line(float x1, float y1, float x2, float y2):GeometricFigure() {
 }
 
 /**
- * Generate a line, using the Bresenham algorithm
+ * Generate a line, using the integer Bresenham algorithm
  * @param initialPoint {Vertex2d} - the initial coordinate of the line
  * @param lastPoint {Vertex2d} - the last coordinate of the line
  */
-Line Line::generateLineBresenham(Vertex2d initialPoint, Vertex2d lastPoint) {
-    int xVariation, yVariation, currentX, currentY;
-    int const1, const2, d, lastX;
+Line Line::generateLineBresenham(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    CG_TRACE_SPAN("raster", LINE, 2);
     Line line(initialPoint, lastPoint);
-    Vertex2d pointToAdd;
-    
-    xVariation = abs((lastPoint.getX() - initialPoint.getX()));
-    yVariation = abs((lastPoint.getY() - initialPoint.getY()));
-    
-    d = (2 * xVariation) - yVariation;
-    const1 = 2 * xVariation;
-    const2 = 2 * (yVariation - xVariation);
-    
-    if (initialPoint.getX() > lastPoint.getX()) {
-        currentX = lastPoint.getX();
-        currentY = lastPoint.getY();
-        lastX = initialPoint.getX();
-    } else {
-        currentX = initialPoint.getX();
-        currentY = initialPoint.getY();
-        lastX = lastPoint.getX();
-    }
-    
-    pointToAdd.setX(currentX);
-    pointToAdd.setY(currentY);
-    line.addPoint(pointToAdd);
-    
-    while (currentX < lastX) {
-        currentX++;
-        if (d < 0) {
-            d += const1;
-        } else {
-            currentY++;
-            d += const2;
-        }
-        pointToAdd.setX(currentX);
-        pointToAdd.setY(currentY);
-        line.addPoint(pointToAdd);
-    }
-    
+    VectorPixelSink sink(line.points);
+    Line::rasterizeLineBresenham(initialPoint, lastPoint, sink);
+    return line;
+}
+
+/**
+ * Generate a line, using the run-length slice variant of Bresenham
+ * @param initialPoint {Vertex2d} - the initial coordinate of the line
+ * @param lastPoint {Vertex2d} - the last coordinate of the line
+ */
+Line Line::generateLineRunSlice(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    CG_TRACE_SPAN("raster", LINE, 2);
+    Line line(initialPoint, lastPoint);
+    VectorPixelSink sink(line.points);
+    Line::rasterizeLineRunSlice(initialPoint, lastPoint, sink);
     return line;
 }
 
 /**
- * Display a line on the screen, using the DDA algorithm
+ * Generate a line, using the DDA algorithm
  * @param initialPoint - the initial coordinate of the line
  * @param lastPoint - the last coordinate of the line
  */
-Line Line::generateLineDDA(Vertex2d initialPoint, Vertex2d lastPoint) {
-    int xVariation, yVariation;
-    float xIncrement, yIncrement;
-    int numOfIterations, count;
-    float currentX, currentY;
-    
+Line Line::generateLineDDA(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    CG_TRACE_SPAN("raster", LINE, 2);
     Line line(initialPoint, lastPoint);
-    Vertex2d pointToAdd;
-    pointToAdd.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
-    
-    xVariation = lastPoint.getX() - initialPoint.getX();
-    yVariation = lastPoint.getY() - initialPoint.getY();
-    
-    if (abs(xVariation) > abs(yVariation)) {
-        numOfIterations = abs(xVariation);
-    } else {
-        numOfIterations = abs(yVariation);
-    }
-    
-    xIncrement = (float) xVariation / numOfIterations;
-    yIncrement = (float) yVariation / numOfIterations;
-    
-    currentX = initialPoint.getX();
-    currentY = initialPoint.getY();
-    
-    pointToAdd.setX(round(currentX));
-    pointToAdd.setY(round(currentY));
-    line.addPoint(pointToAdd);
-    
-    for (count = 1; count < numOfIterations; count++) {
-        currentX += xIncrement;
-        currentY += yIncrement;
-        
-        pointToAdd.setX(round(currentX));
-        pointToAdd.setY(round(currentY));
-        line.addPoint(pointToAdd);
-    }
-    
+    VectorPixelSink sink(line.points);
+    Line::rasterizeLineDDA(initialPoint, lastPoint, sink);
     return line;
 }
 
+/**
+ * Lazy range over the pixels of a line, using the DDA algorithm.
+ * The pixels are only computed while the range is walked.
+ * @param initialPoint {Vertex2d} - the initial coordinate of the line
+ * @param lastPoint {Vertex2d} - the last coordinate of the line
+ * @return {PixelRange<DDALinePixelGenerator>}
+ */
+PixelRange<DDALinePixelGenerator> Line::iterateLineDDA(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    return PixelRange<DDALinePixelGenerator>(initialPoint, lastPoint);
+}
+
+/**
+ * Lazy range over the pixels of a line, using the Bresenham algorithm.
+ * The pixels are only computed while the range is walked.
+ * @param initialPoint {Vertex2d} - the initial coordinate of the line
+ * @param lastPoint {Vertex2d} - the last coordinate of the line
+ * @return {PixelRange<BresenhamLinePixelGenerator>}
+ */
+PixelRange<BresenhamLinePixelGenerator> Line::iterateLineBresenham(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    return PixelRange<BresenhamLinePixelGenerator>(initialPoint, lastPoint);
+}
+
+/**
+ * Lazy range over the pixels of this line. Lines are drawn with DDA,
+ * like in Line::rasterize.
+ * @return {PixelRange<DDALinePixelGenerator>}
+ */
+PixelRange<DDALinePixelGenerator> Line::iteratePixels() const {
+    return Line::iterateLineDDA(this->initialPoint, this->finalPoint);
+}
+
 /**
  * Getter for the initial point of the line
  * @return {Vertex2d}
  */
-Vertex2d Line::getInitialPoint() const {
+const Vertex2d& Line::getInitialPoint() const {
     return this->initialPoint;
 }
 
@@ -147,7 +124,7 @@ Vertex2d Line::getInitialPoint() const {
  * Getter for the final point of the line
  * @return {Vertex2d}
  */
-Vertex2d Line::getFinalPoint() const {
+const Vertex2d& Line::getFinalPoint() const {
     return this->finalPoint;
 }
 
@@ -155,33 +132,45 @@ Vertex2d Line::getFinalPoint() const {
  * Setter for the final point of the line
  * @param newFinalPoint {Vertex2d}
  */
-void Line::setFinalPoint(Vertex2d newFinalPoint) {
+void Line::setFinalPoint(const Vertex2d& newFinalPoint) {
     this->finalPoint = newFinalPoint;
+    this->updateBoundingBox();
 }
 
 /**
  * Setter for the initial point of the line
  * @param newInitialPoint {Vertex2d}
  */
-void Line::setInitialPoint(Vertex2d newInitialPoint) {
+void Line::setInitialPoint(const Vertex2d& newInitialPoint) {
     this->initialPoint = newInitialPoint;
+    this->updateBoundingBox();
 }
 
-void Line::applyTransformationMatrix(Matrix2d transformationMatrix) {
-    Vertex2d oldInitialPoint = this->getInitialPoint();
+/**
+ * The bounding box of a line is the one of its end points
+ */
+void Line::updateBoundingBox() {
+    this->boundingBox = BoundingBox::ofExtents(min(this->initialPoint.getX(), this->finalPoint.getX()),
+                                               min(this->initialPoint.getY(), this->finalPoint.getY()),
+                                               max(this->initialPoint.getX(), this->finalPoint.getX()),
+                                               max(this->initialPoint.getY(), this->finalPoint.getY()));
+}
+
+void Line::applyTransformationMatrix(Matrix2d& transformationMatrix) {
+    CG_TRACE_SPAN("transform", LINE, 2);
+    const Vertex2d& oldInitialPoint = this->getInitialPoint();
     
     // Calculate the new points
-    Vertex2d newInitialPoint = transformationMatrix * this->getInitialPoint();
+    Vertex2d newInitialPoint = transformationMatrix * oldInitialPoint;
     newInitialPoint.setRGBColors(oldInitialPoint.getRed(), oldInitialPoint.getGreen(), oldInitialPoint.getBlue());
     Vertex2d newFinalPoint = transformationMatrix * this->getFinalPoint();
     
-    // Generate a new line
-    Line newLine = generateLineDDA(newInitialPoint, newFinalPoint);
-    
-    // Set the new points
+    // Set the new points and rasterize the line again in place
     this->setInitialPoint(newInitialPoint);
     this->setFinalPoint(newFinalPoint);
-    GeometricFigure::setPoints(newLine.GeometricFigure::getPoints());
+    this->points.clear();
+    VectorPixelSink sink(this->points);
+    this->rasterize(sink);
 }
 
 void Line::translate(float dx, float dy) {
@@ -9,27 +9,335 @@
 #define Line_hpp
 
 #include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
 #include "../common/Vertex2d.hpp"
 #include "../common/GeometricFigure.hpp"
 #include "../2D_transformations/Matrix2d.hpp"
+#include "../common/PixelRange.hpp"
+#include "../common/Stats.hpp"
+#include "LinePixelGenerators.hpp"
 
 class Line : public GeometricFigure {
 public:
-    Line(Vertex2d, Vertex2d);
+    Line(const Vertex2d&, const Vertex2d&);
     Line(float x1, float y1, float x2, float y2);
-    Vertex2d getInitialPoint() const;
-    void setInitialPoint(Vertex2d);
-    Vertex2d getFinalPoint() const;
-    void setFinalPoint(Vertex2d);
-    static Line generateLineBresenham(Vertex2d, Vertex2d);
-    static Line generateLineDDA(Vertex2d, Vertex2d);
+    const Vertex2d& getInitialPoint() const;
+    void setInitialPoint(const Vertex2d&);
+    const Vertex2d& getFinalPoint() const;
+    void setFinalPoint(const Vertex2d&);
+    static Line generateLineBresenham(const Vertex2d&, const Vertex2d&);
+    static Line generateLineRunSlice(const Vertex2d&, const Vertex2d&);
+    static Line generateLineDDA(const Vertex2d&, const Vertex2d&);
+    template <typename Sink, typename T> static void rasterizeLineBresenham(const BasicVertex2d<T>&, const BasicVertex2d<T>&, Sink&);
+    template <typename Sink, typename T> static void rasterizeLineRunSlice(const BasicVertex2d<T>&, const BasicVertex2d<T>&, Sink&);
+    template <typename Sink, typename T> static void rasterizeLineDDA(const BasicVertex2d<T>&, const BasicVertex2d<T>&, Sink&);
+    template <typename Sink, typename T> static void rasterizeLineWu(const BasicVertex2d<T>&, const BasicVertex2d<T>&, Sink&);
+    template <typename Sink> void rasterize(Sink&) const;
+    static PixelRange<DDALinePixelGenerator> iterateLineDDA(const Vertex2d&, const Vertex2d&);
+    static PixelRange<BresenhamLinePixelGenerator> iterateLineBresenham(const Vertex2d&, const Vertex2d&);
+    PixelRange<DDALinePixelGenerator> iteratePixels() const;
     void translate(float, float);
     void scale(float, float, float, float);
 private:
-    void applyTransformationMatrix(Matrix2d transformationMatrix);
+    void applyTransformationMatrix(Matrix2d& transformationMatrix);
+    void updateBoundingBox();
+    template <typename Sink> static void plotRun(Sink&, const Vertex2d&, int&, int&, int, int, int);
+    template <typename Sink> static void plotWuPixel(Sink&, const Vertex2d&, int, int, float, bool);
     
     Vertex2d initialPoint;
     Vertex2d finalPoint;
 };
 
+/**
+ * Rasterize a line into a sink, using the integer Bresenham algorithm.
+ * Works on all eight octants: the axis with the biggest variation is the
+ * driving axis, and the other one is stepped by the decision variable.
+ * @param initialPoint {BasicVertex2d<T>} - the initial coordinate of the line
+ * @param lastPoint {BasicVertex2d<T>} - the last coordinate of the line
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Line::rasterizeLineBresenham(const BasicVertex2d<T>& initialPoint, const BasicVertex2d<T>& lastPoint, Sink& sink) {
+    int currentX, currentY, lastX, lastY;
+    int xVariation, yVariation, xStep, yStep, d, count;
+    Vertex2d color;
+    color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+    
+    currentX = CoordinateTraits<T>::toPixel(initialPoint.getX());
+    currentY = CoordinateTraits<T>::toPixel(initialPoint.getY());
+    lastX = CoordinateTraits<T>::toPixel(lastPoint.getX());
+    lastY = CoordinateTraits<T>::toPixel(lastPoint.getY());
+    
+    xVariation = abs(lastX - currentX);
+    yVariation = abs(lastY - currentY);
+    xStep = (lastX >= currentX) ? 1 : -1;
+    yStep = (lastY >= currentY) ? 1 : -1;
+    
+    CG_STATS_ADD(PIXELS_BRESENHAM, std::max(xVariation, yVariation) + 1);
+    sink.plot(currentX, currentY, color);
+    
+    if (xVariation >= yVariation) {
+        // x is the driving axis
+        d = (2 * yVariation) - xVariation;
+        for (count = 0; count < xVariation; count++) {
+            currentX += xStep;
+            if (d >= 0) {
+                currentY += yStep;
+                d -= 2 * xVariation;
+            }
+            d += 2 * yVariation;
+            sink.plot(currentX, currentY, color);
+        }
+    } else {
+        // y is the driving axis
+        d = (2 * xVariation) - yVariation;
+        for (count = 0; count < yVariation; count++) {
+            currentY += yStep;
+            if (d >= 0) {
+                currentX += xStep;
+                d -= 2 * yVariation;
+            }
+            d += 2 * xVariation;
+            sink.plot(currentX, currentY, color);
+        }
+    }
+}
+
+/**
+ * Send a run of consecutive pixels to the sink, starting at (x, y) and
+ * walking length pixels. Horizontal runs are sent as a single span.
+ * @param sink {Sink&}
+ * @param color {Vertex2d}
+ * @param x {int&}, y {int&} - the current position, updated to the pixel after the run
+ * @param length {int} - the number of pixels of the run
+ * @param xStep {int}, yStep {int} - the direction of the run
+ */
+template <typename Sink>
+void Line::plotRun(Sink& sink, const Vertex2d& color, int& x, int& y, int length, int xStep, int yStep) {
+    if (length <= 0) {
+        return;
+    }
+    
+    if (yStep == 0) {
+        int lastX = x + xStep * (length - 1);
+        sink.span(std::min(x, lastX), std::max(x, lastX), y, color);
+        x = lastX + xStep;
+        return;
+    }
+    
+    for (; length > 0; length--) {
+        sink.plot(x, y, color);
+        x += xStep;
+        y += yStep;
+    }
+}
+
+/**
+ * Rasterize a line into a sink, using the run-length slice variant of Bresenham.
+ * Instead of deciding pixel by pixel, it decides once per run: a line
+ * whose driving axis varies dx and the other axis varies dy is made of dy + 1
+ * runs of either floor(dx / dy) or floor(dx / dy) + 1 pixels. Long and
+ * shallow (or steep) lines make very few decisions this way.
+ * @param initialPoint {BasicVertex2d<T>} - the initial coordinate of the line
+ * @param lastPoint {BasicVertex2d<T>} - the last coordinate of the line
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Line::rasterizeLineRunSlice(const BasicVertex2d<T>& initialPoint, const BasicVertex2d<T>& lastPoint, Sink& sink) {
+    int currentX, currentY, lastX, lastY;
+    int xVariation, yVariation, xStep, yStep;
+    int majorVariation, minorVariation;
+    int wholeStep, adjustUp, adjustDown, errorTerm;
+    int initialPixelCount, finalPixelCount, runLength, count;
+    Vertex2d color;
+    color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+    
+    currentX = CoordinateTraits<T>::toPixel(initialPoint.getX());
+    currentY = CoordinateTraits<T>::toPixel(initialPoint.getY());
+    lastX = CoordinateTraits<T>::toPixel(lastPoint.getX());
+    lastY = CoordinateTraits<T>::toPixel(lastPoint.getY());
+    
+    xVariation = abs(lastX - currentX);
+    yVariation = abs(lastY - currentY);
+    xStep = (lastX >= currentX) ? 1 : -1;
+    yStep = (lastY >= currentY) ? 1 : -1;
+    
+    bool xMajor = xVariation >= yVariation;
+    majorVariation = xMajor ? xVariation : yVariation;
+    minorVariation = xMajor ? yVariation : xVariation;
+    CG_STATS_ADD(PIXELS_RUN_SLICE, majorVariation + 1);
+    
+    // The run direction walks the driving axis, the slice step moves the other one
+    int runXStep = xMajor ? xStep : 0;
+    int runYStep = xMajor ? 0 : yStep;
+    int sliceXStep = xMajor ? 0 : xStep;
+    int sliceYStep = xMajor ? yStep : 0;
+    
+    // Lines parallel to an axis or diagonal are a single run
+    if (minorVariation == 0 || minorVariation == majorVariation) {
+        plotRun(sink, color, currentX, currentY, majorVariation + 1,
+                xStep * (xVariation != 0), yStep * (yVariation != 0));
+        return;
+    }
+    
+    wholeStep = majorVariation / minorVariation;
+    adjustUp = (majorVariation % minorVariation) * 2;
+    adjustDown = minorVariation * 2;
+    errorTerm = (majorVariation % minorVariation) - (minorVariation * 2);
+    
+    // The first and last runs are split halves of a whole run
+    initialPixelCount = (wholeStep / 2) + 1;
+    finalPixelCount = initialPixelCount;
+    
+    // With an even whole step and no fractional advance, one of the halves
+    // would get the extra pixel, so we give it to the last run
+    if (adjustUp == 0 && (wholeStep & 1) == 0) {
+        initialPixelCount--;
+    }
+    
+    // With an odd whole step, the middle pixel is shared by the halves
+    if ((wholeStep & 1) != 0) {
+        errorTerm += minorVariation;
+    }
+    
+    plotRun(sink, color, currentX, currentY, initialPixelCount, runXStep, runYStep);
+    currentX += sliceXStep;
+    currentY += sliceYStep;
+    
+    for (count = 0; count < minorVariation - 1; count++) {
+        runLength = wholeStep;
+        errorTerm += adjustUp;
+        if (errorTerm > 0) {
+            runLength++;
+            errorTerm -= adjustDown;
+        }
+        plotRun(sink, color, currentX, currentY, runLength, runXStep, runYStep);
+        currentX += sliceXStep;
+        currentY += sliceYStep;
+    }
+    
+    plotRun(sink, color, currentX, currentY, finalPixelCount, runXStep, runYStep);
+}
+
+/**
+ * Rasterize a line into a sink, using the DDA algorithm
+ * @param initialPoint - the initial coordinate of the line
+ * @param lastPoint - the last coordinate of the line
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Line::rasterizeLineDDA(const BasicVertex2d<T>& initialPoint, const BasicVertex2d<T>& lastPoint, Sink& sink) {
+    typedef typename CoordinateTraits<T>::Real Real;
+    int xVariation, yVariation;
+    Real xIncrement, yIncrement;
+    int numOfIterations, count;
+    Real currentX, currentY;
+    Vertex2d color;
+    color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+    
+    xVariation = lastPoint.getX() - initialPoint.getX();
+    yVariation = lastPoint.getY() - initialPoint.getY();
+    
+    if (abs(xVariation) > abs(yVariation)) {
+        numOfIterations = abs(xVariation);
+    } else {
+        numOfIterations = abs(yVariation);
+    }
+    
+    xIncrement = (Real) xVariation / numOfIterations;
+    yIncrement = (Real) yVariation / numOfIterations;
+    
+    currentX = initialPoint.getX();
+    currentY = initialPoint.getY();
+    
+    CG_STATS_ADD(PIXELS_DDA, std::max(numOfIterations, 1));
+    sink.plot((int) round(currentX), (int) round(currentY), color);
+    
+    for (count = 1; count < numOfIterations; count++) {
+        currentX += xIncrement;
+        currentY += yIncrement;
+        sink.plot((int) round(currentX), (int) round(currentY), color);
+    }
+}
+
+/**
+ * Send a pixel of a Wu line to the sink, swapping back the axes of steep lines
+ * @param sink {Sink&}
+ * @param color {Vertex2d}
+ * @param major {int}, minor {int} - the pixel, along the driving axis and the other one
+ * @param coverage {float} - fraction of the pixel covered by the line
+ * @param steep {bool} - whether y is the driving axis
+ */
+template <typename Sink>
+void Line::plotWuPixel(Sink& sink, const Vertex2d& color, int major, int minor, float coverage, bool steep) {
+    int x = steep ? minor : major;
+    int y = steep ? major : minor;
+    
+    if (coverage >= 1.0f) {
+        sink.plot(x, y, color);
+    } else if (coverage > 0.0f) {
+        sink.plotCoverage(x, y, color, coverage);
+    }
+}
+
+/**
+ * Rasterize an anti-aliased line into a sink, using the Xiaolin Wu algorithm.
+ * Along the driving axis there is one step per pixel, like in DDA, but the
+ * exact position on the other axis is split between the two pixels around
+ * it, in proportion to how close each one is. The sink must take coverage
+ * (see PixelSink.hpp).
+ * @param initialPoint {BasicVertex2d<T>} - the initial coordinate of the line
+ * @param lastPoint {BasicVertex2d<T>} - the last coordinate of the line
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Line::rasterizeLineWu(const BasicVertex2d<T>& initialPoint, const BasicVertex2d<T>& lastPoint, Sink& sink) {
+    Vertex2d color;
+    color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+    
+    typedef typename CoordinateTraits<T>::Real Real;
+    Real initialMajor = initialPoint.getX(), initialMinor = initialPoint.getY();
+    Real lastMajor = lastPoint.getX(), lastMinor = lastPoint.getY();
+    
+    // Work on the driving axis as if it were x
+    bool steep = std::fabs(lastMinor - initialMinor) > std::fabs(lastMajor - initialMajor);
+    if (steep) {
+        std::swap(initialMajor, initialMinor);
+        std::swap(lastMajor, lastMinor);
+    }
+    if (initialMajor > lastMajor) {
+        std::swap(initialMajor, lastMajor);
+        std::swap(initialMinor, lastMinor);
+    }
+    
+    Real majorVariation = lastMajor - initialMajor;
+    Real gradient = (majorVariation == 0) ? 0 : (lastMinor - initialMinor) / majorVariation;
+    
+    // The ends are rounded on the driving axis only
+    int firstMajor = (int) std::lround(initialMajor);
+    int finalMajor = (int) std::lround(lastMajor);
+    Real minor = initialMinor + gradient * (firstMajor - initialMajor);
+    
+    CG_STATS_ADD(PIXELS_WU, 2 * (finalMajor - firstMajor + 1));
+    for (int major = firstMajor; major <= finalMajor; major++) {
+        Real lowerMinor = std::floor(minor);
+        float fraction = minor - lowerMinor;
+        plotWuPixel(sink, color, major, (int) lowerMinor, 1.0f - fraction, steep);
+        plotWuPixel(sink, color, major, (int) lowerMinor + 1, fraction, steep);
+        minor += gradient;
+    }
+}
+
+/**
+ * Rasterize this line into a sink. Lines are drawn with DDA,
+ * like the ones built by the transformations.
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Line::rasterize(Sink& sink) const {
+    Line::rasterizeLineDDA(this->initialPoint, this->finalPoint, sink);
+}
+
 #endif /* Line_hpp */
@@ -0,0 +1,159 @@
+/**
+ * LinePixelGenerators.hpp
+ * Pixel generators for lines, to be used with PixelRange. They produce
+ * the same pixels as Line::rasterizeLineDDA and Line::rasterizeLineBresenham,
+ * one at a time.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef LinePixelGenerators_hpp
+#define LinePixelGenerators_hpp
+
+#include <cmath>
+#include <cstdlib>
+#include "../common/Vertex2d.hpp"
+
+class DDALinePixelGenerator {
+public:
+    DDALinePixelGenerator(const Vertex2d&, const Vertex2d&);
+    bool next(Vertex2d&);
+private:
+    float currentX;
+    float currentY;
+    float xIncrement;
+    float yIncrement;
+    int count;
+    int numOfIterations;
+    Vertex2d color;
+};
+
+class BresenhamLinePixelGenerator {
+public:
+    BresenhamLinePixelGenerator(const Vertex2d&, const Vertex2d&);
+    bool next(Vertex2d&);
+private:
+    int currentX;
+    int currentY;
+    int xStep;
+    int yStep;
+    int xVariation;
+    int yVariation;
+    int d;
+    int remaining;
+    bool started;
+    Vertex2d color;
+};
+
+/**
+ * Constructor of the class
+ * @param initialPoint {Vertex2d} - the initial coordinate of the line
+ * @param lastPoint {Vertex2d} - the last coordinate of the line
+ */
+inline DDALinePixelGenerator::DDALinePixelGenerator(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    int xVariation = lastPoint.getX() - initialPoint.getX();
+    int yVariation = lastPoint.getY() - initialPoint.getY();
+    
+    if (abs(xVariation) > abs(yVariation)) {
+        this->numOfIterations = abs(xVariation);
+    } else {
+        this->numOfIterations = abs(yVariation);
+    }
+    
+    this->xIncrement = (float) xVariation / this->numOfIterations;
+    this->yIncrement = (float) yVariation / this->numOfIterations;
+    this->currentX = initialPoint.getX();
+    this->currentY = initialPoint.getY();
+    this->count = 0;
+    this->color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+}
+
+/**
+ * Write the next pixel of the line
+ * @param pixel {Vertex2d&}
+ * @return {bool} - false when the line is over
+ */
+inline bool DDALinePixelGenerator::next(Vertex2d& pixel) {
+    // Like in the DDA rasterizer, the initial point is always produced
+    if (this->count > 0) {
+        if (this->count >= this->numOfIterations) {
+            return false;
+        }
+        this->currentX += this->xIncrement;
+        this->currentY += this->yIncrement;
+    }
+    
+    this->count++;
+    pixel = this->color;
+    pixel.setX((int) round(this->currentX));
+    pixel.setY((int) round(this->currentY));
+    return true;
+}
+
+/**
+ * Constructor of the class
+ * @param initialPoint {Vertex2d} - the initial coordinate of the line
+ * @param lastPoint {Vertex2d} - the last coordinate of the line
+ */
+inline BresenhamLinePixelGenerator::BresenhamLinePixelGenerator(const Vertex2d& initialPoint, const Vertex2d& lastPoint) {
+    this->currentX = (int) lround(initialPoint.getX());
+    this->currentY = (int) lround(initialPoint.getY());
+    int lastX = (int) lround(lastPoint.getX());
+    int lastY = (int) lround(lastPoint.getY());
+    
+    this->xVariation = abs(lastX - this->currentX);
+    this->yVariation = abs(lastY - this->currentY);
+    this->xStep = (lastX >= this->currentX) ? 1 : -1;
+    this->yStep = (lastY >= this->currentY) ? 1 : -1;
+    
+    if (this->xVariation >= this->yVariation) {
+        this->d = (2 * this->yVariation) - this->xVariation;
+        this->remaining = this->xVariation;
+    } else {
+        this->d = (2 * this->xVariation) - this->yVariation;
+        this->remaining = this->yVariation;
+    }
+    
+    this->started = false;
+    this->color.setRGBColors(initialPoint.getRed(), initialPoint.getGreen(), initialPoint.getBlue());
+}
+
+/**
+ * Write the next pixel of the line
+ * @param pixel {Vertex2d&}
+ * @return {bool} - false when the line is over
+ */
+inline bool BresenhamLinePixelGenerator::next(Vertex2d& pixel) {
+    if (this->started) {
+        if (this->remaining == 0) {
+            return false;
+        }
+        this->remaining--;
+        
+        if (this->xVariation >= this->yVariation) {
+            // x is the driving axis
+            this->currentX += this->xStep;
+            if (this->d >= 0) {
+                this->currentY += this->yStep;
+                this->d -= 2 * this->xVariation;
+            }
+            this->d += 2 * this->yVariation;
+        } else {
+            // y is the driving axis
+            this->currentY += this->yStep;
+            if (this->d >= 0) {
+                this->currentX += this->xStep;
+                this->d -= 2 * this->yVariation;
+            }
+            this->d += 2 * this->xVariation;
+        }
+    }
+    
+    this->started = true;
+    pixel = this->color;
+    pixel.setX(this->currentX);
+    pixel.setY(this->currentY);
+    return true;
+}
+
+#endif /* LinePixelGenerators_hpp */
@@ -17,11 +17,21 @@
 #include "polygons/EdgesTable.hpp"
 #include "2D_transformations/Matrix2d.hpp"
 #include "2D_transformations/TransformationMatrix.hpp"
+#include "2D_transformations/TransformNode.hpp"
 #include "polygons/Polygon.hpp"
 #include "lines/Line.hpp"
 #include "lines/Circumference.hpp"
 #include "common/CodedVertex2d.hpp"
 #include "common/ViewportWindow.hpp"
+#include "common/AllocationCounter.hpp"
+#include "common/FrameArena.hpp"
+#include "common/Stats.hpp"
+#include "common/Trace.hpp"
+#include "tests/Test.hpp"
+#include "common/RetainedRenderer.hpp"
+#include "common/RenderThread.hpp"
+#include "benchmarks/Benchmark.hpp"
+#include "batch/BatchRenderer.hpp"
 
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
@@ -36,6 +46,9 @@ void printGeometricFigure(GeometricFigure figure);
 void viewportClipLineDemo();
 void viewportClipPolygonDemo();
 void transformationDemo();
+void dirtyRectanglesDemo();
+void recordTransformationScene(CommandBuffer& commandBuffer);
+void stopRenderThread();
 void timer(int value);
 
 // Define the window position on screen
@@ -46,8 +59,48 @@ int variationX = 0;
 float scaleVariation = 1.0;
 bool isShrinking = true;
 
+// Rasterizes the frames when the program is started with --render-thread
+RenderThread *renderThread = NULL;
+
+// The hearts of viewportClipPolygonDemo, all scaled together by their group
+TransformNode heartsGroup;
+TransformNode heartNodes[5];
+
 int main(int argc, char **argv) {
     
+    // Headless tests, no window is created (see tests/Test.cpp for the options)
+    if (argc > 1 && string(argv[1]) == "--test") {
+        return runTests(argc, argv);
+    }
+    
+    // Headless benchmarks, no window is created (see benchmarks/Benchmark.cpp for the options)
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        return runBenchmarks(argc, argv);
+    }
+    
+    // Headless rendering of scene files into images (see batch/BatchRenderer.cpp for the options)
+    if (argc > 1 && string(argv[1]) == "--render") {
+        return runBatchRender(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--convert-scene") {
+        return runSceneConverter(argc, argv);
+    }
+    
+    // Write a Chrome trace of the pipeline stages (only recorded when built with CG_ENABLE_TRACE)
+    if (argc > 2 && string(argv[1]) == "--trace") {
+        Trace::start(argv[2]);
+        atexit(Trace::stop);
+    }
+    
+    // Record the frames on the timer and rasterize them on a thread of their own
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--render-thread") {
+            renderThread = new RenderThread(SCREEN_WIDTH, SCREEN_HEIGHT);
+            renderThread->start();
+            atexit(stopRenderThread);
+        }
+    }
+    
     // Initialize glut
     glutInit(&argc, argv);
     
@@ -92,25 +145,72 @@ void timer(int value) {
         if (scaleVariation >= 1.0f) {isShrinking = !isShrinking;}
     }
     
+    // The frame is only recorded here. When the render thread is still busy
+    // with the previous ones, this frame is skipped, but the animation goes on.
+    if (renderThread) {
+        CommandBuffer *commandBuffer = renderThread->acquire();
+        if (commandBuffer) {
+            recordTransformationScene(*commandBuffer);
+            renderThread->submit(commandBuffer);
+        }
+    }
+    
     glutPostRedisplay();
     glutTimerFunc(20, timer, 1);
 }
 
 void onDisplay() {
-    glClearColor(0.0, 0.0, 0.0, 0.0);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glOrtho(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT, 0.0, 1.0);
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    
-//    viewportClipLineDemo();
-    viewportClipPolygonDemo();
+    unsigned long allocationsBefore = AllocationCounter::getAllocations();
+    
+    {
+        // Only timed when built with CG_ENABLE_STATS
+        CG_STATS_TIMER(STAGE_FRAME);
+        CG_TRACE_SPAN("frame");
+        
+        {
+            CG_STATS_TIMER(STAGE_CLEAR);
+            glClearColor(0.0, 0.0, 0.0, 0.0);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glOrtho(0.0, SCREEN_WIDTH, 0.0, SCREEN_HEIGHT, 0.0, 1.0);
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        
+        {
+            CG_STATS_TIMER(STAGE_DRAW);
+            
+            if (renderThread) {
+                // The render thread already rasterized it, just draw the last completed frame
+                renderThread->present();
+            } else {
+                // Everything the pipeline allocates from the frame arena is given back at the end of the frame
+                FrameArena::Scope frameScope(*FrameArena::getInstance());
+                
+//                viewportClipLineDemo();
+//                dirtyRectanglesDemo();
+                viewportClipPolygonDemo();
+            }
+        }
+        
+        glPopMatrix();
+        
+        {
+            CG_STATS_TIMER(STAGE_PRESENT);
+            CG_TRACE_SPAN("present");
+            glFlush();
+            glutSwapBuffers();
+        }
+    }
     
-    glPopMatrix();
+    // Print the stats every 100 frames
+    CG_STATS_END_FRAME(cout);
     
-    glFlush();
-    glutSwapBuffers();
+    // Only when built with CG_COUNT_ALLOCATIONS
+    if (AllocationCounter::isEnabled()) {
+        cout << "Allocations in this frame: " << AllocationCounter::getAllocations() - allocationsBefore;
+        cout << ", frame arena high-water mark: " << FrameArena::getInstance()->getHighWaterMark() << " bytes" << endl;
+    }
 }
 
 void viewportClipLineDemo() {
@@ -141,14 +241,14 @@ void viewportClipLineDemo() {
     Vertex2d topRight(200.0f, 200.0f);
     Vertex2d bottomLeft(100.0f, 100.0f);
     Vertex2d bottomRight(200.0f, 100.0f);
-    list<Vertex2d> listPolygonViewPort;
+    VertexBuffer listPolygonViewPort;
     listPolygonViewPort.push_back(topLeft);
     listPolygonViewPort.push_back(bottomLeft);
     listPolygonViewPort.push_back(bottomRight);
     listPolygonViewPort.push_back(topRight);
-    Polygon polygonViewPort = Polygon::generateNotFilledPolygon(listPolygonViewPort);
+    Polygon polygonViewPort = Polygon::generateNotFilledPolygon(std::move(listPolygonViewPort));
     polygonViewPort.GeometricFigure::plotPoints();
-
+    
     vpw.clipLine(line1);
     vpw.clipLine(line2);
     vpw.clipLine(line3);
@@ -167,13 +267,13 @@ void viewportClipLineDemo() {
     line2.plotPoints();
     line3.plotPoints();
     line4.plotPoints();
-
-    std::list<GeometricFigure*> clippedObjects = vpw.getVisibleObjects();
+    
+    const std::list<GeometricFigure*>& clippedObjects = vpw.getVisibleObjects();
     std::list<GeometricFigure*>::const_iterator it;
     
     for (it = clippedObjects.begin(); it != clippedObjects.end(); it++) {
-        Vertex2d initialPoint = static_cast<Line*>(*it)->getInitialPoint();
-        Vertex2d finalPoint = static_cast<Line*>(*it)->getFinalPoint();
+        const Vertex2d& initialPoint = static_cast<Line*>(*it)->getInitialPoint();
+        const Vertex2d& finalPoint = static_cast<Line*>(*it)->getFinalPoint();
         Line line = Line::generateLineDDA(initialPoint, finalPoint);
         line.GeometricFigure::plotPoints();
     }
@@ -189,12 +289,12 @@ void viewportClipPolygonDemo() {
     bottomLeft.setRGBColors(0.4, 0.7, 0.2);
     Vertex2d bottomRight(0.0f, 100.0f);
     bottomRight.setRGBColors(0.4, 0.7, 0.2);
-    list<Vertex2d> listPolygonViewPort;
+    VertexBuffer listPolygonViewPort;
     listPolygonViewPort.push_back(topLeft);
     listPolygonViewPort.push_back(bottomLeft);
     listPolygonViewPort.push_back(bottomRight);
     listPolygonViewPort.push_back(topRight);
-    Polygon polygonViewPort = Polygon::generateFilledPolygon(listPolygonViewPort);
+    Polygon polygonViewPort = Polygon::generateFilledPolygon(std::move(listPolygonViewPort));
     polygonViewPort.rotate(angleToRotate, -50.0, 150.0);
     polygonViewPort.translate(variationX, 0.0);
     polygonViewPort.GeometricFigure::plotPoints();
@@ -207,12 +307,12 @@ void viewportClipPolygonDemo() {
     bottomLeft2.setRGBColors(0.9, 0.7, 0.2);
     Vertex2d bottomRight2(50.0f, 150.0f);
     bottomRight2.setRGBColors(0.9, 0.7, 0.2);
-    list<Vertex2d> listPolygonViewPort2;
+    VertexBuffer listPolygonViewPort2;
     listPolygonViewPort2.push_back(topLeft2);
     listPolygonViewPort2.push_back(bottomLeft2);
     listPolygonViewPort2.push_back(bottomRight2);
     listPolygonViewPort2.push_back(topRight2);
-    Polygon polygonViewPort2 = Polygon::generateFilledPolygon(listPolygonViewPort2);
+    Polygon polygonViewPort2 = Polygon::generateFilledPolygon(std::move(listPolygonViewPort2));
     polygonViewPort2.rotate(angleToRotate, 0, 225.0);
     polygonViewPort2.translate(variationX, 0.0);
     polygonViewPort2.scale(scaleVariation, scaleVariation, 50, 150);
@@ -268,10 +368,10 @@ void viewportClipPolygonDemo() {
     Vertex2d vertex46(-10.0f, 20.0f);
     Vertex2d vertex47(-10.0f, 10.0f);
     Vertex2d vertex48(0.0f, 10.0f);
-
+    
     
     // pushing the heart's vertices to a list
-    list<Vertex2d> listPolygonViewPortHeart;
+    VertexBuffer listPolygonViewPortHeart;
     listPolygonViewPortHeart.push_back(vertex1);
     listPolygonViewPortHeart.push_back(vertex2);
     listPolygonViewPortHeart.push_back(vertex3);
@@ -320,44 +420,45 @@ void viewportClipPolygonDemo() {
     listPolygonViewPortHeart.push_back(vertex46);
     listPolygonViewPortHeart.push_back(vertex47);
     listPolygonViewPortHeart.push_back(vertex48);
-
+    
+    // The hearts breathe together: the scale is set once on their group, and
+    // each heart only keeps its own moves. Their vertices are never changed.
+    TransformationMatrix *transformations = TransformationMatrix::getInstance();
+    heartsGroup.setLocalMatrix(transformations->getScaleMatrix(scaleVariation, scaleVariation, 50, 150));
+    for (TransformNode& heartNode : heartNodes) {
+        heartNode.setParent(&heartsGroup);
+        heartNode.resetLocalMatrix();
+    }
+    
     // 1st heart
-    Polygon heart = Polygon::generateFilledPolygon(listPolygonViewPortHeart);
-    heart.translate(variationX, 0.0);
-    heart.scale(scaleVariation, scaleVariation, 50, 150);
-    heart.GeometricFigure::plotPoints();
-
+    heartNodes[0].translate(variationX, 0.0);
+    
     // 2nd hearth
-    Polygon heart2 = Polygon::generateFilledPolygon(listPolygonViewPortHeart);
-    heart2.translate(50.0f, 50.0f);
-    heart2.translate(variationX, variationX);
-    heart2.scale(1.3, 1.3, 0, 50);
-    heart2.scale(scaleVariation, scaleVariation, 50, 150);
-    heart2.GeometricFigure::plotPoints();
+    heartNodes[1].translate(50.0f, 50.0f);
+    heartNodes[1].translate(variationX, variationX);
+    heartNodes[1].scale(1.3, 1.3, 0, 50);
     
     // 3rd heart
-    Polygon heart3 = Polygon::generateFilledPolygon(listPolygonViewPortHeart);
-    heart3.translate(800.0f, 600.0f);
-    heart3.translate(-variationX, -variationX);
-    heart3.scale(1.1, 1.1, 0, 50);
-    heart3.scale(scaleVariation, scaleVariation, 50, 150);
-    heart3.GeometricFigure::plotPoints();
+    heartNodes[2].translate(800.0f, 600.0f);
+    heartNodes[2].translate(-variationX, -variationX);
+    heartNodes[2].scale(1.1, 1.1, 0, 50);
     
     // 4rd heart
-    Polygon heart4 = Polygon::generateFilledPolygon(listPolygonViewPortHeart);
-    heart4.translate(800.0f, 50.0f);
-    heart4.translate(-variationX, variationX);
-    heart4.scale(0.6, 0.6, 0, 50);
-    heart4.scale(scaleVariation, scaleVariation, 50, 150);
-    heart4.GeometricFigure::plotPoints();
+    heartNodes[3].translate(800.0f, 50.0f);
+    heartNodes[3].translate(-variationX, variationX);
+    heartNodes[3].scale(0.6, 0.6, 0, 50);
     
     // 5th heart
-    Polygon heart5 = Polygon::generateFilledPolygon(listPolygonViewPortHeart);
-    heart5.translate(200.0f, 300.0f);
-    heart5.translate(sin(variationX/10), 0);
-    heart5.scale(1.4, 1.4, 0, 50);
-    heart5.scale(scaleVariation, scaleVariation, 50, 150);
-    heart5.GeometricFigure::plotPoints();
+    heartNodes[4].translate(200.0f, 300.0f);
+    heartNodes[4].translate(sin(variationX/10), 0);
+    heartNodes[4].scale(1.4, 1.4, 0, 50);
+    
+    for (TransformNode& heartNode : heartNodes) {
+        VertexBuffer heartVertices;
+        heartNode.transform(listPolygonViewPortHeart, heartVertices);
+        Polygon heart = Polygon::generateFilledPolygon(std::move(heartVertices));
+        heart.GeometricFigure::plotPoints();
+    }
     
     // star mask
     Vertex2d star1(40.0f, -40.0f);
@@ -373,7 +474,7 @@ void viewportClipPolygonDemo() {
     Vertex2d star10(0.0f, -10.0f);
     
     // Star pushing to a list
-    list<Vertex2d> listPolygonViewPortStar;
+    VertexBuffer listPolygonViewPortStar;
     listPolygonViewPortStar.push_back(star1);
     listPolygonViewPortStar.push_back(star2);
     listPolygonViewPortStar.push_back(star3);
@@ -402,7 +503,7 @@ void viewportClipPolygonDemo() {
     starPolygon2.GeometricFigure::plotPoints();
     
     // 3rd star
-    Polygon starPolygon3 = Polygon::generateFilledPolygon(listPolygonViewPortStar);
+    Polygon starPolygon3 = Polygon::generateFilledPolygon(std::move(listPolygonViewPortStar));
     starPolygon3.translate(300.0f, 300.0f);
     starPolygon3.translate(-0.5*variationX, -1.5f*variationX);
     starPolygon3.scale(2.0, 2.0, 0, 50);
@@ -429,7 +530,7 @@ void viewportClipPolygonDemo() {
 //    d.setRGBColors(0.7, 0.6, 0.8);
     
     // pushing in counter-clockwise orientation
-//    list<Vertex2d> listPolygon1;
+//    VertexBuffer listPolygon1;
 //    listPolygon1.push_back(a);
 //    listPolygon1.push_back(b);
 //    listPolygon1.push_back(c);
@@ -450,7 +551,7 @@ void viewportClipPolygonDemo() {
 //    // Iterating and Plotting all objects in Viewport
 //    for (it = clippedObjects.begin(); it != clippedObjects.end(); it++) {
 //        Polygon *tempPolygon = static_cast<Polygon*>(*it);
-//        Polygon newPolygon = Polygon::generateFilledPolygon(tempPolygon->getVerticesList());
+//        Polygon newPolygon = Polygon::generateFilledPolygon(tempPolygon->getVertices());
 //        newPolygon.GeometricFigure::plotPoints();
 //    }
     
@@ -458,7 +559,7 @@ void viewportClipPolygonDemo() {
 
 void transformationDemo() {
     // The list of points that will form the polygon
-    list<Vertex2d> listOfCoordinates;
+    VertexBuffer listOfCoordinates;
     
     // Create some points
     Vertex2d pointA(50, 50);
@@ -490,6 +591,85 @@ void transformationDemo() {
     polygon.GeometricFigure::plotPoints();
 }
 
+/**
+ * A static dashboard of squares with a small square moving over it.
+ * Only the regions the moving square leaves and enters are redrawn.
+ */
+void dirtyRectanglesDemo() {
+    static RetainedRenderer renderer(SCREEN_WIDTH, SCREEN_HEIGHT);
+    static vector<Polygon> dashboard;
+    static Polygon movingSquare;
+    
+    if (dashboard.empty()) {
+        // The renderer keeps pointers to the figures, so they can not be moved around
+        dashboard.reserve(12 * 9);
+        for (int row = 0; row < 9; row++) {
+            for (int column = 0; column < 12; column++) {
+                Vertex2d color;
+                color.setRGBColors(0.2f + 0.05f * row, 0.3f, 0.2f + 0.05f * column);
+                VertexBuffer square;
+                square.push_back(Vertex2d(10 + 52 * column, 10 + 52 * row));
+                square.push_back(Vertex2d(10 + 52 * column, 50 + 52 * row));
+                square.push_back(Vertex2d(50 + 52 * column, 50 + 52 * row));
+                square.push_back(Vertex2d(50 + 52 * column, 10 + 52 * row));
+                square[0].setRGBColors(color.getRed(), color.getGreen(), color.getBlue());
+                dashboard.push_back(Polygon::generateFilledPolygon(std::move(square)));
+                renderer.setFigure((int) dashboard.size(), &dashboard.back());
+            }
+        }
+    }
+    
+    Vertex2d red(0, 0);
+    red.setRGBColors(0.9f, 0.1f, 0.1f);
+    VertexBuffer square;
+    square.push_back(red);
+    square.push_back(Vertex2d(0, 30));
+    square.push_back(Vertex2d(30, 30));
+    square.push_back(Vertex2d(30, 0));
+    movingSquare = Polygon::generateFilledPolygon(std::move(square));
+    movingSquare.translate(variationX % SCREEN_WIDTH, 200);
+    renderer.setFigure(0, &movingSquare);
+    
+    renderer.render();
+    renderer.present();
+}
+
+/**
+ * Record the rotating squares of viewportClipPolygonDemo, plus a circumference
+ * following them, to be rasterized by the render thread
+ * @param commandBuffer {CommandBuffer&}
+ */
+void recordTransformationScene(CommandBuffer& commandBuffer) {
+    commandBuffer.recordClear(0.0f, 0.0f, 0.0f);
+    
+    Vertex2d green(-100.0f, 200.0f);
+    green.setRGBColors(0.4, 0.7, 0.2);
+    Vertex2d greenSquare[] = {green, Vertex2d(-100.0f, 100.0f), Vertex2d(0.0f, 100.0f), Vertex2d(0.0f, 200.0f)};
+    commandBuffer.recordRotate(angleToRotate, -50.0, 150.0);
+    commandBuffer.recordTranslate(variationX, 0.0);
+    commandBuffer.recordPolygon(greenSquare, true);
+    
+    Vertex2d yellow(-50.0f, 250.0f);
+    yellow.setRGBColors(0.9, 0.7, 0.2);
+    Vertex2d yellowSquare[] = {yellow, Vertex2d(-50.0f, 150.0f), Vertex2d(50.0f, 150.0f), Vertex2d(50.0f, 250.0f)};
+    commandBuffer.recordRotate(angleToRotate, 0, 225.0);
+    commandBuffer.recordTranslate(variationX, 0.0);
+    commandBuffer.recordScale(scaleVariation, scaleVariation, 50, 150);
+    commandBuffer.recordPolygon(yellowSquare, true);
+    
+    Vertex2d center(0.0f, 350.0f);
+    center.setRGBColors(0.2, 0.5, 0.9);
+    commandBuffer.recordTranslate(variationX, 0.0);
+    commandBuffer.recordCircumference(center, 40 * scaleVariation);
+}
+
+/**
+ * Stop the render thread when the program exits
+ */
+void stopRenderThread() {
+    renderThread->stop();
+}
+
 /**
  * this function is responsible to set the x and y coordinates
  * such as the window gets centered
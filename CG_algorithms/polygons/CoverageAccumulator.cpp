@@ -0,0 +1,196 @@
+/**
+ * CoverageAccumulator.cpp
+ * Class that computes, row by row, the exact fraction of each pixel covered
+ * by a polygon.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "CoverageAccumulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Constructor of the class. Keeps the edges that are not horizontal,
+ * sorted by their top, in coordinates where pixel (x, y) is the square
+ * [x, x + 1) x [y, y + 1) and the first column is 0.
+ * @param vertices {VertexSpan} - the polygon vertices, in order
+ * @param arena {FrameArena*} - where the edges and the row are allocated, NULL for the heap
+ */
+CoverageAccumulator::CoverageAccumulator(VertexSpan vertices, FrameArena *arena):
+    edges(ArenaAllocator<CoverageEdge>(arena)), activeEdges(ArenaAllocator<size_t>(arena)),
+    nextEdge(0), row(ArenaAllocator<float>(arena)), firstRow(0), lastRow(-1), firstColumn(0) {
+    if (vertices.size() < 3) {
+        return;
+    }
+    
+    float xMin = vertices[0].getX(), xMax = xMin;
+    float yMin = vertices[0].getY(), yMax = yMin;
+    for (const Vertex2d& vertice : vertices) {
+        xMin = min(xMin, vertice.getX());
+        xMax = max(xMax, vertice.getX());
+        yMin = min(yMin, vertice.getY());
+        yMax = max(yMax, vertice.getY());
+    }
+    
+    // Pixel centers are on the integers, so the pixel borders are half a unit away
+    this->firstColumn = (int) floorf(xMin + 0.5f);
+    this->firstRow = (int) floorf(yMin + 0.5f);
+    this->lastRow = (int) ceilf(yMax + 0.5f) - 1;
+    float xOffset = 0.5f - this->firstColumn;
+    
+    this->edges.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertex2d& current = vertices[i];
+        const Vertex2d& next = vertices[(i + 1 == vertices.size()) ? 0 : i + 1];
+    
+        // Horizontal edges do not cover anything
+        if (current.getY() == next.getY()) {
+            continue;
+        }
+    
+        CoverageEdge edge;
+        bool goingUp = next.getY() > current.getY();
+        const Vertex2d& top = goingUp ? current : next;
+        const Vertex2d& bottom = goingUp ? next : current;
+        edge.xTop = top.getX() + xOffset;
+        edge.yTop = top.getY() + 0.5f;
+        edge.xBottom = bottom.getX() + xOffset;
+        edge.yBottom = bottom.getY() + 0.5f;
+        edge.direction = goingUp ? 1.0f : -1.0f;
+        this->edges.push_back(edge);
+    }
+    
+    sort(this->edges.begin(), this->edges.end(), [](const CoverageEdge& a, const CoverageEdge& b) {
+        return a.yTop < b.yTop;
+    });
+    
+    // One column of margin on the right, where the last edges end
+    this->row.assign((size_t) ceilf(xMax + xOffset) + 2, 0.0f);
+}
+
+/**
+ * Whether the polygon covers no row at all
+ * @return {bool}
+ */
+bool CoverageAccumulator::isEmpty() const {
+    return this->edges.empty();
+}
+
+/**
+ * Getters for the rows and columns the polygon may cover
+ * @return {int}
+ */
+int CoverageAccumulator::getFirstRow() const {
+    return this->firstRow;
+}
+
+int CoverageAccumulator::getLastRow() const {
+    return this->lastRow;
+}
+
+int CoverageAccumulator::getFirstColumn() const {
+    return this->firstColumn;
+}
+
+int CoverageAccumulator::getWidth() const {
+    return (int) this->row.size();
+}
+
+/**
+ * Add the area of a piece of edge, entirely inside the current row, to the
+ * pixels it crosses, and its height to the pixel right after it. This is the
+ * accumulation used by font rasterizers such as font-rs.
+ * @param xStart {float}, yStart {float} - the top of the piece
+ * @param xEnd {float}, yEnd {float} - the bottom of the piece
+ * @param direction {float} - 1 or -1, the winding of the edge
+ */
+void CoverageAccumulator::accumulateSegment(float xStart, float yStart, float xEnd, float yEnd, float direction) {
+    float height = (yEnd - yStart) * direction;
+    float xLeft = min(xStart, xEnd);
+    float xRight = max(xStart, xEnd);
+    int leftColumn = (int) floorf(xLeft);
+    int rightColumn = (int) ceilf(xRight);
+    float *accumulation = this->row.data();
+    
+    // The piece stays in a single pixel: the area on its right is a trapezoid
+    if (rightColumn <= leftColumn + 1) {
+        float middle = 0.5f * (xStart + xEnd) - leftColumn;
+        accumulation[leftColumn] += height * (1.0f - middle);
+        accumulation[leftColumn + 1] += height * middle;
+        return;
+    }
+    
+    // Otherwise the area grows linearly along the pixels it crosses, with
+    // triangles in the first and last ones
+    float inverseWidth = 1.0f / (xRight - xLeft);
+    float leftFraction = xLeft - leftColumn;
+    float firstArea = 0.5f * inverseWidth * (1.0f - leftFraction) * (1.0f - leftFraction);
+    float rightFraction = xRight - rightColumn + 1.0f;
+    float lastArea = 0.5f * inverseWidth * rightFraction * rightFraction;
+    
+    accumulation[leftColumn] += height * firstArea;
+    if (rightColumn == leftColumn + 2) {
+        accumulation[leftColumn + 1] += height * (1.0f - firstArea - lastArea);
+    } else {
+        float secondArea = inverseWidth * (1.5f - leftFraction);
+        accumulation[leftColumn + 1] += height * (secondArea - firstArea);
+        for (int column = leftColumn + 2; column < rightColumn - 1; column++) {
+            accumulation[column] += height * inverseWidth;
+        }
+        float beforeLastArea = secondArea + (rightColumn - leftColumn - 3) * inverseWidth;
+        accumulation[rightColumn - 1] += height * (1.0f - beforeLastArea - lastArea);
+    }
+    accumulation[rightColumn] += height * lastArea;
+}
+
+/**
+ * Compute the coverage of every pixel of a row. The rows must be asked in order.
+ * @param y {int} - the row, between getFirstRow and getLastRow
+ * @return {const float*} - getWidth signed coverages, from getFirstColumn on;
+ * their absolute value, up to 1, is the covered fraction of the pixel
+ */
+const float* CoverageAccumulator::accumulateRow(int y) {
+    float rowTop = (float) y;
+    float rowBottom = rowTop + 1.0f;
+    fill(this->row.begin(), this->row.end(), 0.0f);
+    
+    // The edges starting above the bottom of the row become active
+    while (this->nextEdge < this->edges.size() && this->edges[this->nextEdge].yTop < rowBottom) {
+        this->activeEdges.push_back(this->nextEdge++);
+    }
+    
+    for (size_t i = 0; i < this->activeEdges.size();) {
+        const CoverageEdge& edge = this->edges[this->activeEdges[i]];
+    
+        // Edges that ended above this row are done
+        if (edge.yBottom <= rowTop) {
+            this->activeEdges[i] = this->activeEdges.back();
+            this->activeEdges.pop_back();
+            continue;
+        }
+    
+        // The piece of the edge inside the row
+        float inverseSlope = (edge.xBottom - edge.xTop) / (edge.yBottom - edge.yTop);
+        float yStart = max(rowTop, edge.yTop);
+        float yEnd = min(rowBottom, edge.yBottom);
+        float xStart = edge.xTop + (yStart - edge.yTop) * inverseSlope;
+        float xEnd = edge.xTop + (yEnd - edge.yTop) * inverseSlope;
+        // Rounding may take the ends a little out of the polygon columns
+        float xLimit = (float) (this->row.size() - 2);
+        xStart = min(max(xStart, 0.0f), xLimit);
+        xEnd = min(max(xEnd, 0.0f), xLimit);
+        this->accumulateSegment(xStart, yStart, xEnd, yEnd, edge.direction);
+        i++;
+    }
+    
+    // Turn the contributions into the area covered in each pixel
+    float sum = 0.0f;
+    for (float& value : this->row) {
+        sum += value;
+        value = sum;
+    }
+    return this->row.data();
+}
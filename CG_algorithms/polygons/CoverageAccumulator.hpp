@@ -0,0 +1,53 @@
+/**
+ * CoverageAccumulator.hpp
+ * Class that computes, row by row, the exact fraction of each pixel covered
+ * by a polygon. It is used to fill anti-aliased polygons without supersampling
+ * (see Polygon::rasterizeAntialiasedPolygon).
+ *
+ * Every edge adds, to the pixels it crosses in a row, the signed area between
+ * itself and the right border of the pixel; the pixels to its right get the
+ * whole height of the edge in that row. Summing the row from left to right
+ * then gives the covered area of each pixel, whatever the number of edges in it.
+ * Pixel (x, y) is the unit square centered on the integer point (x, y), where
+ * the Scan Line algorithm samples it.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef CoverageAccumulator_hpp
+#define CoverageAccumulator_hpp
+
+#include <vector>
+#include "../common/VertexSpan.hpp"
+#include "../common/FrameArena.hpp"
+
+class CoverageAccumulator {
+public:
+    CoverageAccumulator(VertexSpan vertices, FrameArena *arena = NULL);
+    bool isEmpty() const;
+    int getFirstRow() const;
+    int getLastRow() const;
+    int getFirstColumn() const;
+    int getWidth() const;
+    const float* accumulateRow(int y);
+private:
+    // An edge going down, with the direction it had in the polygon
+    struct CoverageEdge {
+        float xTop, yTop, xBottom, yBottom;
+        float direction;
+    };
+    typedef std::vector<CoverageEdge, ArenaAllocator<CoverageEdge>> CoverageEdgeList;
+    
+    void accumulateSegment(float xStart, float yStart, float xEnd, float yEnd, float direction);
+    
+    CoverageEdgeList edges;
+    // Indexes in edges of the ones crossing the current row
+    std::vector<std::size_t, ArenaAllocator<std::size_t>> activeEdges;
+    std::size_t nextEdge;
+    std::vector<float, ArenaAllocator<float>> row;
+    int firstRow;
+    int lastRow;
+    int firstColumn;
+};
+
+#endif /* CoverageAccumulator_hpp */
@@ -10,6 +10,8 @@
 #include "../common/Vertex2d.hpp"
 #include "PolygonEdge.hpp"
 #include "Polygon.hpp"
+#include "../common/VertexSpan.hpp"
+#include "../common/Stats.hpp"
 #include <list>
 #include <math.h>
 #include "OpenGL/gl.h"
@@ -18,38 +20,62 @@ using namespace std;
 
 /**
  * Constructor for EdgesTable class.
- * Initializes the map of edges according to the list of vertices passed as parameter.
- * It assumes the list of coordinates is passed in the right order.
- * @param verticesList {list<Vertex2d>} - the list of polygon vertices to draw
+ * Initializes the map of edges according to the vertices passed as parameter.
+ * It assumes the vertices are passed in the right order.
+ * @param vertices {VertexSpan} - the polygon vertices to draw
+ * @param arena {FrameArena*} - where the edges are allocated, NULL for the heap
  * @return {void}
  */
-EdgesTable::EdgesTable(list<Vertex2d> verticesList) {
-    list<Vertex2d>::const_iterator it;
+EdgesTable::EdgesTable(VertexSpan vertices, FrameArena *arena):
+    edgesMap(std::less<int>(), ArenaAllocator<ETMap::value_type>(arena)) {
+    this->addEdges(vertices, arena);
+}
+
+/**
+ * Constructor for vertices of the other coordinate types (see Vertex2d.hpp)
+ * @param vertices {BasicVertexSpan<T>} - the polygon vertices to draw
+ * @param arena {FrameArena*} - where the edges are allocated, NULL for the heap
+ */
+template <typename T>
+EdgesTable::EdgesTable(BasicVertexSpan<T> vertices, FrameArena *arena):
+    edgesMap(std::less<int>(), ArenaAllocator<ETMap::value_type>(arena)) {
+    this->addEdges(vertices, arena);
+}
+
+/**
+ * Fill the map of edges from the vertices, closing the polygon
+ * @param vertices {BasicVertexSpan<T>}
+ * @param arena {FrameArena*}
+ */
+template <typename T>
+void EdgesTable::addEdges(BasicVertexSpan<T> vertices, FrameArena *arena) {
+    typedef typename CoordinateTraits<T>::Real Real;
+    const BasicVertex2d<T> *it;
     int maxY, xForMinY, minY;
     float slope, currentX;
-    list<PolygonEdge> listOfEdges;
+    EdgeList listOfEdges = EdgeList(ArenaAllocator<PolygonEdge>(arena));
     
     // TODO: find another way to initialize the map, cause this way just works for the cases
     // when the order of the coordinates is correct
-    for (it = verticesList.begin(); it != verticesList.end(); it++) {
-        list<Vertex2d>::const_iterator nextCoordinate;
+    for (it = vertices.begin(); it != vertices.end(); it++) {
+        const BasicVertex2d<T> *nextCoordinate = it + 1;
         
-        // On last element of the list, we create a edge with the first one,
+        // On last vertex, we create a edge with the first one,
         // closing the circle
-        if (next(it) == verticesList.end()) {
-            nextCoordinate = verticesList.begin();
-        } else {
-            nextCoordinate = next(it);
+        if (nextCoordinate == vertices.end()) {
+            nextCoordinate = vertices.begin();
         }
         
         // if there's no variation in the y axis, we do not include the edge in the table.
-        // The algorithm will take care of lines paralel to the x axis
-        if (nextCoordinate->getY() == it->getY()) {
+        // The algorithm will take care of lines paralel to the x axis.
+        // The scan lines are integers, so an edge that does not reach the next one
+        // counts as horizontal too; otherwise it would never leave the active edges
+        if ((int) nextCoordinate->getY() == (int) it->getY()) {
             continue;
         }
         
         // Calculate the inverse of the slope (1/m)
-        slope = (nextCoordinate->getX() - it->getX()) / (nextCoordinate->getY() - it->getY());
+        slope = (Real) (nextCoordinate->getX() - it->getX()) / (nextCoordinate->getY() - it->getY());
         
         // Set all needed options to create a edge
         if (nextCoordinate->getY() > it->getY()) {
@@ -66,18 +92,19 @@ EdgesTable::EdgesTable(list<Vertex2d> verticesList) {
         
         // Create the edge
         PolygonEdge newEdge(minY, currentX, xForMinY, maxY, slope);
+        CG_STATS_ADD(EDGES_INSERTED, 1);
         
         // Look for the key corresponding to the current y value
-        ETMap::const_iterator mapIt = edgesMap.find(minY);
+        ETMap::iterator mapIt = edgesMap.find(minY);
         
         // if the specified key has not been found, we create a new entry in the map,
         // otherwise, we just insert the new edge into the list referenced by the found key
         if (mapIt == edgesMap.end()) {
             listOfEdges.clear();
             listOfEdges.push_back(newEdge);
-            edgesMap.insert(pair<int, list<PolygonEdge>>(minY, listOfEdges));
+            edgesMap.insert(ETMap::value_type(minY, listOfEdges));
         } else {
-            edgesMap[minY].push_back(newEdge);
+            mapIt->second.push_back(newEdge);
         }
     }
     
@@ -91,3 +118,8 @@ EdgesTable::EdgesTable(list<Vertex2d> verticesList) {
 void EdgesTable::removeEntryFromMap(int keyToRemove) {
     this->edgesMap.erase(keyToRemove);
 }
+
+// The other coordinate types the tables are built for, see Vertex2d.hpp
+template EdgesTable::EdgesTable(BasicVertexSpan<int16_t>, FrameArena *);
+template EdgesTable::EdgesTable(BasicVertexSpan<int32_t>, FrameArena *);
+template EdgesTable::EdgesTable(BasicVertexSpan<double>, FrameArena *);
@@ -10,18 +10,24 @@
 #define EdgesTable_hpp
 
 #include "PolygonEdge.hpp"
-#include "Polygon.hpp"
 #include "../common/Vertex2d.hpp"
+#include "../common/VertexSpan.hpp"
+#include "../common/FrameArena.hpp"
 #include <map>
 #include <list>
 
-typedef std::map<int, std::list<PolygonEdge>> ETMap;
+// The edges live in a FrameArena when the table is given one, on the heap otherwise
+typedef std::list<PolygonEdge, ArenaAllocator<PolygonEdge>> EdgeList;
+typedef std::map<int, EdgeList, std::less<int>, ArenaAllocator<std::pair<const int, EdgeList>>> ETMap;
 
 class EdgesTable {
 public:
-    EdgesTable(std::list<Vertex2d>);
+    EdgesTable(VertexSpan, FrameArena *arena = NULL);
+    template <typename T> EdgesTable(BasicVertexSpan<T>, FrameArena *arena = NULL);
     void removeEntryFromMap(int);
     ETMap edgesMap;
+private:
+    template <typename T> void addEdges(BasicVertexSpan<T>, FrameArena *arena);
 };
 
 #endif /* EdgesTable_hpp */
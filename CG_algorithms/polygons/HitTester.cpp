@@ -0,0 +1,175 @@
+/**
+ * HitTester.cpp
+ * Finds the filled polygon under a point without rasterizing anything.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "HitTester.hpp"
+#include "EdgesTable.hpp"
+#include "../common/Trace.hpp"
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+/**
+ * Constructor of the class
+ * @param cellSize {int} - side of the cells of the grid of bounding boxes
+ */
+HitTester::HitTester(int cellSize):grid(cellSize) {}
+
+/**
+ * Add a polygon, or tell the tester it moved or changed. Its area is taken
+ * as if it was filled.
+ * @param figureId {int}
+ * @param polygon {Polygon}
+ */
+void HitTester::setPolygon(int figureId, const Polygon& polygon) {
+    HitShape& shape = this->shapes[figureId];
+    HitTester::buildShape(polygon.getVertices(), shape);
+    shape.box = polygon.getBoundingBox();
+    this->grid.update(figureId, shape.box);
+}
+
+/**
+ * Take a polygon out of the tester
+ * @param figureId {int}
+ */
+void HitTester::removePolygon(int figureId) {
+    this->shapes.erase(figureId);
+    this->grid.remove(figureId);
+}
+
+/**
+ * Number of polygons in the tester
+ * @return {size_t}
+ */
+size_t HitTester::size() const {
+    return this->shapes.size();
+}
+
+/**
+ * Whether a pixel is inside one of the polygons
+ * @param figureId {int}
+ * @param x {int}, y {int}
+ * @return {bool} - false for a polygon that is not in the tester
+ */
+bool HitTester::contains(int figureId, int x, int y) const {
+    auto it = this->shapes.find(figureId);
+    return it != this->shapes.end() && HitTester::shapeContains(it->second, x, y);
+}
+
+/**
+ * Find the polygon on top of a pixel
+ * @param x {int}, y {int}
+ * @return {int} - the id of the polygon, -1 when there is none
+ */
+int HitTester::hitTest(int x, int y) {
+    this->grid.query(BoundingBox(x, y, x, y), this->candidates);
+    // The polygons on top come first, so the first hit is the answer
+    sort(this->candidates.begin(), this->candidates.end(), greater<int>());
+    for (int figureId : this->candidates) {
+        if (HitTester::shapeContains(this->shapes.find(figureId)->second, x, y)) {
+            return figureId;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Find the polygon on top of many pixels at once
+ * @param points {VertexSpan} - the pixels, only their coordinates are used
+ * @param figureIds {vector<int>&} - replaced by the polygon of each pixel, -1 when there is none
+ */
+void HitTester::hitTest(VertexSpan points, vector<int>& figureIds) {
+    CG_TRACE_SPAN("hit-test");
+    figureIds.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        figureIds[i] = this->hitTest((int) points[i].getX(), (int) points[i].getY());
+    }
+}
+
+/**
+ * Turn the edges of a polygon into slabs of rows. The EdgesTable gives the
+ * edges by their lowest row, so a single walk over the slab boundaries adds
+ * the edges that start there and drops the ones that ended.
+ * @param vertices {VertexSpan}
+ * @param shape {HitShape&} - replaced by the slabs of the polygon
+ */
+void HitTester::buildShape(VertexSpan vertices, HitShape& shape) {
+    shape.slabRows.clear();
+    shape.slabOffsets.clear();
+    shape.edges.clear();
+    
+    EdgesTable edgesTable(vertices);
+    if (edgesTable.edgesMap.empty()) {
+        return;
+    }
+    
+    // A slab starts wherever an edge starts or ends
+    for (auto it = edgesTable.edgesMap.begin(); it != edgesTable.edgesMap.end(); it++) {
+        shape.slabRows.push_back(it->first);
+        for (const PolygonEdge& edge : it->second) {
+            shape.slabRows.push_back(edge.getMaxYCoordinate());
+        }
+    }
+    sort(shape.slabRows.begin(), shape.slabRows.end());
+    shape.slabRows.erase(unique(shape.slabRows.begin(), shape.slabRows.end()), shape.slabRows.end());
+    
+    // Like the active edges of the Scan Line algorithm, an edge crosses the
+    // rows from its lowest one up to the one before its highest
+    vector<const PolygonEdge*> activeEdges;
+    auto nextEntry = edgesTable.edgesMap.begin();
+    for (size_t slab = 0; slab + 1 < shape.slabRows.size(); slab++) {
+        int row = shape.slabRows[slab];
+        activeEdges.erase(remove_if(activeEdges.begin(), activeEdges.end(), [row](const PolygonEdge *edge) {
+            return edge->getMaxYCoordinate() <= row;
+        }), activeEdges.end());
+        if (nextEntry != edgesTable.edgesMap.end() && nextEntry->first == row) {
+            for (const PolygonEdge& edge : nextEntry->second) {
+                activeEdges.push_back(&edge);
+            }
+            nextEntry++;
+        }
+    
+        shape.slabOffsets.push_back(shape.edges.size());
+        for (const PolygonEdge *edge : activeEdges) {
+            HitEdge hitEdge;
+            hitEdge.x = edge->getCurrentX();
+            hitEdge.slope = edge->getSlope();
+            hitEdge.minY = edge->getMinYCoordinate();
+            shape.edges.push_back(hitEdge);
+        }
+    }
+    shape.slabOffsets.push_back(shape.edges.size());
+}
+
+/**
+ * Crossing number test of a pixel against the edges of its slab. The Scan
+ * Line fill draws from ceil(left) to floor(right) between each pair of
+ * edges, so a pixel is inside when an odd number of edges is on its left,
+ * or when an edge goes exactly through it.
+ * @param shape {HitShape}
+ * @param x {int}, y {int}
+ * @return {bool}
+ */
+bool HitTester::shapeContains(const HitShape& shape, int x, int y) {
+    if (!shape.box.contains(x, y) || shape.slabRows.empty() ||
+        y < shape.slabRows.front() || y >= shape.slabRows.back()) {
+        return false;
+    }
+    
+    size_t slab = upper_bound(shape.slabRows.begin(), shape.slabRows.end(), y) - shape.slabRows.begin() - 1;
+    int edgesBefore = 0, edgesThrough = 0;
+    for (size_t i = shape.slabOffsets[slab]; i < shape.slabOffsets[slab + 1]; i++) {
+        const HitEdge& edge = shape.edges[i];
+        float edgeX = edge.x + edge.slope * (y - edge.minY);
+        if (edgeX < x) {
+            edgesBefore++;
+        } else if (edgeX == x) {
+            edgesThrough++;
+        }
+    }
+    return (edgesBefore % 2) == 1 || edgesThrough > 0;
+}
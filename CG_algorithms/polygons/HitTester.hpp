@@ -0,0 +1,64 @@
+/**
+ * HitTester.hpp
+ * Finds the filled polygon under a point without rasterizing anything. The
+ * polygons are kept in a SpatialGrid by their bounding box, and each one is
+ * turned into slabs: the rows between two consecutive edge end points, each
+ * with the edges that cross it. The slabs are built by walking the EdgesTable
+ * of the polygon, whose edges are already sorted by their lowest row, so the
+ * slab of a row is found by a binary search and only its edges are tested
+ * with the crossing number rule, the same rule the Scan Line fill uses. The
+ * fill adds the slope of the edges row by row, so on the few pixels an edge
+ * goes exactly through its rounding may disagree with the tester. When
+ * polygons overlap, the one with the biggest id is on top, as in
+ * RetainedRenderer.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef HitTester_hpp
+#define HitTester_hpp
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "Polygon.hpp"
+#include "../common/BoundingBox.hpp"
+#include "../common/SpatialGrid.hpp"
+#include "../common/VertexSpan.hpp"
+
+class HitTester {
+public:
+    HitTester(int cellSize = 64);
+    void setPolygon(int figureId, const Polygon& polygon);
+    void removePolygon(int figureId);
+    std::size_t size() const;
+    bool contains(int figureId, int x, int y) const;
+    int hitTest(int x, int y);
+    void hitTest(VertexSpan points, std::vector<int>& figureIds);
+private:
+    struct HitEdge {
+        // Column of the edge on its lowest row, and how much it moves each row
+        float x;
+        float slope;
+        int minY;
+    };
+    
+    struct HitShape {
+        BoundingBox box;
+        // First row of each slab; the last entry only ends the last slab
+        std::vector<int> slabRows;
+        // The edges of slab i are edges[slabOffsets[i]] to edges[slabOffsets[i + 1]]
+        std::vector<std::size_t> slabOffsets;
+        std::vector<HitEdge> edges;
+    };
+    
+    static void buildShape(VertexSpan vertices, HitShape& shape);
+    static bool shapeContains(const HitShape& shape, int x, int y);
+    
+    SpatialGrid grid;
+    std::unordered_map<int, HitShape> shapes;
+    // Reused by the queries for the polygons found in the grid
+    std::vector<int> candidates;
+};
+
+#endif /* HitTester_hpp */
@@ -12,39 +12,33 @@
 #include "../lines/Line.hpp"
 #include "PolygonEdge.hpp"
 #include "EdgesTable.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/Trace.hpp"
 #include <list>
+#include <stdexcept>
 
 using namespace std;
 
-Polygon::Polygon():GeometricFigure() {}
+Polygon::Polygon():GeometricFigure(), filled(false), convex(true), fillEngine(SCAN_LINE_FILL) {}
 
 /**
- * Constructor of the class
- * @param listOfVertices {list<Vertex2d>}
+ * Constructor of the class. The vertices are copied into the polygon.
+ * @param vertices {VertexSpan}
  * @param filled {bool} - whether the polygon is filled or not, default value is false
  */
-Polygon::Polygon(list<Vertex2d> listOfVertices, bool filled):GeometricFigure() {
-    this->setVerticesList(listOfVertices);
+Polygon::Polygon(VertexSpan vertices, bool filled):GeometricFigure(), fillEngine(SCAN_LINE_FILL) {
+    this->setVertices(vertices);
     GeometricFigure::setType(POLYGON);
     this->setFilled(filled);
 }
 
 /**
- * Constructor of the class
- * @param listOfVertices {list<CodedVertex2d>}
+ * Constructor of the class, taking over the given vertices
+ * @param vertices {VertexBuffer&&}
  * @param filled {bool} - whether the polygon is filled or not, default value is false
  */
-Polygon::Polygon(list<CodedVertex2d> listOfVertices, bool filled):GeometricFigure() {
-    list<Vertex2d> newVertices;
-
-    // Convert the list of CodedVertex2d to a list of Vertex2d
-    for (auto it = listOfVertices.begin(); it != listOfVertices.end(); it++) {
-        Vertex2d newVertex(it->getX(), it->getY());
-        newVertex.setRGBColors(it->Vertex2d::getRed(), it->Vertex2d::getGreen(), it->Vertex2d::getBlue());
-        newVertices.push_back(newVertex);
-    }
-    
-    this->setVerticesList(newVertices);
+Polygon::Polygon(VertexBuffer&& vertices, bool filled):GeometricFigure(), fillEngine(SCAN_LINE_FILL) {
+    this->setVertices(std::move(vertices));
     GeometricFigure::setType(POLYGON);
     this->setFilled(filled);
 }
@@ -66,150 +60,218 @@ void Polygon::setFilled(bool filled) {
 }
 
 /**
- * Getter for the vertices
- * @return {list<Vertex2d>}
+ * Whether the polygon is convex, so that it is filled by the convex path
+ * @return {bool}
+ */
+bool Polygon::isConvex() const {
+    return this->convex;
+}
+
+/**
+ * Getter for the fill engine
+ * @return {PolygonFillEngine}
+ */
+PolygonFillEngine Polygon::getFillEngine() const {
+    return this->fillEngine;
+}
+
+/**
+ * Setter for the fill engine. With the triangle fill engine, the polygon is
+ * triangulated here, and again only when its vertices are replaced.
+ * @param fillEngine {PolygonFillEngine}
+ */
+void Polygon::setFillEngine(PolygonFillEngine fillEngine) {
+    this->fillEngine = fillEngine;
+    this->updateTriangles();
+}
+
+/**
+ * Getter for the triangles of the polygon, empty with the Scan Line fill engine
+ * @return {const TriangleList&}
+ */
+const TriangleList& Polygon::getTriangles() const {
+    return this->triangles;
+}
+
+/**
+ * Use the triangle fill engine with triangles found before, usually for the
+ * same vertices before a transformation, instead of triangulating again
+ * @param triangles {TriangleList} - indexes into the vertices of the polygon
  */
-list<Vertex2d> Polygon::getVerticesList() const {
+void Polygon::setTriangles(const TriangleList& triangles) {
+    for (unsigned int index : triangles) {
+        if (index >= this->vertices.size()) {
+            throw invalid_argument("The triangles refer to a vertice the polygon does not have");
+        }
+    }
+    this->fillEngine = TRIANGLE_FILL;
+    this->triangles = triangles;
+}
+
+/**
+ * Getter for the vertices, without copying them
+ * @return {VertexSpan}
+ */
+VertexSpan Polygon::getVertices() const {
     return this->vertices;
 }
 
 /**
  * Setter for the vertices
- * @param newListOfVertices {list<Vertex2d>}
+ * @param newVertices {VertexSpan}
+ */
+void Polygon::setVertices(VertexSpan newVertices) {
+    this->vertices.assign(newVertices.begin(), newVertices.end());
+    this->boundingBox = BoundingBox::ofPoints(this->vertices);
+    this->convex = Triangulation::isConvex(this->vertices);
+    this->updateTriangles();
+}
+
+/**
+ * Setter for the vertices, taking over the given buffer
+ * @param newVertices {VertexBuffer&&}
  */
-void Polygon::setVerticesList(list<Vertex2d> newListOfVertices) {
-    this->vertices = newListOfVertices;
+void Polygon::setVertices(VertexBuffer&& newVertices) {
+    this->vertices = std::move(newVertices);
+    this->boundingBox = BoundingBox::ofPoints(this->vertices);
+    this->convex = Triangulation::isConvex(this->vertices);
+    this->updateTriangles();
+}
+
+/**
+ * Triangulate the polygon when it uses the triangle fill engine
+ */
+void Polygon::updateTriangles() {
+    if (this->fillEngine == TRIANGLE_FILL) {
+        Triangulation::triangulate(this->vertices, this->triangles);
+    } else {
+        this->triangles.clear();
+    }
 }
 
 /**
  * TODO: change this method to another stage of pipeline (rendering)
- * Generates a polygon using the Scan Line algorithm
- * @param vertices {list<Vertex2d>}
+ * Generates a filled polygon, using the Scan Line algorithm by default
+ * @param vertices {VertexSpan}
+ * @param fillEngine {PolygonFillEngine}
  */
-Polygon Polygon::generateFilledPolygon(list<Vertex2d> vertices) {
-    EdgesTable edgesTable(vertices);
-    list<PolygonEdge> activeEdges;
+Polygon Polygon::generateFilledPolygon(VertexSpan vertices, PolygonFillEngine fillEngine) {
+    CG_TRACE_SPAN("raster", POLYGON, vertices.size());
     Polygon polygon(vertices, true);
-    
-    // Here, we get the colors from the first vertice in the list and set all the polygon points
-    // to that color
-    Vertex2d firstPoint = *vertices.begin();
-    Vertex2d pointToAdd;
-    pointToAdd.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
-
-    // Get the smaller y from the list of polygon vertices
-    int scanLineY = min_element(vertices.begin(), vertices.end())->getY();
-    
-    // Move the list of key scanLineY to active edges and remove it from the edges table
-    list<PolygonEdge> initialActiveEdges = edgesTable.edgesMap.at(scanLineY);
-    activeEdges.merge(initialActiveEdges);
-    edgesTable.removeEntryFromMap(scanLineY);
-    
-    // Make sure it is sorted already
-    activeEdges.sort();
-    
-    while (!activeEdges.empty() || !edgesTable.edgesMap.empty()) {
-        for (auto it = activeEdges.begin(); it != activeEdges.end(); it++) {
-            // Get the next edge
-            auto nextPolygon = next(it);
-            
-            // Get the extremes x coordinates
-            int leftXValue = ceilf(it->getCurrentX());
-            int rightXValue = floorf(nextPolygon->getCurrentX());
-            
-            // Add all the points between the two extremes to the polygon
-            for (; leftXValue <= rightXValue; leftXValue++) {
-                pointToAdd.setX(leftXValue);
-                pointToAdd.setY(scanLineY);
-                polygon.addPoint(pointToAdd);
-            }
-            
-            // Make sure it goes on groups of two
-            it++;
-        }
-        
-        // Increment the scan line y coordinate
-        scanLineY++;
-        
-        // Remove the edges from the list that had been reached its maximmum y
-        activeEdges.remove_if([scanLineY](const PolygonEdge edge){
-            return edge.getMaxYCoordinate() == scanLineY;
-        });
-        
-        // Update the currentX values of the polygons in the active edges list
-        for (auto it = activeEdges.begin(); it != activeEdges.end(); it++) {
-            it->updateCurrentX();
-        }
-        
-        // Make sure the list is sorted after the updates
-        activeEdges.sort();
-        
-        // Look for an entry for the current y value
-        auto foundIt = edgesTable.edgesMap.find(scanLineY);
-        
-        // If we find, we move the found list from the edges table to the active edges list
-        if (foundIt != edgesTable.edgesMap.end()) {
-            activeEdges.merge(foundIt->second);
-            activeEdges.sort();
-            edgesTable.removeEntryFromMap(scanLineY);
-        }
-    }
-    
+    polygon.setFillEngine(fillEngine);
+    VectorPixelSink sink(polygon.points);
+    polygon.rasterize(sink);
+    return polygon;
+}
+
+/**
+ * Generates a filled polygon, using the Scan Line algorithm by default,
+ * taking over the given vertices
+ * @param vertices {VertexBuffer&&}
+ * @param fillEngine {PolygonFillEngine}
+ */
+Polygon Polygon::generateFilledPolygon(VertexBuffer&& vertices, PolygonFillEngine fillEngine) {
+    CG_TRACE_SPAN("raster", POLYGON, vertices.size());
+    Polygon polygon(std::move(vertices), true);
+    polygon.setFillEngine(fillEngine);
+    VectorPixelSink sink(polygon.points);
+    polygon.rasterize(sink);
+    return polygon;
+}
+
+/**
+ * Generates a filled polygon with the triangle fill engine, taking over the
+ * given vertices and reusing triangles found before for them (see setTriangles)
+ * @param vertices {VertexBuffer&&}
+ * @param triangles {TriangleList}
+ */
+Polygon Polygon::generateFilledPolygon(VertexBuffer&& vertices, const TriangleList& triangles) {
+    CG_TRACE_SPAN("raster", POLYGON, vertices.size());
+    Polygon polygon(std::move(vertices), true);
+    polygon.setTriangles(triangles);
+    VectorPixelSink sink(polygon.points);
+    polygon.rasterize(sink);
     return polygon;
 }
 
 /**
  * TODO: change this method to another stage of pipeline (rendering)
  * Generates a empty polygon
- * @param vertices {list<Vertex2d>}
+ * @param vertices {VertexSpan}
  */
-Polygon Polygon::generateNotFilledPolygon(list<Vertex2d> vertices) {
+Polygon Polygon::generateNotFilledPolygon(VertexSpan vertices) {
+    CG_TRACE_SPAN("raster", POLYGON, vertices.size());
     Polygon polygon(vertices, false);
-    
-    Vertex2d initialVertice = *(vertices.begin());
-    Vertex2d pointToAdd;
-    pointToAdd.setRGBColors(initialVertice.getRed(), initialVertice.getGreen(), initialVertice.getBlue());
-    
-    std::list<Vertex2d>::const_iterator it;
-    
-    for (it = vertices.begin(); it != vertices.end(); it++) {
-        auto nextVertice = next(it);
-        if (nextVertice == vertices.end()) {nextVertice = vertices.begin();}
-        Line tempLine = Line::generateLineDDA(*it, *nextVertice);
-        std::vector<Vertex2d>::const_iterator lineIt;
-        std::vector<Vertex2d> tempLineArray = tempLine.GeometricFigure::getPoints();
-        for (lineIt = tempLineArray.begin(); lineIt != tempLineArray.end(); lineIt++) {
-            auto tempVertex2d = lineIt;
-            polygon.addPoint(*tempVertex2d);
-        }
-    }
-    
+    VectorPixelSink sink(polygon.points);
+    polygon.rasterize(sink);
+    return polygon;
+}
+
+/**
+ * Generates a empty polygon, taking over the given vertices
+ * @param vertices {VertexBuffer&&}
+ */
+Polygon Polygon::generateNotFilledPolygon(VertexBuffer&& vertices) {
+    CG_TRACE_SPAN("raster", POLYGON, vertices.size());
+    Polygon polygon(std::move(vertices), false);
+    VectorPixelSink sink(polygon.points);
+    polygon.rasterize(sink);
     return polygon;
 }
 
-void Polygon::applyTransformationMatrix(Matrix2d transformationMatrix) {
-    list<Vertex2d> newVerticeList;
-    Vertex2d newVertice;
+/**
+ * Lazy range over the pixels of a filled polygon, using the Scan Line algorithm.
+ * The spans are only computed while the range is walked.
+ * @param vertices {VertexSpan}
+ * @return {PixelRange<ScanLinePixelGenerator>}
+ */
+PixelRange<ScanLinePixelGenerator> Polygon::iterateFilledPolygon(VertexSpan vertices) {
+    return PixelRange<ScanLinePixelGenerator>(vertices);
+}
+
+void Polygon::applyTransformationMatrix(Matrix2d& transformationMatrix) {
+    CG_TRACE_SPAN("transform", POLYGON, this->vertices.size());
+    // Transform the vertices in place, with the kernel of the kind of the matrix
+    transformationMatrix.transformVertices(this->vertices.data(), this->vertices.size());
+    this->boundingBox = BoundingBox::ofPoints(this->vertices);
     
-    // Generate the new vertices list
-    for (Vertex2d vertice : this->getVerticesList()) {
-        newVertice = transformationMatrix * vertice;
-        newVertice.setRGBColors(vertice.getRed(), vertice.getGreen(), vertice.getBlue());
-        newVerticeList.push_back(newVertice);
+    // Only a projective matrix can make a convex polygon concave
+    if (transformationMatrix.getKind() == MATRIX_PROJECTIVE) {
+        this->convex = Triangulation::isConvex(this->vertices);
     }
     
-    // Create a new polygon with the new vertices
-    // TODO change this rendering method
-    Polygon newPolygon;
-    if (this->isFilled()) {
-        newPolygon = Polygon::generateFilledPolygon(newVerticeList);
-    } else {
-        newPolygon = Polygon::generateNotFilledPolygon(newVerticeList);
-    }
+    // Rasterize the polygon again in place
+    this->points.clear();
+    VectorPixelSink sink(this->points);
+    this->rasterize(sink);
+}
+
+/**
+ * Move a chain of a convex polygon to its next edge that crosses a scan line,
+ * set up as the Scan Line algorithm sets up its edges (see EdgesTable)
+ * @param vertices {VertexSpan}
+ * @param chain {ConvexChain&}
+ * @return {bool} - false when the chain is past the highest vertex
+ */
+bool Polygon::advanceConvexChain(VertexSpan vertices, ConvexChain& chain) {
+    while (chain.edgesLeft > 0) {
+        const Vertex2d& lower = vertices[chain.vertex];
+        chain.vertex = (chain.vertex + chain.step) % vertices.size();
+        chain.edgesLeft--;
+        const Vertex2d& upper = vertices[chain.vertex];
     
-    // Set the new properties
-    this->setVerticesList(newVerticeList);
-    GeometricFigure::setPoints(newPolygon.GeometricFigure::getPoints());
+        // Going down, the chain went over the top of the polygon
+        if ((int) upper.getY() < (int) lower.getY()) {
+            return false;
+        }
+        if ((int) upper.getY() > (int) lower.getY()) {
+            chain.maxY = upper.getY();
+            chain.currentX = (int) lower.getX();
+            chain.slope = (upper.getX() - lower.getX()) / (upper.getY() - lower.getY());
+            return true;
+        }
+    }
+    return false;
 }
 
 void Polygon::translate(float dx, float dy) {
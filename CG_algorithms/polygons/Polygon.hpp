@@ -9,29 +9,333 @@
 #define Polygon_hpp
 
 #include <list>
+#include <algorithm>
+#include <cmath>
 #include "../2D_transformations/Matrix2d.hpp"
 #include "../common/Vertex2d.hpp"
-#include "../common/CodedVertex2d.hpp"
+#include "../common/VertexSpan.hpp"
 #include "../common/GeometricFigure.hpp"
+#include "../lines/Line.hpp"
+#include "EdgesTable.hpp"
+#include "PolygonEdge.hpp"
+#include "ScanLinePixelGenerator.hpp"
+#include "CoverageAccumulator.hpp"
+#include "Triangulation.hpp"
+#include "TriangleRasterizer.hpp"
+#include "../common/PixelRange.hpp"
+#include "../common/Stats.hpp"
+
+// How a filled polygon is rasterized: by the Scan Line algorithm, or split
+// once into triangles that are filled with edge functions (see
+// TriangleRasterizer.hpp)
+enum PolygonFillEngine {SCAN_LINE_FILL, TRIANGLE_FILL};
 
 class Polygon : public GeometricFigure {
 public:
     Polygon();
-    Polygon(std::list<Vertex2d>, bool filled = false);
-    Polygon(std::list<CodedVertex2d>, bool filled = false);
+    Polygon(VertexSpan, bool filled = false);
+    Polygon(VertexBuffer&&, bool filled = false);
     bool isFilled() const;
     void setFilled(bool filled);
-    std::list<Vertex2d> getVerticesList() const;
-    void setVerticesList(std::list<Vertex2d>);
-    static Polygon generateFilledPolygon(std::list<Vertex2d>);
-    static Polygon generateNotFilledPolygon(std::list<Vertex2d>);
+    bool isConvex() const;
+    PolygonFillEngine getFillEngine() const;
+    void setFillEngine(PolygonFillEngine fillEngine);
+    const TriangleList& getTriangles() const;
+    void setTriangles(const TriangleList& triangles);
+    VertexSpan getVertices() const;
+    void setVertices(VertexSpan);
+    void setVertices(VertexBuffer&&);
+    static Polygon generateFilledPolygon(VertexSpan, PolygonFillEngine fillEngine = SCAN_LINE_FILL);
+    static Polygon generateFilledPolygon(VertexBuffer&&, PolygonFillEngine fillEngine = SCAN_LINE_FILL);
+    static Polygon generateFilledPolygon(VertexBuffer&&, const TriangleList& triangles);
+    static Polygon generateNotFilledPolygon(VertexSpan);
+    static Polygon generateNotFilledPolygon(VertexBuffer&&);
+    template <typename Sink> static void rasterizeFilledPolygon(VertexSpan, Sink&);
+    template <typename Sink, typename T> static void rasterizeFilledPolygon(BasicVertexSpan<T>, Sink&);
+    template <typename Sink> static void rasterizeConvexPolygon(VertexSpan, Sink&);
+    template <typename Sink> static void rasterizeNotFilledPolygon(VertexSpan, Sink&);
+    template <typename Sink, typename T> static void rasterizeNotFilledPolygon(BasicVertexSpan<T>, Sink&);
+    template <typename Sink> static void rasterizeAntialiasedPolygon(VertexSpan, Sink&);
+    template <typename Sink> void rasterize(Sink&) const;
+    static PixelRange<ScanLinePixelGenerator> iterateFilledPolygon(VertexSpan);
     void translate(float, float);
     void scale(float, float, float, float);
     void rotate(float, float, float);
 private:
+    // One side of a convex polygon, walked up from its lowest vertex: the
+    // edge it is on, stepped like a PolygonEdge of the Scan Line algorithm
+    struct ConvexChain {
+        std::size_t vertex;
+        std::size_t step;
+        std::size_t edgesLeft;
+        int maxY;
+        float currentX;
+        float slope;
+    };
+    
     bool filled;
-    void applyTransformationMatrix(Matrix2d transformationMatrix);
-    std::list<Vertex2d> vertices;
+    // Whether the vertices make a convex polygon, found when they are set.
+    // The affine transformations keep it
+    bool convex;
+    void applyTransformationMatrix(Matrix2d& transformationMatrix);
+    void updateTriangles();
+    static bool advanceConvexChain(VertexSpan vertices, ConvexChain& chain);
+    VertexBuffer vertices;
+    PolygonFillEngine fillEngine;
+    // Only kept with the triangle fill engine. The transformations keep it,
+    // since they do not change which vertices make each triangle
+    TriangleList triangles;
 };
 
+/**
+ * Rasterize a filled polygon into a sink, using the Scan Line algorithm
+ * @param vertices {VertexSpan}
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Polygon::rasterizeFilledPolygon(VertexSpan vertices, Sink& sink) {
+    Polygon::rasterizeFilledPolygon<Sink, float>(vertices, sink);
+}
+
+/**
+ * Rasterize a filled polygon of any coordinate type (see Vertex2d.hpp) into a
+ * sink, using the Scan Line algorithm
+ * @param vertices {BasicVertexSpan<T>}
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Polygon::rasterizeFilledPolygon(BasicVertexSpan<T> vertices, Sink& sink) {
+    // The edges only live while the polygon is rasterized, so they go in the
+    // current frame arena, if there is one
+    FrameArena *arena = FrameArena::getCurrent();
+    EdgesTable edgesTable(vertices, arena);
+    EdgeList activeEdges = EdgeList(ArenaAllocator<PolygonEdge>(arena));
+    
+    // Here, we get the colors from the first vertice in the list and set all the polygon points
+    // to that color
+    const BasicVertex2d<T>& firstPoint = vertices.front();
+    Vertex2d color;
+    color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    
+    // Nothing to fill when every edge is horizontal
+    if (edgesTable.edgesMap.empty()) {
+        return;
+    }
+    
+    // Start on the lowest scan line with edges. It is usually the one of the
+    // lowest vertice, unless all the edges there were skipped as horizontal
+    int scanLineY = edgesTable.edgesMap.begin()->first;
+    
+    // Move the list of key scanLineY to active edges and remove it from the edges table
+    EdgeList initialActiveEdges = edgesTable.edgesMap.at(scanLineY);
+    activeEdges.merge(initialActiveEdges);
+    edgesTable.removeEntryFromMap(scanLineY);
+    
+    // Make sure it is sorted already
+    activeEdges.sort();
+    
+    while (!activeEdges.empty() || !edgesTable.edgesMap.empty()) {
+        for (auto it = activeEdges.begin(); it != activeEdges.end(); it++) {
+            // Get the next edge
+            auto nextPolygon = next(it);
+            
+            // Get the extremes x coordinates
+            int leftXValue = ceilf(it->getCurrentX());
+            int rightXValue = floorf(nextPolygon->getCurrentX());
+            
+            // Send all the points between the two extremes as a single span
+            if (leftXValue <= rightXValue) {
+                CG_STATS_ADD(SPANS, 1);
+                CG_STATS_ADD(PIXELS_SCAN_LINE, rightXValue - leftXValue + 1);
+                sink.span(leftXValue, rightXValue, scanLineY, color);
+            }
+            
+            // Make sure it goes on groups of two
+            it++;
+        }
+        
+        // Increment the scan line y coordinate
+        CG_STATS_ADD(SCANLINES, 1);
+        scanLineY++;
+        
+        // Remove the edges from the list that had been reached its maximmum y
+        activeEdges.remove_if([scanLineY](const PolygonEdge& edge){
+            return edge.getMaxYCoordinate() == scanLineY;
+        });
+        
+        // Update the currentX values of the polygons in the active edges list
+        for (auto it = activeEdges.begin(); it != activeEdges.end(); it++) {
+            it->updateCurrentX();
+        }
+        
+        // Make sure the list is sorted after the updates
+        activeEdges.sort();
+        
+        // Look for an entry for the current y value
+        auto foundIt = edgesTable.edgesMap.find(scanLineY);
+        
+        // If we find, we move the found list from the edges table to the active edges list
+        if (foundIt != edgesTable.edgesMap.end()) {
+            activeEdges.merge(foundIt->second);
+            activeEdges.sort();
+            edgesTable.removeEntryFromMap(scanLineY);
+        }
+    }
+}
+
+/**
+ * Rasterize a filled convex polygon into a sink. Every row of a convex
+ * polygon crosses it once, so instead of an edges table and a sorted list of
+ * active edges, only the two chains of edges from the lowest vertex up to
+ * the highest one are walked, and each row is a single span. The edges are
+ * stepped as in the Scan Line algorithm, so the pixels are the same.
+ * @param vertices {VertexSpan} - they must make a convex polygon (see Triangulation::isConvex)
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Polygon::rasterizeConvexPolygon(VertexSpan vertices, Sink& sink) {
+    if (vertices.empty()) {
+        return;
+    }
+    
+    const Vertex2d& firstPoint = vertices.front();
+    Vertex2d color;
+    color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    
+    std::size_t count = vertices.size(), lowest = 0;
+    for (std::size_t i = 1; i < count; i++) {
+        if ((int) vertices[i].getY() < (int) vertices[lowest].getY()) {
+            lowest = i;
+        }
+    }
+    
+    // One chain goes forward through the vertices and the other backwards.
+    // Nothing to fill when every edge is horizontal
+    ConvexChain chains[2] = {{lowest, 1, count, 0, 0, 0}, {lowest, count - 1, count, 0, 0, 0}};
+    if (!Polygon::advanceConvexChain(vertices, chains[0]) || !Polygon::advanceConvexChain(vertices, chains[1])) {
+        return;
+    }
+    
+    int scanLineY = (int) vertices[lowest].getY();
+    while (true) {
+        int leftXValue = ceilf(std::min(chains[0].currentX, chains[1].currentX));
+        int rightXValue = floorf(std::max(chains[0].currentX, chains[1].currentX));
+        if (leftXValue <= rightXValue) {
+            CG_STATS_ADD(SPANS, 1);
+            CG_STATS_ADD(PIXELS_SCAN_LINE, rightXValue - leftXValue + 1);
+            sink.span(leftXValue, rightXValue, scanLineY, color);
+        }
+        CG_STATS_ADD(SCANLINES, 1);
+        scanLineY++;
+    
+        // A chain that reached the end of its edge goes on to the next one,
+        // until both reach the highest vertex
+        for (ConvexChain& chain : chains) {
+            if (chain.maxY != scanLineY) {
+                chain.currentX += chain.slope;
+            } else if (!Polygon::advanceConvexChain(vertices, chain)) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Rasterize an anti-aliased filled polygon into a sink, from the exact area
+ * of each pixel covered by the polygon (see CoverageAccumulator.hpp). The
+ * pixels entirely inside go as spans, like in the Scan Line algorithm, and
+ * only the ones on the border are blended. The sink must take coverage
+ * (see PixelSink.hpp).
+ * @param vertices {VertexSpan}
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Polygon::rasterizeAntialiasedPolygon(VertexSpan vertices, Sink& sink) {
+    // Coverages that do not change a byte of the color are rounded
+    const float minimumCoverage = 0.5f / 255.0f;
+    const float maximumCoverage = 1.0f - minimumCoverage;
+    
+    CoverageAccumulator accumulator(vertices, FrameArena::getCurrent());
+    if (accumulator.isEmpty()) {
+        return;
+    }
+    
+    const Vertex2d& firstPoint = vertices.front();
+    Vertex2d color;
+    color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    int firstColumn = accumulator.getFirstColumn();
+    int width = accumulator.getWidth();
+    
+    for (int y = accumulator.getFirstRow(); y <= accumulator.getLastRow(); y++) {
+        const float *coverages = accumulator.accumulateRow(y);
+        CG_STATS_ADD(SCANLINES, 1);
+        
+        for (int column = 0; column < width;) {
+            float coverage = std::min(fabsf(coverages[column]), 1.0f);
+            
+            if (coverage >= maximumCoverage) {
+                // Send the whole run of covered pixels as a single span
+                int runEnd = column;
+                while (runEnd + 1 < width && fabsf(coverages[runEnd + 1]) >= maximumCoverage) {
+                    runEnd++;
+                }
+                CG_STATS_ADD(SPANS, 1);
+                CG_STATS_ADD(PIXELS_SCAN_LINE, runEnd - column + 1);
+                sink.span(firstColumn + column, firstColumn + runEnd, y, color);
+                column = runEnd + 1;
+                continue;
+            }
+            
+            if (coverage >= minimumCoverage) {
+                CG_STATS_ADD(PIXELS_COVERAGE, 1);
+                sink.plotCoverage(firstColumn + column, y, color, coverage);
+            }
+            column++;
+        }
+    }
+}
+
+/**
+ * Rasterize the outline of a polygon into a sink, drawing every edge with DDA.
+ * Each edge takes the color of its initial vertice.
+ * @param vertices {VertexSpan}
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Polygon::rasterizeNotFilledPolygon(VertexSpan vertices, Sink& sink) {
+    Polygon::rasterizeNotFilledPolygon<Sink, float>(vertices, sink);
+}
+
+/**
+ * Rasterize the outline of a polygon of any coordinate type (see Vertex2d.hpp)
+ * into a sink
+ * @param vertices {BasicVertexSpan<T>}
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink, typename T>
+void Polygon::rasterizeNotFilledPolygon(BasicVertexSpan<T> vertices, Sink& sink) {
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        std::size_t nextVertice = (i + 1 == vertices.size()) ? 0 : i + 1;
+        Line::rasterizeLineDDA(vertices[i], vertices[nextVertice], sink);
+    }
+}
+
+/**
+ * Rasterize this polygon into a sink, filled or not, with its fill engine.
+ * The Scan Line fill engine takes the convex path for convex polygons.
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void Polygon::rasterize(Sink& sink) const {
+    if (this->isFilled() && this->fillEngine == TRIANGLE_FILL) {
+        TriangleRasterizer::rasterizeTriangles(this->vertices, this->triangles, sink);
+    } else if (this->isFilled() && this->convex) {
+        Polygon::rasterizeConvexPolygon(this->vertices, sink);
+    } else if (this->isFilled()) {
+        Polygon::rasterizeFilledPolygon(this->vertices, sink);
+    } else {
+        Polygon::rasterizeNotFilledPolygon(this->vertices, sink);
+    }
+}
+
 #endif /* Polygon_hpp */
@@ -0,0 +1,127 @@
+/**
+ * ScanLinePixelGenerator.cpp
+ * Pixel generator for filled polygons, to be used with PixelRange. It runs
+ * the Scan Line algorithm one span at a time and produces the same pixels as
+ * Polygon::rasterizeFilledPolygon.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "ScanLinePixelGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Constructor of the class. Builds the edges table and moves the edges
+ * of the lowest scan line to the active edges list.
+ * @param vertices {VertexSpan}
+ */
+ScanLinePixelGenerator::ScanLinePixelGenerator(VertexSpan vertices):edgesTable(vertices) {
+    const Vertex2d& firstPoint = vertices.front();
+    this->color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    
+    // Start on the lowest scan line with edges (see Polygon::rasterizeFilledPolygon)
+    this->scanLineY = 0;
+    if (!this->edgesTable.edgesMap.empty()) {
+        this->scanLineY = this->edgesTable.edgesMap.begin()->first;
+        
+        // Move the list of key scanLineY to active edges and remove it from the edges table
+        EdgeList initialActiveEdges = this->edgesTable.edgesMap.at(this->scanLineY);
+        this->activeEdges.merge(initialActiveEdges);
+        this->edgesTable.removeEntryFromMap(this->scanLineY);
+        this->activeEdges.sort();
+    }
+    
+    this->currentPair = this->activeEdges.begin();
+    
+    // No span is open yet
+    this->currentX = 1;
+    this->spanEndX = 0;
+}
+
+/**
+ * Copy constructor. The position in the active edges list must point
+ * into the copied list, not into the original one.
+ * @param other {ScanLinePixelGenerator}
+ */
+ScanLinePixelGenerator::ScanLinePixelGenerator(const ScanLinePixelGenerator& other):
+    edgesTable(other.edgesTable), activeEdges(other.activeEdges),
+    scanLineY(other.scanLineY), currentX(other.currentX), spanEndX(other.spanEndX), color(other.color) {
+    
+    EdgeList::const_iterator otherIt = other.activeEdges.begin();
+    EdgeList::const_iterator otherPair = other.currentPair;
+    this->currentPair = this->activeEdges.begin();
+    while (otherIt != otherPair) {
+        otherIt++;
+        this->currentPair++;
+    }
+}
+
+/**
+ * Open the next non empty span, moving to the next scan lines if needed
+ * @return {bool} - false when there are no spans left
+ */
+bool ScanLinePixelGenerator::openNextSpan() {
+    while (true) {
+        while (this->currentPair != this->activeEdges.end()) {
+            EdgeList::iterator nextEdge = std::next(this->currentPair);
+            if (nextEdge == this->activeEdges.end()) {
+                break;
+            }
+            
+            // Get the extremes x coordinates
+            int leftXValue = ceilf(this->currentPair->getCurrentX());
+            int rightXValue = floorf(nextEdge->getCurrentX());
+            
+            // Make sure it goes on groups of two
+            this->currentPair = std::next(nextEdge);
+            
+            if (leftXValue <= rightXValue) {
+                this->currentX = leftXValue;
+                this->spanEndX = rightXValue;
+                return true;
+            }
+        }
+        
+        this->nextScanLine();
+        
+        if (this->activeEdges.empty() && this->edgesTable.edgesMap.empty()) {
+            return false;
+        }
+        
+        this->currentPair = this->activeEdges.begin();
+    }
+}
+
+/**
+ * Move to the next scan line, updating the active edges list
+ */
+void ScanLinePixelGenerator::nextScanLine() {
+    int newScanLineY = ++this->scanLineY;
+    
+    // Remove the edges from the list that had been reached its maximmum y
+    this->activeEdges.remove_if([newScanLineY](const PolygonEdge& edge){
+        return edge.getMaxYCoordinate() == newScanLineY;
+    });
+    
+    // Update the currentX values of the polygons in the active edges list
+    for (auto it = this->activeEdges.begin(); it != this->activeEdges.end(); it++) {
+        it->updateCurrentX();
+    }
+    
+    // Make sure the list is sorted after the updates. Edges only swap places
+    // where they cross, so most scan lines have nothing to sort
+    if (!is_sorted(this->activeEdges.begin(), this->activeEdges.end())) {
+        this->activeEdges.sort();
+    }
+    
+    // If there are new edges starting on this scan line, we move them to the active edges list
+    auto foundIt = this->edgesTable.edgesMap.find(newScanLineY);
+    if (foundIt != this->edgesTable.edgesMap.end()) {
+        this->activeEdges.merge(foundIt->second);
+        this->activeEdges.sort();
+        this->edgesTable.removeEntryFromMap(newScanLineY);
+    }
+}
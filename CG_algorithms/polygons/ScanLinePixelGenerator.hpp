@@ -0,0 +1,75 @@
+/**
+ * ScanLinePixelGenerator.hpp
+ * Pixel generator for filled polygons, to be used with PixelRange. It runs
+ * the Scan Line algorithm one span at a time and produces the same pixels as
+ * Polygon::rasterizeFilledPolygon. The edges table is built once, on
+ * construction; walking the pixels does not allocate. nextSpan gives the
+ * same pixels a whole span at a time, from the bottom scan line up, for the
+ * callers that stop between scan lines (see StreamingRenderer).
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef ScanLinePixelGenerator_hpp
+#define ScanLinePixelGenerator_hpp
+
+#include <list>
+#include "EdgesTable.hpp"
+#include "PolygonEdge.hpp"
+#include "../common/Vertex2d.hpp"
+#include "../common/VertexSpan.hpp"
+
+class ScanLinePixelGenerator {
+public:
+    ScanLinePixelGenerator(VertexSpan);
+    ScanLinePixelGenerator(const ScanLinePixelGenerator&);
+    bool next(Vertex2d&);
+    bool nextSpan(int& xStart, int& xEnd, int& y);
+private:
+    bool openNextSpan();
+    void nextScanLine();
+    
+    EdgesTable edgesTable;
+    EdgeList activeEdges;
+    EdgeList::iterator currentPair;
+    int scanLineY;
+    int currentX;
+    int spanEndX;
+    Vertex2d color;
+};
+
+/**
+ * Write the next pixel of the polygon
+ * @param pixel {Vertex2d&}
+ * @return {bool} - false when the polygon is over
+ */
+inline bool ScanLinePixelGenerator::next(Vertex2d& pixel) {
+    if (this->currentX > this->spanEndX && !this->openNextSpan()) {
+        return false;
+    }
+    
+    pixel = this->color;
+    pixel.setX(this->currentX++);
+    pixel.setY(this->scanLineY);
+    return true;
+}
+
+/**
+ * Write the pixels of the polygon not generated yet in the current span,
+ * or in the next span when the current one is over
+ * @param xStart {int&}, xEnd {int&}, y {int&} - the span, both ends included
+ * @return {bool} - false when the polygon is over
+ */
+inline bool ScanLinePixelGenerator::nextSpan(int& xStart, int& xEnd, int& y) {
+    if (this->currentX > this->spanEndX && !this->openNextSpan()) {
+        return false;
+    }
+    
+    xStart = this->currentX;
+    xEnd = this->spanEndX;
+    y = this->scanLineY;
+    this->currentX = this->spanEndX + 1;
+    return true;
+}
+
+#endif /* ScanLinePixelGenerator_hpp */
@@ -0,0 +1,359 @@
+/**
+ * TriangleRasterizer.hpp
+ * Fills triangles with half-space edge functions, the other fill engine of
+ * Polygon (see Triangulation.hpp). Each edge of a triangle is a linear
+ * function of the pixel, positive on the inside, so a pixel is in the
+ * triangle when the three functions are. The vertices are snapped to 1/16
+ * of a pixel and the functions are computed in integers, so a pixel on an
+ * edge shared by two triangles goes to exactly one of them.
+ *
+ * The bounding box of the triangle is walked in 8x8 blocks. The corners of
+ * a block give the range of each edge function over it, so blocks entirely
+ * outside an edge are skipped and blocks entirely inside all three are sent
+ * as spans without testing their pixels. Only the blocks an edge crosses
+ * are tested pixel by pixel, a row of 8 at a time, with SSE2 when the
+ * compiler targets it.
+ *
+ * Pixels are sampled on their integer coordinates, as in the Scan Line
+ * algorithm. A pixel exactly on an edge belongs to the triangle when the
+ * edge is a left edge or a horizontal bottom edge, the rule that matches
+ * the rows the Scan Line algorithm fills. Unlike it, the pixels exactly on a
+ * right edge are left out.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef TriangleRasterizer_hpp
+#define TriangleRasterizer_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "Triangulation.hpp"
+#include "../common/Vertex2d.hpp"
+#include "../common/VertexSpan.hpp"
+#include "../common/Stats.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+class TriangleRasterizer {
+public:
+    template <typename Sink> static void rasterizeTriangles(VertexSpan vertices, const TriangleList& triangles, Sink& sink);
+    template <typename Sink> static void rasterizeTriangle(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c,
+                                                           const Vertex2d& color, Sink& sink, int orientation = 0);
+private:
+    enum {
+        SUBPIXEL_STEPS = 16,
+        BLOCK_SIZE = 8
+    };
+    
+    struct EdgeFunction {
+        // Value on the first pixel of the current block, and how much it
+        // changes from a pixel to the next one in x and in y
+        long long value;
+        long long xStep;
+        long long yStep;
+        // A pixel is inside the edge when the value is above the threshold:
+        // -1 for the edges that keep the pixels on them, 0 for the others
+        long long threshold;
+    };
+    
+    // The spans found on each row of a row of blocks, merged across blocks
+    struct SpanRow {
+        int xStart;
+        int xEnd;
+    };
+    
+    static void setupEdge(long long xFrom, long long yFrom, long long xTo, long long yTo,
+                          long long xPixel, long long yPixel, EdgeFunction& edge);
+    static void clampColumns(const long long *x, const long long *y, long long yFrom, long long yTo,
+                             int& firstColumn, int& lastColumn);
+    static unsigned int getRowMask(long long rowValue, long long xStep, long long threshold, int width, bool fitsInt);
+    template <typename Sink> static void addSpan(SpanRow *spanRows, int row, int xStart, int xEnd,
+                                                 int y, const Vertex2d& color, Sink& sink);
+    template <typename Sink> static void flushSpans(SpanRow *spanRows, int rows, int y, const Vertex2d& color, Sink& sink);
+};
+
+/**
+ * Rasterize a triangulated polygon into a sink. Every triangle takes the
+ * color of the first vertex, like the Scan Line algorithm does. The
+ * triangles of a triangulation all turn to the same side; a sliver that
+ * snapping to 1/16 of a pixel turned to the other side would cover pixels of
+ * its neighbours, so it is left out.
+ * @param vertices {VertexSpan}
+ * @param triangles {TriangleList} - see Triangulation
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ */
+template <typename Sink>
+void TriangleRasterizer::rasterizeTriangles(VertexSpan vertices, const TriangleList& triangles, Sink& sink) {
+    if (vertices.empty()) {
+        return;
+    }
+    
+    const Vertex2d& firstPoint = vertices.front();
+    Vertex2d color;
+    color.setRGBColors(firstPoint.getRed(), firstPoint.getGreen(), firstPoint.getBlue());
+    
+    double area = 0;
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        const Vertex2d& a = vertices[triangles[i]];
+        const Vertex2d& b = vertices[triangles[i + 1]];
+        const Vertex2d& c = vertices[triangles[i + 2]];
+        area += ((double) b.getX() - a.getX()) * ((double) c.getY() - a.getY()) -
+                ((double) b.getY() - a.getY()) * ((double) c.getX() - a.getX());
+    }
+    int orientation = (area < 0) ? -1 : 1;
+    
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        TriangleRasterizer::rasterizeTriangle(vertices[triangles[i]], vertices[triangles[i + 1]],
+                                              vertices[triangles[i + 2]], color, sink, orientation);
+    }
+}
+
+/**
+ * Rasterize a triangle into a sink, with edge functions over 8x8 blocks
+ * @param a {Vertex2d}, b {Vertex2d}, c {Vertex2d} - the corners, in any order
+ * @param color {Vertex2d} - only its colors are used
+ * @param sink {Sink&} - where the pixels go (see PixelSink.hpp)
+ * @param orientation {int} - 1 or -1 to leave the triangle out when, once
+ * snapped, it is not counterclockwise or clockwise; 0 to take it either way
+ */
+template <typename Sink>
+void TriangleRasterizer::rasterizeTriangle(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c,
+                                           const Vertex2d& color, Sink& sink, int orientation) {
+    const Vertex2d *corners[3] = {&a, &b, &c};
+    long long x[3], y[3];
+    for (int i = 0; i < 3; i++) {
+        x[i] = std::llround(corners[i]->getX() * SUBPIXEL_STEPS);
+        y[i] = std::llround(corners[i]->getY() * SUBPIXEL_STEPS);
+    }
+    
+    // The edge functions are positive inside counterclockwise triangles
+    long long area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0 || (orientation != 0 && (area > 0) != (orientation > 0))) {
+        return;
+    }
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+    }
+    
+    // The pixels whose integer coordinates are inside the bounding box; the
+    // shifts round towards minus infinity, also for negative coordinates
+    long long xMinimum = std::min(x[0], std::min(x[1], x[2])), xMaximum = std::max(x[0], std::max(x[1], x[2]));
+    long long yMinimum = std::min(y[0], std::min(y[1], y[2])), yMaximum = std::max(y[0], std::max(y[1], y[2]));
+    int firstColumn = (int) -((-xMinimum) >> 4), lastColumn = (int) (xMaximum >> 4);
+    int firstRow = (int) -((-yMinimum) >> 4), lastRow = (int) (yMaximum >> 4);
+    if (firstColumn > lastColumn || firstRow > lastRow) {
+        return;
+    }
+    
+    EdgeFunction edges[3];
+    bool fitsInt = true;
+    for (int i = 0; i < 3; i++) {
+        int next = (i + 1) % 3;
+        TriangleRasterizer::setupEdge(x[i], y[i], x[next], y[next], (long long) firstColumn * SUBPIXEL_STEPS,
+                                      (long long) firstRow * SUBPIXEL_STEPS, edges[i]);
+        // Inside a block an edge crosses, its values stay within the range it
+        // covers over the block; the SIMD test needs that range in 32 bits
+        fitsInt = fitsInt && (std::llabs(edges[i].xStep) + std::llabs(edges[i].yStep)) * BLOCK_SIZE < (1LL << 29);
+    }
+    
+    SpanRow spanRows[BLOCK_SIZE];
+    for (int blockY = firstRow; blockY <= lastRow; blockY += BLOCK_SIZE) {
+        int height = std::min((int) BLOCK_SIZE, lastRow - blockY + 1);
+        for (int row = 0; row < height; row++) {
+            spanRows[row].xStart = 1;
+            spanRows[row].xEnd = 0;
+        }
+        
+        // Thin triangles cover a small part of their bounding box, so only
+        // the columns the triangle reaches in this row of blocks are walked
+        int bandFirstColumn = firstColumn, bandLastColumn = lastColumn;
+        TriangleRasterizer::clampColumns(x, y, (long long) blockY * SUBPIXEL_STEPS,
+                                         (long long) (blockY + height - 1) * SUBPIXEL_STEPS, bandFirstColumn, bandLastColumn);
+    
+        for (int blockX = bandFirstColumn; blockX <= bandLastColumn; blockX += BLOCK_SIZE) {
+            int width = std::min((int) BLOCK_SIZE, bandLastColumn - blockX + 1);
+            bool outside = false;
+            int crossing[3], crossingCount = 0;
+    
+            for (int i = 0; i < 3 && !outside; i++) {
+                const EdgeFunction& edge = edges[i];
+                long long value = edge.value + (blockX - firstColumn) * edge.xStep;
+                long long lowest = value + std::min(0LL, edge.xStep * (width - 1)) + std::min(0LL, edge.yStep * (height - 1));
+                long long highest = value + std::max(0LL, edge.xStep * (width - 1)) + std::max(0LL, edge.yStep * (height - 1));
+                if (highest <= edge.threshold) {
+                    outside = true;
+                } else if (lowest <= edge.threshold) {
+                    crossing[crossingCount++] = i;
+                }
+            }
+            if (outside) {
+                continue;
+            }
+    
+            for (int row = 0; row < height; row++) {
+                unsigned int mask = (1u << width) - 1;
+                for (int k = 0; k < crossingCount; k++) {
+                    const EdgeFunction& edge = edges[crossing[k]];
+                    long long value = edge.value + (blockX - firstColumn) * edge.xStep + row * edge.yStep;
+                    mask &= TriangleRasterizer::getRowMask(value, edge.xStep, edge.threshold, width, fitsInt);
+                }
+    
+                // The pixels of a row of a triangle are consecutive
+                if (mask != 0) {
+                    int first = 0, last = width - 1;
+                    while (!(mask & (1u << first))) {
+                        first++;
+                    }
+                    while (!(mask & (1u << last))) {
+                        last--;
+                    }
+                    TriangleRasterizer::addSpan(spanRows, row, blockX + first, blockX + last, blockY, color, sink);
+                }
+            }
+        }
+    
+        TriangleRasterizer::flushSpans(spanRows, height, blockY, color, sink);
+        for (int i = 0; i < 3; i++) {
+            edges[i].value += edges[i].yStep * BLOCK_SIZE;
+        }
+    }
+}
+
+/**
+ * Prepare the edge function of the edge from one corner to the next one
+ * @param xFrom {long long}, yFrom {long long} - the first corner, in 1/16 of a pixel
+ * @param xTo {long long}, yTo {long long} - the second corner, in 1/16 of a pixel
+ * @param xPixel {long long}, yPixel {long long} - the first pixel, in 1/16 of a pixel
+ * @param edge {EdgeFunction&}
+ */
+inline void TriangleRasterizer::setupEdge(long long xFrom, long long yFrom, long long xTo, long long yTo,
+                                          long long xPixel, long long yPixel, EdgeFunction& edge) {
+    long long xVariation = xTo - xFrom;
+    long long yVariation = yTo - yFrom;
+    edge.value = xVariation * (yPixel - yFrom) - yVariation * (xPixel - xFrom);
+    edge.xStep = -yVariation * SUBPIXEL_STEPS;
+    edge.yStep = xVariation * SUBPIXEL_STEPS;
+    
+    // In a counterclockwise triangle the left edges go down, and the bottom
+    // edge goes right
+    bool keepsPixelsOnIt = yVariation < 0 || (yVariation == 0 && xVariation > 0);
+    edge.threshold = keepsPixelsOnIt ? -1 : 0;
+}
+
+/**
+ * Narrow a range of columns to the ones a triangle can reach between two
+ * rows: its corners between them, and where its edges cross them
+ * @param x {long long*}, y {long long*} - the corners, in 1/16 of a pixel
+ * @param yFrom {long long}, yTo {long long} - the rows, in 1/16 of a pixel
+ * @param firstColumn {int&}, lastColumn {int&} - the range to narrow
+ */
+inline void TriangleRasterizer::clampColumns(const long long *x, const long long *y, long long yFrom, long long yTo,
+                                             int& firstColumn, int& lastColumn) {
+    double xLowest = INFINITY, xHighest = -INFINITY;
+    for (int i = 0; i < 3; i++) {
+        int next = (i + 1) % 3;
+        if (y[i] >= yFrom && y[i] <= yTo) {
+            xLowest = std::min(xLowest, (double) x[i]);
+            xHighest = std::max(xHighest, (double) x[i]);
+        }
+        for (long long yLine : {yFrom, yTo}) {
+            if ((y[i] < yLine) != (y[next] < yLine)) {
+                double xCross = x[i] + (double) (x[next] - x[i]) * (yLine - y[i]) / (y[next] - y[i]);
+                xLowest = std::min(xLowest, xCross);
+                xHighest = std::max(xHighest, xCross);
+            }
+        }
+    }
+    
+    // One more column on each side, against the rounding of the crossings;
+    // the edge functions still decide every pixel
+    if (xLowest <= xHighest) {
+        firstColumn = std::max(firstColumn, (int) std::floor(xLowest / SUBPIXEL_STEPS) - 1);
+        lastColumn = std::min(lastColumn, (int) std::ceil(xHighest / SUBPIXEL_STEPS) + 1);
+    }
+}
+
+/**
+ * Which pixels of a row of a block are inside an edge
+ * @param rowValue {long long} - the value of the edge function on the first pixel
+ * @param xStep {long long}, threshold {long long} - see EdgeFunction
+ * @param width {int} - the number of pixels of the row, up to 8
+ * @param fitsInt {bool} - whether the values of the block fit in 32 bits
+ * @return {unsigned int} - bit i is set when pixel i is inside
+ */
+inline unsigned int TriangleRasterizer::getRowMask(long long rowValue, long long xStep, long long threshold,
+                                                   int width, bool fitsInt) {
+    unsigned int widthMask = (1u << width) - 1;
+#if defined(__SSE2__)
+    if (fitsInt) {
+        __m128i low = _mm_add_epi32(_mm_set1_epi32((int) rowValue),
+                                    _mm_set_epi32((int) (3 * xStep), (int) (2 * xStep), (int) xStep, 0));
+        __m128i high = _mm_add_epi32(low, _mm_set1_epi32((int) (4 * xStep)));
+        __m128i limit = _mm_set1_epi32((int) threshold);
+        int lowMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(low, limit)));
+        int highMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(high, limit)));
+        return (unsigned int) (lowMask | (highMask << 4)) & widthMask;
+    }
+#else
+    (void) fitsInt;
+#endif
+    unsigned int mask = 0;
+    for (int i = 0; i < width; i++) {
+        mask |= (unsigned int) (rowValue + i * xStep > threshold) << i;
+    }
+    return mask & widthMask;
+}
+
+/**
+ * Add a span to a row of the current row of blocks, joining it to the span
+ * of the block on its left when they touch
+ * @param spanRows {SpanRow*}
+ * @param row {int} - the row inside the row of blocks
+ * @param xStart {int}, xEnd {int} - the span
+ * @param y {int} - the first row of the row of blocks
+ * @param color {Vertex2d}
+ * @param sink {Sink&}
+ */
+template <typename Sink>
+void TriangleRasterizer::addSpan(SpanRow *spanRows, int row, int xStart, int xEnd,
+                                 int y, const Vertex2d& color, Sink& sink) {
+    SpanRow& spanRow = spanRows[row];
+    if (spanRow.xStart <= spanRow.xEnd && spanRow.xEnd + 1 == xStart) {
+        spanRow.xEnd = xEnd;
+        return;
+    }
+    if (spanRow.xStart <= spanRow.xEnd) {
+        CG_STATS_ADD(SPANS, 1);
+        CG_STATS_ADD(PIXELS_TRIANGLES, spanRow.xEnd - spanRow.xStart + 1);
+        sink.span(spanRow.xStart, spanRow.xEnd, y + row, color);
+    }
+    spanRow.xStart = xStart;
+    spanRow.xEnd = xEnd;
+}
+
+/**
+ * Send the spans left in the rows of a row of blocks to the sink
+ * @param spanRows {SpanRow*}
+ * @param rows {int}
+ * @param y {int} - the first row of the row of blocks
+ * @param color {Vertex2d}
+ * @param sink {Sink&}
+ */
+template <typename Sink>
+void TriangleRasterizer::flushSpans(SpanRow *spanRows, int rows, int y, const Vertex2d& color, Sink& sink) {
+    for (int row = 0; row < rows; row++) {
+        const SpanRow& spanRow = spanRows[row];
+        if (spanRow.xStart <= spanRow.xEnd) {
+            CG_STATS_ADD(SPANS, 1);
+            CG_STATS_ADD(PIXELS_TRIANGLES, spanRow.xEnd - spanRow.xStart + 1);
+            sink.span(spanRow.xStart, spanRow.xEnd, y + row, color);
+        }
+    }
+}
+
+#endif /* TriangleRasterizer_hpp */
@@ -0,0 +1,269 @@
+/**
+ * Triangulation.cpp
+ * Splits a simple polygon into triangles, by ear clipping.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Triangulation.hpp"
+#include "../common/Trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Split a polygon into triangles
+ * @param vertices {VertexSpan} - the vertices of the polygon, in order
+ * @param triangles {TriangleList&} - replaced by the triangles
+ */
+void Triangulation::triangulate(VertexSpan vertices, TriangleList& triangles) {
+    CG_TRACE_SPAN("triangulate", POLYGON, vertices.size());
+    triangles.clear();
+    unsigned int count = (unsigned int) vertices.size();
+    if (count < 3) {
+        return;
+    }
+    triangles.reserve(3 * (count - 2));
+    
+    if (Triangulation::isConvex(vertices)) {
+        for (unsigned int i = 1; i + 1 < count; i++) {
+            triangles.push_back(0);
+            triangles.push_back(i);
+            triangles.push_back(i + 1);
+        }
+        return;
+    }
+    
+    // Twice the signed area: positive when the vertices go counterclockwise
+    double orientation = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        const Vertex2d& current = vertices[i];
+        const Vertex2d& next = vertices[(i + 1) % count];
+        orientation += (double) current.getX() * next.getY() - (double) next.getX() * current.getY();
+    }
+    orientation = (orientation < 0) ? -1 : 1;
+    
+    // The polygon left to clip, as a circular list
+    vector<unsigned int> previous(count), next(count);
+    vector<bool> reflex(count);
+    for (unsigned int i = 0; i < count; i++) {
+        previous[i] = (i + count - 1) % count;
+        next[i] = (i + 1) % count;
+    }
+    
+    // The reflex vertices are kept in a grid over the polygon, so that an ear
+    // is only tested against the ones near it
+    BoundingBox bounds = BoundingBox::ofPoints(vertices);
+    ReflexGrid grid(bounds, (int) sqrt((double) count) + 1);
+    for (unsigned int i = 0; i < count; i++) {
+        reflex[i] = Triangulation::cross(vertices[previous[i]], vertices[i], vertices[next[i]]) * orientation <= 0;
+        if (reflex[i]) {
+            grid.add(i, vertices[i]);
+        }
+    }
+    
+    unsigned int current = 0, remaining = count, visitedWithoutEar = 0;
+    vector<unsigned int> nearby;
+    while (remaining > 3) {
+        unsigned int before = previous[current], after = next[current];
+        // A vertex on a straight line, or on the tip of a spike with no width,
+        // is cut as a triangle with no area, which changes nothing
+        double turn = Triangulation::cross(vertices[before], vertices[current], vertices[after]) * orientation;
+        bool ear = turn >= 0;
+        if (turn > 0) {
+            grid.find(vertices[before], vertices[current], vertices[after], nearby);
+            for (size_t k = 0; ear && k < nearby.size(); k++) {
+                unsigned int other = nearby[k];
+                ear = other == before || other == after ||
+                      !Triangulation::isInsideTriangle(vertices[other], vertices[before], vertices[current],
+                                                       vertices[after], orientation);
+            }
+        }
+    
+        // A polygon that is not simple may have no ear left; cutting a vertex
+        // anyway still ends the loop
+        if (!ear && visitedWithoutEar < remaining) {
+            visitedWithoutEar++;
+            current = after;
+            continue;
+        }
+    
+        triangles.push_back(before);
+        triangles.push_back(current);
+        triangles.push_back(after);
+        next[before] = after;
+        previous[after] = before;
+        if (reflex[current]) {
+            grid.remove(current, vertices[current]);
+            reflex[current] = false;
+        }
+        remaining--;
+        visitedWithoutEar = 0;
+    
+        // Only the neighbours of the ear changed their angle
+        for (unsigned int neighbour : {before, after}) {
+            bool wasReflex = reflex[neighbour];
+            reflex[neighbour] = Triangulation::cross(vertices[previous[neighbour]], vertices[neighbour],
+                                                     vertices[next[neighbour]]) * orientation <= 0;
+            if (reflex[neighbour] && !wasReflex) {
+                grid.add(neighbour, vertices[neighbour]);
+            } else if (!reflex[neighbour] && wasReflex) {
+                grid.remove(neighbour, vertices[neighbour]);
+            }
+        }
+    
+        // Going on past the neighbours, instead of back to them, cuts ears all
+        // around the polygon on each lap, so the triangles stay small instead
+        // of growing as a fan around one vertex
+        current = next[after];
+    }
+    
+    triangles.push_back(previous[current]);
+    triangles.push_back(current);
+    triangles.push_back(next[current]);
+}
+
+/**
+ * Constructor of the grid
+ * @param bounds {BoundingBox} - the bounding box of the polygon
+ * @param side {int} - the number of cells on each side of the grid
+ */
+Triangulation::ReflexGrid::ReflexGrid(const BoundingBox& bounds, int side):
+    xMin(bounds.getXMin()), yMin(bounds.getYMin()), side(side), count(0), cells(side * side) {
+    this->cellWidth = max(1.0f, (bounds.getXMax() - bounds.getXMin() + 1.0f) / side);
+    this->cellHeight = max(1.0f, (bounds.getYMax() - bounds.getYMin() + 1.0f) / side);
+}
+
+/**
+ * Add a reflex vertex to the grid
+ * @param index {unsigned int} - the index of the vertex in the polygon
+ * @param vertex {Vertex2d}
+ */
+void Triangulation::ReflexGrid::add(unsigned int index, const Vertex2d& vertex) {
+    this->cells[this->getRow(vertex.getY()) * this->side + this->getColumn(vertex.getX())].push_back(index);
+    this->count++;
+}
+
+/**
+ * Remove a vertex that is no longer reflex from the grid
+ * @param index {unsigned int} - the index of the vertex in the polygon
+ * @param vertex {Vertex2d}
+ */
+void Triangulation::ReflexGrid::remove(unsigned int index, const Vertex2d& vertex) {
+    vector<unsigned int>& cell = this->cells[this->getRow(vertex.getY()) * this->side + this->getColumn(vertex.getX())];
+    cell.erase(std::remove(cell.begin(), cell.end(), index), cell.end());
+    this->count--;
+}
+
+/**
+ * Find the vertices in the cells the bounding box of a triangle overlaps
+ * @param a {Vertex2d}, b {Vertex2d}, c {Vertex2d} - the triangle
+ * @param indexes {vector<unsigned int>&} - replaced by the indexes of the vertices
+ */
+void Triangulation::ReflexGrid::find(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c,
+                                     vector<unsigned int>& indexes) const {
+    indexes.clear();
+    if (this->count == 0) {
+        return;
+    }
+    int firstColumn = this->getColumn(min(a.getX(), min(b.getX(), c.getX())));
+    int lastColumn = this->getColumn(max(a.getX(), max(b.getX(), c.getX())));
+    int firstRow = this->getRow(min(a.getY(), min(b.getY(), c.getY())));
+    int lastRow = this->getRow(max(a.getY(), max(b.getY(), c.getY())));
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const vector<unsigned int>& cell = this->cells[row * this->side + column];
+            indexes.insert(indexes.end(), cell.begin(), cell.end());
+        }
+    }
+}
+
+/**
+ * Column of the grid of an x coordinate, clamped to the grid
+ * @param x {float}
+ * @return {int}
+ */
+int Triangulation::ReflexGrid::getColumn(float x) const {
+    return min(this->side - 1, max(0, (int) floorf((x - this->xMin) / this->cellWidth)));
+}
+
+/**
+ * Row of the grid of a y coordinate, clamped to the grid
+ * @param y {float}
+ * @return {int}
+ */
+int Triangulation::ReflexGrid::getRow(float y) const {
+    return min(this->side - 1, max(0, (int) floorf((y - this->yMin) / this->cellHeight)));
+}
+
+/**
+ * Whether a polygon is convex: it always turns to the same side, and goes
+ * around only once, so each axis changes direction at most twice
+ * @param vertices {VertexSpan}
+ * @return {bool}
+ */
+bool Triangulation::isConvex(VertexSpan vertices) {
+    size_t count = vertices.size();
+    int turn = 0, xChanges = 0, yChanges = 0;
+    float lastXDirection = 0, lastYDirection = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        const Vertex2d& current = vertices[i];
+        const Vertex2d& following = vertices[(i + 1) % count];
+        const Vertex2d& afterFollowing = vertices[(i + 2) % count];
+    
+        double crossProduct = Triangulation::cross(current, following, afterFollowing);
+        int side = (crossProduct > 0) - (crossProduct < 0);
+        if (side != 0) {
+            if (turn != 0 && side != turn) {
+                return false;
+            }
+            turn = side;
+        }
+    
+        float xDirection = following.getX() - current.getX();
+        float yDirection = following.getY() - current.getY();
+        if (xDirection != 0) {
+            xChanges += (lastXDirection != 0 && (xDirection > 0) != (lastXDirection > 0));
+            lastXDirection = xDirection;
+        }
+        if (yDirection != 0) {
+            yChanges += (lastYDirection != 0 && (yDirection > 0) != (lastYDirection > 0));
+            lastYDirection = yDirection;
+        }
+    }
+    
+    return xChanges <= 2 && yChanges <= 2;
+}
+
+/**
+ * Cross product of the vectors from b to a and from b to c, positive when
+ * a, b and c turn counterclockwise
+ * @param a {Vertex2d}, b {Vertex2d}, c {Vertex2d}
+ * @return {double}
+ */
+double Triangulation::cross(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c) {
+    return ((double) b.getX() - a.getX()) * ((double) c.getY() - b.getY()) -
+           ((double) b.getY() - a.getY()) * ((double) c.getX() - b.getX());
+}
+
+/**
+ * Whether a point is inside a triangle or on its border. A point on one of
+ * the corners is not, so repeated vertices do not block an ear.
+ * @param point {Vertex2d}
+ * @param a {Vertex2d}, b {Vertex2d}, c {Vertex2d} - the triangle
+ * @param orientation {double} - 1 when the triangle is counterclockwise, -1 otherwise
+ * @return {bool}
+ */
+bool Triangulation::isInsideTriangle(const Vertex2d& point, const Vertex2d& a, const Vertex2d& b, const Vertex2d& c,
+                                     double orientation) {
+    for (const Vertex2d *corner : {&a, &b, &c}) {
+        if (point.getX() == corner->getX() && point.getY() == corner->getY()) {
+            return false;
+        }
+    }
+    return Triangulation::cross(a, b, point) * orientation >= 0 &&
+           Triangulation::cross(b, c, point) * orientation >= 0 &&
+           Triangulation::cross(c, a, point) * orientation >= 0;
+}
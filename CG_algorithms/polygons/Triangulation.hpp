@@ -0,0 +1,57 @@
+/**
+ * Triangulation.hpp
+ * Splits a simple polygon into triangles, by ear clipping. An ear is a
+ * convex vertex whose triangle, with its two neighbours, holds no other
+ * vertex; cutting it leaves a simple polygon with one vertex less. Only the
+ * reflex vertices can be inside an ear, so only they are tested, and only
+ * the ones in the cells of a grid the ear overlaps. Convex
+ * polygons are recognized first and split as a fan, in linear time.
+ *
+ * The triangles are indexes into the vertices, so a triangulation stays
+ * valid when the vertices go through any non degenerate affine
+ * transformation, and is only computed again when the vertices change.
+ * Self intersecting polygons get triangles too, but they do not match the
+ * even-odd fill of the Scan Line algorithm.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Triangulation_hpp
+#define Triangulation_hpp
+
+#include <vector>
+#include "../common/VertexSpan.hpp"
+#include "../common/BoundingBox.hpp"
+
+// Three indexes into the vertices of the polygon per triangle
+typedef std::vector<unsigned int> TriangleList;
+
+class Triangulation {
+public:
+    static void triangulate(VertexSpan vertices, TriangleList& triangles);
+    static bool isConvex(VertexSpan vertices);
+private:
+    // Uniform grid over the reflex vertices of the polygon being clipped
+    class ReflexGrid {
+    public:
+        ReflexGrid(const BoundingBox& bounds, int side);
+        void add(unsigned int index, const Vertex2d& vertex);
+        void remove(unsigned int index, const Vertex2d& vertex);
+        void find(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c, std::vector<unsigned int>& indexes) const;
+    private:
+        int getColumn(float x) const;
+        int getRow(float y) const;
+        
+        float xMin, yMin;
+        float cellWidth, cellHeight;
+        int side;
+        unsigned int count;
+        std::vector<std::vector<unsigned int>> cells;
+    };
+    
+    static double cross(const Vertex2d& a, const Vertex2d& b, const Vertex2d& c);
+    static bool isInsideTriangle(const Vertex2d& point, const Vertex2d& a, const Vertex2d& b, const Vertex2d& c,
+                                 double orientation);
+};
+
+#endif /* Triangulation_hpp */
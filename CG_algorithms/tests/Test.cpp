@@ -0,0 +1,80 @@
+/**
+ * Test.cpp
+ * Headless test runner.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include "Test.hpp"
+#include "TestCases.hpp"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * Add a test to the suite
+ * @param name {string}
+ * @param test {function<void()>} - throws a TestFailure when a check fails
+ */
+void TestSuite::add(const string& name, const function<void()>& test) {
+    this->tests.push_back(make_pair(name, test));
+}
+
+/**
+ * Only run the tests whose name contains the filter
+ * @param filter {string}
+ */
+void TestSuite::setFilter(const string& filter) {
+    this->filter = filter;
+}
+
+/**
+ * Run the tests, printing whether each one passed
+ * @param out {ostream&}
+ * @return {int} - the number of tests that failed
+ */
+int TestSuite::runAll(ostream& out) const {
+    int failures = 0, count = 0;
+    for (const pair<string, function<void()>>& test : this->tests) {
+        if (test.first.find(this->filter) == string::npos) {
+            continue;
+        }
+        count++;
+        
+        try {
+            test.second();
+            out << "ok      " << test.first << endl;
+        } catch (const exception& error) {
+            // Any exception fails the test, not only the checks
+            out << "FAILED  " << test.first << ": " << error.what() << endl;
+            failures++;
+        }
+    }
+    out << count - failures << " of " << count << " tests passed" << endl;
+    return failures;
+}
+
+/**
+ * Entry point of the tests, started with --test [--filter name]
+ * @param argc {int}
+ * @param argv {char**}
+ * @return {int} - the exit code of the program
+ */
+int runTests(int argc, char **argv) {
+    TestSuite suite;
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--test") {
+            continue;
+        }
+        if (option == "--filter" && i + 1 < argc) {
+            suite.setFilter(argv[++i]);
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 2;
+        }
+    }
+    
+    registerTestCases(suite);
+    return suite.runAll(cout) == 0 ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+/**
+ * Test.hpp
+ * Headless test runner. Each test is a function that checks the results of
+ * the algorithms with CG_CHECK; the first check that fails ends the test.
+ * The runner prints one line per test, and fails when any test did.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef Test_hpp
+#define Test_hpp
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+
+// Thrown by a check that fails
+class TestFailure : public std::runtime_error {
+public:
+    TestFailure(const std::string& message):std::runtime_error(message) {}
+};
+
+#define CG_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            throw TestFailure(std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": " #condition); \
+        } \
+    } while (0)
+
+class TestSuite {
+public:
+    void add(const std::string& name, const std::function<void()>& test);
+    void setFilter(const std::string& filter);
+    int runAll(std::ostream& out) const;
+private:
+    std::vector<std::pair<std::string, std::function<void()>>> tests;
+    std::string filter;
+};
+
+int runTests(int argc, char **argv);
+
+#endif /* Test_hpp */
@@ -0,0 +1,249 @@
+/**
+ * TestCases.cpp
+ * The tests run by the test suite, grouped by the part of the project they
+ * check. Each test names the behavior it pins down.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "TestCases.hpp"
+#include "../polygons/Polygon.hpp"
+#include "../lines/Circumference.hpp"
+#include "../common/PixelSink.hpp"
+#include "../common/CommandBuffer.hpp"
+#include "../common/Framebuffer.hpp"
+#include "../common/SceneFile.hpp"
+#include "../common/BinaryScene.hpp"
+#include "../common/ImageWriter.hpp"
+#include "../common/Pipeline.hpp"
+#include "../batch/BatchRenderer.hpp"
+
+using namespace std;
+
+static void registerScanLineTests(TestSuite& suite) {
+    // An edge whose ends truncate to the same scan line never crosses one, so
+    // it is skipped like a horizontal edge instead of staying active forever
+    suite.add("scan-line/edge-within-one-row", []() {
+        VertexBuffer vertices;
+        vertices.push_back(Vertex2d(0, 0.2f));
+        vertices.push_back(Vertex2d(10, 0.7f));
+        vertices.push_back(Vertex2d(10, 10));
+        vertices.push_back(Vertex2d(0, 10));
+        
+        vector<PixelSpan> spans;
+        SpanListPixelSink sink(spans);
+        Polygon::rasterizeFilledPolygon(vertices, sink);
+        
+        CG_CHECK(spans.size() == 10);
+        for (size_t i = 0; i < spans.size(); i++) {
+            CG_CHECK(spans[i].y == (int) i);
+            CG_CHECK(spans[i].xStart == 0);
+            CG_CHECK(spans[i].xEnd == 10);
+        }
+    });
+}
+
+static void registerCircumferenceTests(TestSuite& suite) {
+    // The pixels take the color of the center, like lines take the color of
+    // their initial point
+    suite.add("circumference/pixel-color", []() {
+        Vertex2d center(50, 50);
+        center.setRGBColors(0, 0, 1);
+        
+        vector<Vertex2d> points;
+        VectorPixelSink sink(points);
+        Circumference::rasterizeCircumferenceBresenham(center, 10, sink);
+        
+        CG_CHECK(!points.empty());
+        CG_CHECK(points[0].getX() == 50 && points[0].getY() == 60);
+        CG_CHECK(points[0].getRed() == 0);
+        CG_CHECK(points[0].getGreen() == 0);
+        CG_CHECK(points[0].getBlue() == 1);
+        
+        // The pixel generator must produce the same pixels, colors included
+        size_t i = 0;
+        for (const Vertex2d& pixel : Circumference::iterateCircumferenceBresenham(center, 10)) {
+            CG_CHECK(i < points.size());
+            CG_CHECK(pixel.getX() == points[i].getX() && pixel.getY() == points[i].getY());
+            CG_CHECK(pixel.getRed() == 0 && pixel.getGreen() == 0 && pixel.getBlue() == 1);
+            i++;
+        }
+        CG_CHECK(i == points.size());
+    });
+}
+
+static void registerCommandBufferTests(TestSuite& suite) {
+    // The frame of recordTransformationScene (main.cpp), executed from a
+    // command buffer, must look like the same figures drawn one by one
+    suite.add("command-buffer/matches-immediate-mode", []() {
+        const float angles[] = {0.0f, 30.0f, 135.0f};
+        const float variations[] = {0.0f, 120.0f, 333.0f};
+        const float scales[] = {1.0f, 1.5f, 0.75f};
+        
+        for (int frame = 0; frame < 3; frame++) {
+            float angle = angles[frame];
+            float variationX = variations[frame];
+            float scaleVariation = scales[frame];
+            
+            Vertex2d green(-100.0f, 200.0f);
+            green.setRGBColors(0.4, 0.7, 0.2);
+            Vertex2d greenSquare[] = {green, Vertex2d(-100.0f, 100.0f), Vertex2d(0.0f, 100.0f), Vertex2d(0.0f, 200.0f)};
+            Vertex2d yellow(-50.0f, 250.0f);
+            yellow.setRGBColors(0.9, 0.7, 0.2);
+            Vertex2d yellowSquare[] = {yellow, Vertex2d(-50.0f, 150.0f), Vertex2d(50.0f, 150.0f), Vertex2d(50.0f, 250.0f)};
+            Vertex2d center(0.0f, 350.0f);
+            center.setRGBColors(0.2, 0.5, 0.9);
+            
+            CommandBuffer commandBuffer;
+            commandBuffer.recordClear(0.0f, 0.0f, 0.0f);
+            commandBuffer.recordRotate(angle, -50.0, 150.0);
+            commandBuffer.recordTranslate(variationX, 0.0);
+            commandBuffer.recordPolygon(greenSquare, true);
+            commandBuffer.recordRotate(angle, 0, 225.0);
+            commandBuffer.recordTranslate(variationX, 0.0);
+            commandBuffer.recordScale(scaleVariation, scaleVariation, 50, 150);
+            commandBuffer.recordPolygon(yellowSquare, true);
+            commandBuffer.recordTranslate(variationX, 0.0);
+            commandBuffer.recordCircumference(center, 40 * scaleVariation);
+            
+            Framebuffer recorded(640, 480);
+            commandBuffer.execute(recorded);
+            
+            Framebuffer immediate(640, 480);
+            immediate.clear(0.0f, 0.0f, 0.0f);
+            FramebufferPixelSink sink(immediate);
+            
+            Polygon greenPolygon(greenSquare, true);
+            greenPolygon.rotate(angle, -50.0, 150.0);
+            greenPolygon.translate(variationX, 0.0);
+            greenPolygon.rasterize(sink);
+            
+            Polygon yellowPolygon(yellowSquare, true);
+            yellowPolygon.rotate(angle, 0, 225.0);
+            yellowPolygon.translate(variationX, 0.0);
+            yellowPolygon.scale(scaleVariation, scaleVariation, 50, 150);
+            yellowPolygon.rasterize(sink);
+            
+            Circumference circumference(center, 40 * scaleVariation);
+            circumference.translate(variationX, 0.0);
+            circumference.rasterize(sink);
+            
+            CG_CHECK(equal(recorded.getPixels(), recorded.getPixels() + 640 * 480 * 3, immediate.getPixels()));
+        }
+    });
+}
+
+static void registerSceneTests(TestSuite& suite) {
+    // The binary version of a scene renders the same image as the text one,
+    // colors included: they come from the vertices, for every kind of figure
+    suite.add("scene/binary-matches-text", []() {
+        istringstream text("size 64 48\n"
+                           "background 0 0 0\n"
+                           "color 0.2 0.4 1\n"
+                           "circle 32 24 10\n"
+                           "color 1 0.6 0\n"
+                           "polygon filled 2 2 12 2 12 12 2 12\n");
+        Scene scene = SceneFile::parse(text, "test");
+        
+        char path[] = "/tmp/cg-test-XXXXXX";
+        int descriptor = mkstemp(path);
+        CG_CHECK(descriptor >= 0);
+        close(descriptor);
+        BinarySceneFile::write(scene, path);
+        
+        ostringstream textImage;
+        ostringstream binaryImage;
+        {
+            PpmImageWriter textWriter(textImage);
+            BatchRenderer::renderScene(scene, textWriter);
+            MappedScene mapped(path);
+            PpmImageWriter binaryWriter(binaryImage);
+            BatchRenderer::renderScene(mapped, binaryWriter);
+        }
+        remove(path);
+        
+        CG_CHECK(textImage.str() == binaryImage.str());
+        
+        // The top of the circle, (32, 34), is on the row 48 - 1 - 34 of the image
+        string image = binaryImage.str();
+        size_t pixels = image.size() - 64 * 48 * 3;
+        size_t top = pixels + 3 * ((48 - 1 - 34) * 64 + 32);
+        CG_CHECK((unsigned char) image[top] == 51);
+        CG_CHECK((unsigned char) image[top + 1] == 102);
+        CG_CHECK((unsigned char) image[top + 2] == 255);
+    });
+}
+
+static void registerPipelineTests(TestSuite& suite) {
+    // More figures than the output queue holds, none of them received: the
+    // raster workers block on the full output, and stopping must not wait
+    // for them forever
+    suite.add("pipeline/stop-with-unreceived-output", []() {
+        vector<PipelineFigure> figures(3 * PIPELINE_QUEUE_CAPACITY);
+        for (PipelineFigure& figure : figures) {
+            figure.type = LINE;
+            figure.vertices.push_back(Vertex2d(10, 10));
+            figure.vertices.push_back(Vertex2d(20, 15));
+        }
+        
+        Pipeline pipeline(Vertex2d(0, 0), Vertex2d(640, 480), 2);
+        pipeline.start();
+        for (PipelineFigure& figure : figures) {
+            pipeline.submit(&figure);
+        }
+        // Give the figures time to fill the output queue
+        this_thread::sleep_for(chrono::milliseconds(50));
+        pipeline.stop();
+        CG_CHECK(pipeline.getFiguresInFlight() == 0);
+        
+        // A restarted pipeline only gives back the figures submitted after it
+        pipeline.start();
+        PipelineFigure figure;
+        figure.type = LINE;
+        figure.vertices.push_back(Vertex2d(30, 30));
+        figure.vertices.push_back(Vertex2d(40, 30));
+        pipeline.submit(&figure);
+        CG_CHECK(pipeline.receive() == &figure);
+        CG_CHECK(figure.points.size() == 11);
+        PipelineFigure *stale;
+        CG_CHECK(!pipeline.tryReceive(stale));
+    });
+    
+    // The destructor stops the pipeline the same way
+    suite.add("pipeline/destroy-with-unreceived-output", []() {
+        vector<PipelineFigure> figures(3 * PIPELINE_QUEUE_CAPACITY);
+        for (PipelineFigure& figure : figures) {
+            figure.type = LINE;
+            figure.vertices.push_back(Vertex2d(10, 10));
+            figure.vertices.push_back(Vertex2d(20, 15));
+        }
+        
+        {
+            Pipeline pipeline(Vertex2d(0, 0), Vertex2d(640, 480));
+            pipeline.start();
+            for (PipelineFigure& figure : figures) {
+                pipeline.submit(&figure);
+            }
+            this_thread::sleep_for(chrono::milliseconds(50));
+        }
+        // Reaching this line is the check: the destructor returned
+    });
+}
+
+/**
+ * Add every test to the suite
+ * @param suite {TestSuite&}
+ */
+void registerTestCases(TestSuite& suite) {
+    registerScanLineTests(suite);
+    registerCircumferenceTests(suite);
+    registerCommandBufferTests(suite);
+    registerSceneTests(suite);
+    registerPipelineTests(suite);
+}
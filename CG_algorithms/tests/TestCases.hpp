@@ -0,0 +1,15 @@
+/**
+ * TestCases.hpp
+ * The tests run by the test suite.
+ * @author Lucas Pinheiro (@lucaspin)
+ * @author Dalton Lima (@daltonbr)
+ */
+
+#ifndef TestCases_hpp
+#define TestCases_hpp
+
+#include "Test.hpp"
+
+void registerTestCases(TestSuite& suite);
+
+#endif /* TestCases_hpp */